@@ -228,7 +228,8 @@ template functionsMakefile(FunctionCode fnCode)
 match fnCode
 case FUNCTIONCODE(makefileParams=MAKEFILE_PARAMS(__)) then
   let libsStr = (makefileParams.libs ;separator=" ")
-  let ParModelicaExpLibs = if acceptParModelicaGrammar() then '-lParModelicaExpl -lOpenCL' // else ""
+  let ParModelicaExpLibs = parModelicaExpLibs()
+  let ParModelicaKernelsObj = if parModelicaNativeBackend() then ' <%name%>_kernels.o'
 
   <<
   # Makefile generated by OpenModelica
@@ -244,7 +245,7 @@ case FUNCTIONCODE(makefileParams=MAKEFILE_PARAMS(__)) then
   CFLAGS= $(DEBUG_FLAGS) <%makefileParams.cflags%>
   CPPFLAGS= -I"<%makefileParams.omhome%>/include/omc/c" <%makefileParams.includes ; separator=" "%><%
     if Flags.isSet(Flags.OMC_RELOCATABLE_FUNCTIONS) then " -DOMC_GENERATE_RELOCATABLE_CODE"
-  %>
+  %><%if parModelicaNativeBackend() then " -DOMC_OCL_NATIVE"%>
   LDFLAGS= -L"<%makefileParams.omhome%>/lib/<%getTriple()%>/omc" -Wl,-rpath,'<%makefileParams.omhome%>/lib/<%getTriple()%>/omc' <%ParModelicaExpLibs%> <%makefileParams.ldflags%> <%makefileParams.runtimelibs%>
   PERL=perl
   MAINFILE=<%name%>.c
@@ -253,10 +254,26 @@ case FUNCTIONCODE(makefileParams=MAKEFILE_PARAMS(__)) then
   <%name%>: $(MAINFILE) <%name%>.h <%name%>_records.c
   <%\t%> $(CC) $(CFLAGS) $(CPPFLAGS) -c -o <%name%>.o $(MAINFILE)
   <%\t%> $(CC) $(CFLAGS) $(CPPFLAGS) -c -o <%name%>_records.o <%name%>_records.c
-  <%\t%> $(LINK) -o <%name%>$(DLLEXT) <%name%>.o <%name%>_records.o <%libsStr%> $(CFLAGS) $(CPPFLAGS) $(LDFLAGS) -lm
+  <%if parModelicaNativeBackend() then '<%\t%> $(CXX) -x c++ $(CFLAGS) $(CPPFLAGS) -c -o <%name%>_kernels.o <%name%>_kernels.cl'%>
+  <%\t%> $(LINK) -o <%name%>$(DLLEXT) <%name%>.o <%name%>_records.o<%ParModelicaKernelsObj%> <%libsStr%> $(CFLAGS) $(CPPFLAGS) $(LDFLAGS) -lm
   >>
 end functionsMakefile;
 
+template parModelicaNativeBackend()
+ "Returns a non-empty text if the ParModelica kernels are compiled with the
+  model and run on the host CPU instead of OpenCL (--parmodelicaBackend=native)."
+::=
+  if acceptParModelicaGrammar() then
+    if stringEq(Flags.getConfigString(Flags.PARMODELICA_BACKEND), "native") then "native"
+end parModelicaNativeBackend;
+
+template parModelicaExpLibs()
+ "Returns the libraries of the explicit ParModelica runtime."
+::=
+  if acceptParModelicaGrammar() then
+    if parModelicaNativeBackend() then '-lParModelicaExplNative -lpthread' else '-lParModelicaExpl -lOpenCL'
+end parModelicaExpLibs;
+
 template commonHeader(String filePrefix)
 ::=
   <<
@@ -1150,6 +1167,7 @@ case KERNEL_FUNCTION(__) then
     /* Free GPU/OpenCL CPU memory */
     <%varFrees%>
   }
+  OCL_NATIVE_KERNEL(omc_<%fname%>)
 
   >>
 end functionBodyKernelFunction;
@@ -2886,10 +2904,7 @@ case STMT_PARFOR(range=rng as RANGE(__)) then
         <%argStr%>)
   {
     /* algStmtParForRangeBody : Thread managment for parfor loops */
-    modelica_integer inner_start = (get_global_id(0) * loop_step) + (loop_start);
-    modelica_integer stride = get_global_size(0) * loop_step;
-
-    for(modelica_integer <%iterName%> = (modelica_integer) inner_start; in_range_integer(<%iterName%>, loop_start, loop_end); <%iterName%> += stride)
+    OCL_PARFOR_RANGE_LOOP(<%iterName%>, loop_start, loop_step, loop_end)
     {
       /* algStmtParForRangeBody : Reconstruct Arrays */
       <%reconstrucedArrays%>
@@ -2900,6 +2915,7 @@ case STMT_PARFOR(range=rng as RANGE(__)) then
       <%body%>
     }
   }
+  OCL_NATIVE_KERNEL(<%parforKernelName%>)
   >>
 end algStmtParForRangeBody;
 
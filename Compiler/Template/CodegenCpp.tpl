@@ -232,9 +232,14 @@ case SIMCODE(modelInfo=MODELINFO(__)) then
      "sparsematrix_t"
     else "A matrix type is not supported"
     end match
+  let assemblyinclude = match type
+    case ("sparse") then
+     "#include <Core/Math/SparseAssembly.h>"
+    end match
 
   <<
   #pragma once
+  <%assemblyinclude%>
 
   /*****************************************************************************
   *
@@ -272,6 +277,7 @@ case SIMCODE(modelInfo=MODELINFO(__)) then
       <<
 
       <%matrixreturntype%> _<%name%>jacobian;
+      <%match type case ("sparse") then 'sparse_assembly _<%name%>jacobianAssembly;'%>
       ublas::vector<double> _<%name%>jac_y;
       ublas::vector<double> _<%name%>jac_tmp;
       ublas::vector<double> _<%name%>jac_x;
@@ -2240,6 +2246,15 @@ case SIMCODE(modelInfo=MODELINFO(__), makefileParams=MAKEFILE_PARAMS(__), simula
          #include <Core/Utils/extension/measure_time_statistic.hpp>
        #endif
        >>
+     case("all_trace") then
+       <<
+       #ifdef USE_SCOREP
+         #include <Core/Utils/extension/measure_time_scorep.hpp>
+       #else
+         #include <Core/Utils/extension/measure_time_rdtsc.hpp>
+       #endif
+       #include <Core/Utils/extension/measure_time_trace.hpp>
+       >>
      else
        <<
        #ifdef USE_SCOREP
@@ -2310,6 +2325,16 @@ case SIMCODE(modelInfo=MODELINFO(__), makefileParams=MAKEFILE_PARAMS(__), simula
              MeasureTimeStatistic::initialize();
            #endif
           >>
+          case("all_trace") then
+          <<
+           #ifdef USE_SCOREP
+             MeasureTimeScoreP::initialize();
+           #else
+             MeasureTimeRDTSC::initialize();
+           #endif
+           // the main thread and one buffer per worker thread
+           MeasureTimeTrace::initialize(<%intAdd(intMax(getConfigInt(NUM_PROC), 1), 1)%>);
+          >>
           else
            <<
            #ifdef USE_SCOREP
@@ -2371,6 +2396,12 @@ case SIMCODE(modelInfo=MODELINFO(__), makefileParams=MAKEFILE_PARAMS(__), simula
               <%generateMeasureTimeEndCode("measuredSimStartValues", "measuredSimEndValues", "(*measureTimeArraySimulation)[0]", "all", "")%>
               MeasureTime::getInstance()->writeToJson();
               MeasureTime::deinitialize();
+              <%if stringEq(getConfigString(PROFILING_LEVEL),"all_trace") then
+              <<
+              MeasureTimeTrace::writeToJson("<%lastIdentOfPath(modelInfo.name)%>_trace.json");
+              MeasureTimeTrace::deinitialize();
+              >>
+              %>
 
               delete measuredSimStartValues;
               delete measuredSimEndValues;
@@ -6698,9 +6729,17 @@ case SIMCODE(modelInfo = MODELINFO(__),simulationSettingsOpt = SOME(settings as
       <<
       <%generateMeasureTimeEndCode("measuredFunctionStartValues", "measuredFunctionEndValues", "(*measureTimeFunctionsArray)[2]",  "writeOutput", "MEASURETIME_MODELFUNCTIONS")%>
         write_data_t& container = _writeOutput->getFreeContainer();
-        all_vars_time_t all_vars = make_tuple(outputRealVars.outputVars,outputIntVars.outputVars,outputBoolVars.outputVars,_simTime);
-        neg_all_vars_t neg_all_vars =      make_tuple(outputRealVars.negateOutputVars,outputIntVars.negateOutputVars,outputBoolVars.negateOutputVars);
-       _writeOutput->addContainerToWriteQueue(make_tuple(all_vars,neg_all_vars));
+        all_vars_time_t& all_vars = get<0>(container);
+        //the output variables do not change, a container that was filled before only gets the new time
+        if (get<0>(all_vars).size() != outputRealVars.outputVars.size() || get<1>(all_vars).size() != outputIntVars.outputVars.size() || get<2>(all_vars).size() != outputBoolVars.outputVars.size())
+        {
+          get<0>(all_vars) = outputRealVars.outputVars;
+          get<1>(all_vars) = outputIntVars.outputVars;
+          get<2>(all_vars) = outputBoolVars.outputVars;
+          get<1>(container) = make_tuple(outputRealVars.negateOutputVars,outputIntVars.negateOutputVars,outputBoolVars.negateOutputVars);
+        }
+        get<3>(all_vars) = _simTime;
+       _writeOutput->addContainerToWriteQueue(container);
       >>
     %>
     }
@@ -6823,6 +6862,15 @@ case SIMCODE(modelInfo=MODELINFO(__), extObjInfo=EXTOBJINFO(__)) then
          #include <Core/Utils/extension/measure_time_statistic.hpp>
        #endif
        >>
+     case("all_trace") then
+       <<
+       #ifdef USE_SCOREP
+         #include <Core/Utils/extension/measure_time_scorep.hpp>
+       #else
+         #include <Core/Utils/extension/measure_time_rdtsc.hpp>
+       #endif
+       #include <Core/Utils/extension/measure_time_trace.hpp>
+       >>
      else
        <<
        #ifdef USE_SCOREP
@@ -6911,6 +6959,10 @@ match modelInfo
   <<
   #define MEASURETIME_MODELFUNCTIONS
   >>%>
+  <%if stringEq(getConfigString(PROFILING_LEVEL),"all_trace") then
+  <<
+  #define MEASURETIME_TRACE
+  >>%>
 
   class <%lastIdentOfPath(modelInfo.name)%>: public IContinuous, public IEvent, public IStepEvent, public ITime, public ISystemProperties <%if Flags.isSet(Flags.WRITE_TO_BUFFER) then ', public IReduceDAE'%>, public SystemDefaultImplementation
   {
@@ -13057,9 +13109,16 @@ case _ then
   let jacvals = if stringEq(eqsCount, "0") then '' else
     (sparsepattern |> (index,indexes) hasindex index0 =>
       let jaccol = ( indexes |> i_index hasindex index1 =>
-        (match indexColumn case "1" then '_<%matrixName%>jacobian(0,<%index%>) = _<%matrixName%>jac_y(0);/*test1<%index0%>,<%index1%>*/'
-           else '_<%matrixName%>jacobian(<%i_index%>,<%index%>) = _<%matrixName%>jac_y(<%i_index%>);/*test2<%index0%>,<%index1%>*/'
-           )
+        (match type
+         case ("sparse") then
+           (match indexColumn case "1" then '_<%matrixName%>jacobianAssembly(0,<%index%>,_<%matrixName%>jac_y(0));/*test1<%index0%>,<%index1%>*/'
+              else '_<%matrixName%>jacobianAssembly(<%i_index%>,<%index%>,_<%matrixName%>jac_y(<%i_index%>));/*test2<%index0%>,<%index1%>*/'
+              )
+         else
+           (match indexColumn case "1" then '_<%matrixName%>jacobian(0,<%index%>) = _<%matrixName%>jac_y(0);/*test1<%index0%>,<%index1%>*/'
+              else '_<%matrixName%>jacobian(<%i_index%>,<%index%>) = _<%matrixName%>jac_y(<%i_index%>);/*test2<%index0%>,<%index1%>*/'
+              )
+         )
         ;separator="\n")
     <<
     _<%matrixName%>jac_x(<%index0%>) = 1;
@@ -13068,13 +13127,17 @@ case _ then
     <%jaccol%>
     >>
     ;separator="\n")
+  let assemblybegin = match type case ("sparse") then '_<%matrixName%>jacobianAssembly.begin(_<%matrixName%>jacobian);'
+  let assemblyend = match type case ("sparse") then '_<%matrixName%>jacobianAssembly.end();'
   <<
   <%jacMats%>
 
   <%matrixreturntype%>&  <%classname%>Jacobian::get<%matrixName%>Jacobian()
   {
     /*Index <%indexJacobian%>*/
+    <%assemblybegin%>
     <%jacvals%>
+    <%assemblyend%>
     return _<%matrixName%>jacobian;
   }
   >>
@@ -150,6 +150,10 @@ template additionalHpcomIncludesForParallelCode(SimCode simCode, Text& extraFunc
       <<
       #include <mpi.h>
       >>
+    case ("adaptive") then
+      <<
+      #include <Core/Utils/extension/adaptive_scheduler.hpp>
+      >>
     else
       <<
       #include <boost/thread/mutex.hpp>
@@ -294,7 +298,8 @@ template generateAdditionalFunctionHeaders(Option<tuple<Schedule,Schedule,Schedu
         case ("openmp") then
           <<
           >>
-        case ("tbb") then
+        case ("tbb")
+        case ("adaptive") then
           let voidfuncsOde = odeSchedule.tasks |> task => (
               match task
                 case ((task as CALCTASK(__),parents)) then
@@ -406,6 +411,13 @@ template generateAdditionalHpcomVarHeaders(Option<tuple<Schedule,Schedule,Schedu
           TbbArenaFunctor _tbbArenaFunctorZeroFunc;
           #endif
           >>
+        case ("adaptive") then
+          <<
+          AdaptiveScheduler* _adaptiveScheduler;
+          AdaptiveTaskGraph* _adaptiveGraphOde;
+          AdaptiveTaskGraph* _adaptiveGraphAll;
+          AdaptiveTaskGraph* _adaptiveGraphZeroFunc;
+          >>
         else ""
       end match
     else ""
@@ -561,6 +573,13 @@ template additionalHpcomConstructorBodyStatements(Option<tuple<Schedule,Schedule
           <<
           <%tbbVars%>
           >>
+        case ("adaptive") then
+          <<
+          _adaptiveScheduler = new AdaptiveScheduler(<%getConfigInt(NUM_PROC)%>);
+          <%generateAdaptiveConstructorExtension(odeSchedule.tasks, "Ode", modelNamePrefixStr)%>
+          <%generateAdaptiveConstructorExtension(daeSchedule.tasks, "All", modelNamePrefixStr)%>
+          <%generateAdaptiveConstructorExtension(zeroFuncSchedule.tasks, "ZeroFunc", modelNamePrefixStr)%>
+          >>
         else ""
     else ""
   end match
@@ -736,6 +755,13 @@ template additionalHpcomDestructorBodyStatements(Option<tuple<Schedule,Schedule,
           for(std::vector<tbb::flow::continue_node<tbb::flow::continue_msg>* >::iterator it = _tbbNodeListZeroFunc.begin(); it != _tbbNodeListZeroFunc.end(); it++)
             delete *it;
           >>
+        case ("adaptive") then
+          <<
+          delete _adaptiveScheduler;
+          delete _adaptiveGraphOde;
+          delete _adaptiveGraphAll;
+          delete _adaptiveGraphZeroFunc;
+          >>
         else ""
     else ""
   end match
@@ -1180,6 +1206,24 @@ template generateParallelEvaluate(list<SimEqSystem> allEquationsPlusWhen, Absyn.
             }
           }
           >>
+        case ("adaptive") then
+          let taskFuncs = function_HPCOM_TaskDep_voidfunc(odeSchedule.tasks, daeSchedule.tasks, zeroFuncSchedule.tasks, allEquationsPlusWhen,type, name, &varDecls, simCode, extraFuncs, extraFuncsDecl, extraFuncsNamespace, useFlatArrayNotation); separator="\n"
+          <<
+          //task functions, scheduled at runtime
+          <%taskFuncs%>
+
+          <%functionHead%>
+          {
+            this->_evaluateMode = evaluateMode;
+            this->_command = command;
+            if(evaluateMode == 0)
+              _adaptiveScheduler->evaluate(*_adaptiveGraphOde);
+            else if(evaluateMode < 0)
+              _adaptiveScheduler->evaluate(*_adaptiveGraphAll);
+            else
+              _adaptiveScheduler->evaluate(*_adaptiveGraphZeroFunc);
+          }
+          >>
         else ""
       end match
     else ""
@@ -1456,6 +1500,29 @@ template generateTbbConstructorExtensionEdges(tuple<Task,list<Integer>> taskIn,
   end match
 end generateTbbConstructorExtensionEdges;
 
+template generateAdaptiveConstructorExtension(list<tuple<Task,list<Integer>>> tasks, String funcSuffix, String modelNamePrefixStr)
+"The task graph for the runtime scheduler. Task and parent indices of the task dependency schedule are node indices starting at 1."
+::=
+  let taskDefs = tasks |> t => generateAdaptiveConstructorExtensionTask(t, funcSuffix, modelNamePrefixStr); separator="\n"
+  <<
+  _adaptiveGraph<%funcSuffix%> = new AdaptiveTaskGraph("<%funcSuffix%>", <%listLength(tasks)%>, <%getConfigInt(NUM_PROC)%>);
+  <%taskDefs%>
+  _adaptiveGraph<%funcSuffix%>->initialize();
+  >>
+end generateAdaptiveConstructorExtension;
+
+template generateAdaptiveConstructorExtensionTask(tuple<Task,list<Integer>> taskIn, String funcSuffix, String modelNamePrefixStr)
+::=
+  match taskIn
+    case ((task as CALCTASK(__),parents)) then
+      let parentEdges = parents |> p => '_adaptiveGraph<%funcSuffix%>->addDependency(<%intSub(p,1)%>, <%intSub(task.index,1)%>);'; separator = "\n"
+      <<
+      _adaptiveGraph<%funcSuffix%>->setTask(<%intSub(task.index,1)%>, bind<void>(&<%modelNamePrefixStr%>::taskFunc<%funcSuffix%>_<%task.index%>, this), <%task.calcTime%>);
+      <%parentEdges%>
+      >>
+  end match
+end generateAdaptiveConstructorExtensionTask;
+
 template function_HPCOM_TaskDep_voidfunc(list<tuple<Task,list<Integer>>> odeTasks, list<tuple<Task,list<Integer>>> daeTasks, list<tuple<Task,list<Integer>>> zeroFuncTasks, list<SimEqSystem> allEquationsPlusWhen,
                                          String iType, Absyn.Path name, Text &varDecls, SimCode simCode, Text& extraFuncs, Text& extraFuncsDecl, Text extraFuncsNamespace, Boolean useFlatArrayNotation)
 ::=
@@ -1717,6 +1784,17 @@ template taskCode(list<SimEqSystem> allEquationsPlusWhen, Task iTask, String iTy
     case (task as CALCTASK(__)) then
       let odeEqs = task.eqIdc |> eq => equationNamesHPCOM_(eq,allEquationsPlusWhen,contextSimulationNonDiscrete,&varDecls, simCode, extraFuncs, extraFuncsDecl, extraFuncsNamespace, useFlatArrayNotation); separator="\n"
       let &varDeclsLocal = buffer "" /*BUFL*/
+      if stringEq(getConfigString(PROFILING_LEVEL),"all_trace") then
+      <<
+      // Task <%task.index%>
+      {
+        MEASURETIME_TRACE_START(traceStart);
+        <%odeEqs%>
+        MEASURETIME_TRACE_END(traceStart, "Task <%task.index%>", <%task.index%>);
+      }
+      // End Task <%task.index%>
+      >>
+      else
       <<
       // Task <%task.index%>
       <%odeEqs%>
@@ -1726,12 +1804,32 @@ template taskCode(list<SimEqSystem> allEquationsPlusWhen, Task iTask, String iTy
       let odeEqs = task.eqIdc |> eq => equationNamesHPCOM_(eq,allEquationsPlusWhen,contextSimulationNonDiscrete,&varDecls, simCode, extraFuncs, extraFuncsDecl, extraFuncsNamespace, useFlatArrayNotation); separator="\n"
       let taskStr = task.nodeIdc |> task => '<%task%>';separator=","
       let &varDeclsLocal = buffer "" /*BUFL*/
+      if stringEq(getConfigString(PROFILING_LEVEL),"all_trace") then
+      <<
+      // Tasks <%taskStr%>
+      {
+        MEASURETIME_TRACE_START(traceStart);
+        <%odeEqs%>
+        MEASURETIME_TRACE_END(traceStart, "Tasks <%taskStr%>", -1);
+      }
+      >>
+      else
       <<
       // Tasks <%taskStr%>
       <%odeEqs%>
       >>
     case(task as DEPTASK(outgoing=false)) then
       let assLck = assignLockByDepTask(task, lockPrefix, iType); separator="\n"
+      if stringEq(getConfigString(PROFILING_LEVEL),"all_trace") then
+      let sourceIdx = match task.sourceTask case CALCTASK(__) then index else "-1"
+      <<
+      {
+        MEASURETIME_TRACE_START(traceStart);
+        <%assLck%>
+        MEASURETIME_TRACE_END(traceStart, "Wait for task <%sourceIdx%>", <%sourceIdx%>);
+      }
+      >>
+      else
       <<
       <%assLck%>
       >>
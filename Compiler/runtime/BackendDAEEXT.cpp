@@ -46,6 +46,7 @@
 #include <set>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <cassert>
 
 
@@ -348,4 +349,110 @@ void BackendDAEExtImpl__matching(int nvars, int neqns, int matchingID, int cheap
   }
 }
 
+void BackendDAEExtImpl__setMatchingThreads(int numThreads)
+{
+  match_ppf_set_num_threads(numThreads);
+}
+
+/* writes the incidence matrix set with setIncidenceMatrix in Matrix Market format,
+ * the rows are the variables and the columns the equations */
+int BackendDAEExtImpl__writeIncidenceMatrix(int nvars, int neqns, const char *fileName)
+{
+  if (col_ptrs == NULL || col_ids == NULL) {
+    return 0;
+  }
+  std::ofstream os(fileName);
+  if (!os) {
+    return 0;
+  }
+  os << "%%MatrixMarket matrix coordinate pattern general\n";
+  os << nvars << " " << neqns << " " << col_ptrs[neqns] << "\n";
+  for (int i = 0; i < neqns; i++) {
+    for (int j = col_ptrs[i]; j < col_ptrs[i+1]; j++) {
+      os << col_ids[j]+1 << " " << i+1 << "\n";
+    }
+  }
+  return 1;
+}
+
+/* Iterative Tarjan algorithm on the graph given in CSR format (0-based). The
+ * searches are started from the given roots in their order, the successors are
+ * visited in their order in adjncy. This gives the same result as the recursive
+ * implementation in Sorting.mo.
+ * Returns the components as list<list<Integer>> with 1-based indices, each
+ * component in the order its vertices are popped from the stack. The component
+ * that is found last comes first, unless firstFoundFirst is set. */
+void* BackendDAEExtImpl__tarjan(int nvertices, const int* xadj, const int* adjncy, const int* roots, int nroots, int firstFoundFirst)
+{
+  std::vector<int> number(nvertices, -1);
+  std::vector<int> lowlink(nvertices, 0);
+  std::vector<char> onStack(nvertices, 0);
+  std::vector<int> stack;      /* the stack of the Tarjan algorithm */
+  std::vector<int> callStack;  /* replaces the recursion: vertex and position of the next successor */
+  std::vector<int> callPos;
+  std::vector<int> compVertices; /* all components in the order they are found */
+  std::vector<int> compStart;
+  int index = 0;
+
+  for (int r = 0; r < nroots; r++) {
+    if (number[roots[r]] != -1)
+      continue;
+    callStack.push_back(roots[r]);
+    callPos.push_back(xadj[roots[r]]);
+    number[roots[r]] = lowlink[roots[r]] = index++;
+    onStack[roots[r]] = 1;
+    stack.push_back(roots[r]);
+
+    while (!callStack.empty()) {
+      int v = callStack.back();
+      int pos = callPos.back();
+      if (pos < xadj[v+1]) {
+        int w = adjncy[pos];
+        callPos.back() = pos + 1;
+        if (number[w] == -1) {
+          /* w has not yet been visited, descend */
+          number[w] = lowlink[w] = index++;
+          onStack[w] = 1;
+          stack.push_back(w);
+          callStack.push_back(w);
+          callPos.push_back(xadj[w]);
+        } else if (onStack[w]) {
+          lowlink[v] = std::min(lowlink[v], number[w]);
+        }
+        continue;
+      }
+
+      /* all successors of v are done, v is a root if its lowlink equals its number */
+      if (lowlink[v] == number[v]) {
+        int w;
+        compStart.push_back(compVertices.size());
+        do {
+          w = stack.back();
+          stack.pop_back();
+          onStack[w] = 0;
+          compVertices.push_back(w);
+        } while (w != v);
+      }
+      callStack.pop_back();
+      callPos.pop_back();
+      if (!callStack.empty()) {
+        int parent = callStack.back();
+        lowlink[parent] = std::min(lowlink[parent], lowlink[v]);
+      }
+    }
+  }
+
+  compStart.push_back(compVertices.size());
+  void *res = mmc_mk_nil();
+  int ncomps = compStart.size() - 1;
+  for (int k = 0; k < ncomps; k++) {
+    int c = firstFoundFirst ? ncomps - 1 - k : k;
+    void *comp = mmc_mk_nil();
+    for (int i = compStart[c+1] - 1; i >= compStart[c]; i--)
+      comp = mmc_mk_cons(mmc_mk_icon(compVertices[i]+1), comp);
+    res = mmc_mk_cons(comp, res);
+  }
+  return res;
+}
+
 }
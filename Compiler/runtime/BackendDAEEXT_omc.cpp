@@ -140,6 +140,98 @@ extern void BackendDAEEXT_matching(modelica_integer nv, modelica_integer ne, mod
   BackendDAEExtImpl__matching(nv, ne, matchingID, cheapID, relabel_period, clear_match);
 }
 
+extern void BackendDAEEXT_setMatchingThreads(modelica_integer numThreads)
+{
+  BackendDAEExtImpl__setMatchingThreads(numThreads);
+}
+
+extern void BackendDAEEXT_writeIncidenceMatrix(modelica_integer nv, modelica_integer ne, const char *fileName)
+{
+  if (!BackendDAEExtImpl__writeIncidenceMatrix(nv, ne, fileName)) {
+    const char *tokens[1] = {fileName};
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_error,"BackendDAEEXT.writeIncidenceMatrix failed to write %s",tokens,1);
+    MMC_THROW();
+  }
+}
+
+/* Builds the equation graph of Sorting.Tarjan/TarjanTransposed in CSR format and
+ * returns the strongly connected components. With transposed=0 inc is the
+ * incidence matrix m and ass is ass1 (eqn := ass1[var]), the successors of eqn
+ * are the equations ass1[var] of the variables var in m[eqn]. With transposed=1
+ * inc is mT and ass is ass2 (var := ass2[eqn]), the successors of eqn are the
+ * equations in mT[ass2[eqn]]. */
+static void BackendDAEEXT_tarjanIndexError(int index, int len, const char *what)
+{
+  char indexstr[16], lenstr[16];
+  const char *tokens[3] = {lenstr, what, indexstr};
+  snprintf(indexstr, 16, "%d", index);
+  snprintf(lenstr, 16, "%d", len);
+  c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjan failed because index %s is out of bounds, the %s has length %s",tokens,3);
+  MMC_THROW();
+}
+
+static void* BackendDAEEXT_tarjanImpl(modelica_metatype inc, modelica_metatype ass, int transposed)
+{
+  int nass = MMC_HDRSLOTS(MMC_GETHDR(ass));
+  int ninc = MMC_HDRSLOTS(MMC_GETHDR(inc));
+  std::vector<int> assv(nass), xadj(1, 0), adjncy, roots;
+  int i;
+
+  for (i = 0; i < nass; i++) {
+    assv[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass)[i]);
+  }
+  for (i = 0; i < nass; i++) {
+    int row = transposed ? assv[i] : i+1;
+    if (transposed && row > ninc) {
+      BackendDAEEXT_tarjanIndexError(row, ninc, "incidence matrix");
+    }
+    if (row > 0 && row <= ninc) {
+      modelica_metatype ie;
+      for (ie = MMC_STRUCTDATA(inc)[row-1]; MMC_GETHDR(ie) == MMC_CONSHDR; ie = MMC_CDR(ie)) {
+        int k = MMC_UNTAGFIXNUM(MMC_CAR(ie));
+        int eqn;
+        if (k <= 0) {
+          continue;
+        }
+        if (transposed) {
+          eqn = k;
+        } else if (k <= nass) {
+          eqn = assv[k-1];
+        } else {
+          eqn = nass+1;
+        }
+        if (eqn > 0 && eqn != i+1) {
+          if (eqn > nass) {
+            BackendDAEEXT_tarjanIndexError(transposed ? eqn : k, nass, "matching");
+          }
+          adjncy.push_back(eqn-1);
+        }
+      }
+    }
+    xadj.push_back(adjncy.size());
+  }
+
+  /* the searches are started in the same order as in Sorting.mo */
+  for (i = 0; i < nass; i++) {
+    if (transposed) {
+      if (assv[i] > 0) roots.push_back(i);
+    } else if (assv[i] > 0 && assv[i] <= nass) {
+      roots.push_back(assv[i]-1);
+    }
+  }
+  return BackendDAEExtImpl__tarjan(nass, &xadj[0], adjncy.empty() ? NULL : &adjncy[0], roots.empty() ? NULL : &roots[0], roots.size(), !transposed);
+}
+
+extern void* BackendDAEEXT_tarjan(modelica_metatype m, modelica_metatype ass1)
+{
+  return BackendDAEEXT_tarjanImpl(m, ass1, 0);
+}
+
+extern void* BackendDAEEXT_tarjanTransposed(modelica_metatype mT, modelica_metatype ass2)
+{
+  return BackendDAEEXT_tarjanImpl(mT, ass2, 1);
+}
+
 extern void BackendDAEEXT_getAssignment(modelica_metatype ass1, modelica_metatype ass2)
 {
   int i=0;
@@ -1,6 +1,9 @@
 #include "TaskGraphResultsCmp.h"
 #include "omc_config.h"
 #include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
 
 #if USE_PATOH
 #include "patoh.h"
@@ -118,3 +121,236 @@ void* HpcOmSchedulerExtImpl__scheduleMetis(int* vwgts, int* eptr, int* eint, int
     return mmc_mk_nil();
 }
 #endif
+
+/*
+ * Native list scheduler for large task graphs.
+ *
+ * The graph is given in CSR format with 0-based successor indices, the costs of
+ * the tasks and the communication costs of the edges. Chains (a task with a
+ * single child that has no other parent) are merged first, because they can
+ * never run in parallel. Afterwards the coarse graph is scheduled with a
+ * critical path list scheduler: the ready task with the highest bottom level
+ * (including communication costs) is assigned to the thread on which it can
+ * start first. Communication costs are only paid between different threads.
+ * The runtime is O((V+E) log V + V*P).
+ *
+ * The result contains the thread (1-based) of every task, followed by all
+ * tasks (1-based) in a topological order that matches the schedule.
+ */
+void* HpcOmSchedulerExtImpl__scheduleListNative(int nTasks, const int* xadj, const int* adjncy, const double* vwgt, const double* adjwgt, int nThreads, int coarsen)
+{
+  void *res = mmc_mk_nil();
+  if (nTasks <= 0)
+    return res;
+  if (nThreads < 1)
+    nThreads = 1;
+
+  // number of parents of each task and the parent of tasks with a single parent
+  std::vector<int> numParents(nTasks, 0);
+  std::vector<int> singleParent(nTasks, -1);
+  for (int i = 0; i < nTasks; i++)
+  {
+    for (int e = xadj[i]; e < xadj[i+1]; e++)
+    {
+      numParents[adjncy[e]]++;
+      singleParent[adjncy[e]] = i;
+    }
+  }
+
+  // merge chains, cluster[i] is the cluster of task i, next[i] the following task of the chain
+  std::vector<int> cluster(nTasks, -1);
+  std::vector<int> next(nTasks, -1);
+  std::vector<int> clusterHead;
+  for (int i = 0; i < nTasks; i++)
+  {
+    // a task continues the chain of its parent, if it is the only child of its only parent
+    if (coarsen && numParents[i] == 1 && xadj[singleParent[i]+1] - xadj[singleParent[i]] == 1)
+      continue;
+    int c = (int)clusterHead.size();
+    clusterHead.push_back(i);
+    for (int task = i; ; )
+    {
+      cluster[task] = c;
+      if (!coarsen || xadj[task+1] - xadj[task] != 1)
+        break;
+      int child = adjncy[xadj[task]];
+      if (numParents[child] != 1)
+        break;
+      next[task] = child;
+      task = child;
+    }
+  }
+  // only tasks on a cycle are left, they are detected below
+  for (int i = 0; i < nTasks; i++)
+  {
+    if (cluster[i] == -1)
+    {
+      cluster[i] = (int)clusterHead.size();
+      clusterHead.push_back(i);
+    }
+  }
+  int nClusters = (int)clusterHead.size();
+
+  // coarse graph, parallel edges are merged and keep the highest communication cost
+  std::vector<double> cost(nClusters, 0.0);
+  std::vector<int> cXadj(nClusters+1, 0);
+  std::vector<int> cAdjncy;
+  std::vector<double> cAdjwgt;
+  std::vector<int> edgeMarker(nClusters, -1);
+  std::vector<int> edgePos(nClusters, 0);
+  cAdjncy.reserve(xadj[nTasks]);
+  cAdjwgt.reserve(xadj[nTasks]);
+  for (int c = 0; c < nClusters; c++)
+  {
+    for (int task = clusterHead[c]; task != -1; task = next[task])
+    {
+      cost[c] += vwgt[task] > 0.0 ? vwgt[task] : 0.0;
+      for (int e = xadj[task]; e < xadj[task+1]; e++)
+      {
+        int child = cluster[adjncy[e]];
+        if (child == c)
+          continue;
+        double comm = adjwgt[e] > 0.0 ? adjwgt[e] : 0.0;
+        if (edgeMarker[child] != c)
+        {
+          edgeMarker[child] = c;
+          edgePos[child] = (int)cAdjncy.size();
+          cAdjncy.push_back(child);
+          cAdjwgt.push_back(comm);
+        }
+        else if (cAdjwgt[edgePos[child]] < comm)
+          cAdjwgt[edgePos[child]] = comm;
+      }
+    }
+    cXadj[c+1] = (int)cAdjncy.size();
+  }
+
+  // parents of the coarse graph (transposed CSR)
+  std::vector<int> pXadj(nClusters+1, 0);
+  std::vector<int> pAdjncy(cAdjncy.size());
+  std::vector<double> pAdjwgt(cAdjncy.size());
+  for (size_t e = 0; e < cAdjncy.size(); e++)
+    pXadj[cAdjncy[e]+1]++;
+  for (int c = 0; c < nClusters; c++)
+    pXadj[c+1] += pXadj[c];
+  std::vector<int> fill(pXadj.begin(), pXadj.end() - 1);
+  for (int c = 0; c < nClusters; c++)
+  {
+    for (int e = cXadj[c]; e < cXadj[c+1]; e++)
+    {
+      int pos = fill[cAdjncy[e]]++;
+      pAdjncy[pos] = c;
+      pAdjwgt[pos] = cAdjwgt[e];
+    }
+  }
+
+  // bottom levels in reverse topological order
+  std::vector<double> bottomLevel(nClusters, 0.0);
+  std::vector<int> openCount(nClusters);
+  std::vector<int> stack;
+  for (int c = 0; c < nClusters; c++)
+  {
+    openCount[c] = cXadj[c+1] - cXadj[c];
+    if (openCount[c] == 0)
+      stack.push_back(c);
+  }
+  int numVisited = 0;
+  while (!stack.empty())
+  {
+    int c = stack.back();
+    stack.pop_back();
+    numVisited++;
+    double maxChild = 0.0;
+    for (int e = cXadj[c]; e < cXadj[c+1]; e++)
+      maxChild = std::max(maxChild, cAdjwgt[e] + bottomLevel[cAdjncy[e]]);
+    bottomLevel[c] = cost[c] + maxChild;
+    for (int e = pXadj[c]; e < pXadj[c+1]; e++)
+      if (--openCount[pAdjncy[e]] == 0)
+        stack.push_back(pAdjncy[e]);
+  }
+  if (numVisited != nClusters)
+  {
+    std::cerr << "HpcOmSchedulerExt.scheduleListNative: The task graph contains a cycle." << std::endl;
+    return res;
+  }
+
+  // list scheduling, ties are broken by the smaller index to keep the result deterministic
+  std::priority_queue<std::pair<double,int> > ready;
+  for (int c = 0; c < nClusters; c++)
+  {
+    openCount[c] = pXadj[c+1] - pXadj[c];
+    if (openCount[c] == 0)
+      ready.push(std::make_pair(bottomLevel[c], -c));
+  }
+  std::vector<double> threadReady(nThreads, 0.0);
+  std::vector<double> finishTime(nClusters, 0.0);
+  std::vector<int> threadOfCluster(nClusters, 0);
+  std::vector<double> localReady(nThreads, 0.0);
+  std::vector<int> touched;
+  std::vector<int> order;
+  order.reserve(nClusters);
+  while (!ready.empty())
+  {
+    int c = -ready.top().second;
+    ready.pop();
+    order.push_back(c);
+
+    // data of parents on other threads is ready at finish + comm, on the same thread at finish
+    double max1 = 0.0, max2 = 0.0;
+    int max1Thread = -1;
+    for (int e = pXadj[c]; e < pXadj[c+1]; e++)
+    {
+      int parent = pAdjncy[e];
+      int t = threadOfCluster[parent];
+      double remote = finishTime[parent] + pAdjwgt[e];
+      if (remote > max1)
+      {
+        if (t != max1Thread)
+          max2 = max1;
+        max1 = remote;
+        max1Thread = t;
+      }
+      else if (t != max1Thread && remote > max2)
+        max2 = remote;
+      if (localReady[t] == 0.0)
+        touched.push_back(t);
+      localReady[t] = std::max(localReady[t], finishTime[parent]);
+    }
+
+    int bestThread = 0;
+    double bestStart = 0.0;
+    for (int t = 0; t < nThreads; t++)
+    {
+      double start = std::max(threadReady[t], std::max(localReady[t], t == max1Thread ? max2 : max1));
+      if (t == 0 || start < bestStart)
+      {
+        bestStart = start;
+        bestThread = t;
+      }
+    }
+    for (size_t i = 0; i < touched.size(); i++)
+      localReady[touched[i]] = 0.0;
+    touched.clear();
+
+    threadOfCluster[c] = bestThread;
+    finishTime[c] = bestStart + cost[c];
+    threadReady[bestThread] = finishTime[c];
+
+    for (int e = cXadj[c]; e < cXadj[c+1]; e++)
+      if (--openCount[cAdjncy[e]] == 0)
+        ready.push(std::make_pair(bottomLevel[cAdjncy[e]], -cAdjncy[e]));
+  }
+
+  // order of the tasks (built in reverse), followed by the thread assignment
+  for (int i = nClusters-1; i >= 0; i--)
+  {
+    std::vector<int> chain;
+    for (int task = clusterHead[order[i]]; task != -1; task = next[task])
+      chain.push_back(task);
+    for (int j = (int)chain.size()-1; j >= 0; j--)
+      res = mmc_mk_cons(mmc_mk_icon(chain[j]+1), res);
+  }
+  for (int i = nTasks-1; i >= 0; i--)
+    res = mmc_mk_cons(mmc_mk_icon(threadOfCluster[cluster[i]]+1), res);
+  return res;
+}
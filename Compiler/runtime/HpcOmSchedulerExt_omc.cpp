@@ -107,4 +107,34 @@ extern void* HpcOmSchedulerExt_schedulehMetis(modelica_metatype xadjIn, modelica
 #endif
 }
 
+extern void* HpcOmSchedulerExt_scheduleListNative(modelica_metatype xadjIn, modelica_metatype adjncyIn, modelica_metatype vwgtIn, modelica_metatype adjwgtIn, int nThreads, int coarsen)
+{
+#if defined(_MSC_VER)
+  HPC_OM_VS();
+#else
+  int nTasks = (int)MMC_HDRSLOTS(MMC_GETHDR(vwgtIn));
+  int nEdges = (int)MMC_HDRSLOTS(MMC_GETHDR(adjncyIn));
+  if (nTasks == 0)
+    return mmc_mk_nil();
+  std::vector<int> xadj(nTasks+1);
+  std::vector<int> adjncy(nEdges);
+  std::vector<double> vwgt(nTasks);
+  std::vector<double> adjwgt(nEdges);
+
+  if ((int)MMC_HDRSLOTS(MMC_GETHDR(xadjIn)) != nTasks+1 || (int)MMC_HDRSLOTS(MMC_GETHDR(adjwgtIn)) != nEdges)
+    MMC_THROW();
+  //xadj and adjncy are 0-based, like the metis CSR-format
+  for(int i=0; i<=nTasks; i++)
+    xadj[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(xadjIn)[i]);
+  for(int i=0; i<nEdges; i++) {
+    adjncy[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(adjncyIn)[i]);
+    adjwgt[i] = mmc_prim_get_real(MMC_STRUCTDATA(adjwgtIn)[i]);
+  }
+  for(int i=0; i<nTasks; i++)
+    vwgt[i] = mmc_prim_get_real(MMC_STRUCTDATA(vwgtIn)[i]);
+
+  return HpcOmSchedulerExtImpl__scheduleListNative(nTasks, &xadj[0], nEdges ? &adjncy[0] : NULL, &vwgt[0], nEdges ? &adjwgt[0] : NULL, nThreads, coarsen);
+#endif
+}
+
 }
@@ -124,6 +124,12 @@ extern void Print_writeBuf(threadData_t *threadData,const char* filename)
     MMC_THROW();
 }
 
+extern void Print_streamBufToFile(threadData_t *threadData,const char* filename)
+{
+  if (PrintImpl__streamBufToFile(threadData,filename))
+    MMC_THROW();
+}
+
 extern void Print_writeBufConvertLines(threadData_t *threadData,const char* filename)
 {
   if (PrintImpl__writeBufConvertLines(threadData,filename))
@@ -2,6 +2,7 @@
 #include "write_matlab4.h"
 #include <stdint.h>
 #include <string.h>
+#include <limits.h>
 #include "errorext.h"
 #include "systemimpl.h"
 #include "ptolemyio.h"
@@ -44,6 +45,10 @@ static SimulationResult_Globals simresglob = {
   0
 };
 
+/* The result file stays open between calls of val(); this bounds the memory
+ * used by the variables decoded from it */
+#define MAX_CACHED_RESULT_BYTES (256*1024*1024)
+
 static void SimulationResultsImpl__close(SimulationResult_Globals* simresglob)
 {
   switch (simresglob->curFormat) {
@@ -94,6 +99,10 @@ static PlotFormat SimulationResultsImpl__openFile(const char *filename, Simulati
       c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to open simulation result %s: %s"), msg, 2);
       return UNKNOWN_PLOT;
     }
+    if (simresglob->matReader.nrows) {
+      size_t maxVars = MAX_CACHED_RESULT_BYTES / (simresglob->matReader.nrows*sizeof(double));
+      omc_matlab4_set_cache_size(&simresglob->matReader, maxVars < 2 ? 2 : maxVars > INT_MAX ? INT_MAX : (int) maxVars);
+    }
     break;
   case PLT:
     simresglob->pltReader = fopen(filename, "r");
@@ -438,6 +447,7 @@ int SimulationResults_filterSimulationResults(const char *inFile, const char *ou
     double start = omc_matlab4_startTime(&simresglob.matReader);
     double stop = omc_matlab4_stopTime(&simresglob.matReader);
     double start_stop[2] = {start, stop};
+    double *times = NULL;
     parameter_indexes[0] = 1; /* time */
     omc_matlab4_read_all_vals(&simresglob.matReader);
     if (endsWith(outFile,".csv")) {
@@ -634,27 +644,31 @@ int SimulationResults_filterSimulationResults(const char *inFile, const char *ou
     if (writeMatVer4MatrixHeader(fout, "data_2", numberOfIntervals ? numberOfIntervals+1 : simresglob.matReader.nrows, numUnique, sizeof(double))) {
       return failedToWriteToFile(outFile);
     }
+    if (numberOfIntervals) {
+      times = omc_alloc_interface.malloc_atomic(sizeof(double)*(numberOfIntervals+1));
+      for (j=0; j<=numberOfIntervals; j++) {
+        times[j] = j==numberOfIntervals ? stop : start + (stop-start)*((double)j)/numberOfIntervals;
+      }
+    }
     for (i=0; i<numUnique; i++) {
       double *vals = NULL;
       int nrows;
       if (numberOfIntervals) {
+        ModelicaMatVariable_t var = {0};
+        int failed;
         omc_matlab4_read_all_vals(&simresglob.matReader);
         nrows = numberOfIntervals+1;
         vals = omc_alloc_interface.malloc_atomic(sizeof(double)*nrows);
-        for (j=0; j<=numberOfIntervals; j++) {
-          double t = j==numberOfIntervals ? stop : start + (stop-start)*((double)j)/numberOfIntervals;
-          ModelicaMatVariable_t var = {0};
-          var.name="";
-          var.descr="";
-          var.isParam=0;
-          var.index=indexesToOutput[i];
-          if (omc_matlab4_val(vals+j, &simresglob.matReader, &var, t)) {
-            msg[2] = inFile;
-            GC_asprintf((char**)msg+1, "%d", indexesToOutput[i]);
-            GC_asprintf((char**)msg+0, "%.15g", t);
-            c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Resampling %s failed to get variable %s at time %s.\n"), msg, 3);
-            return 0;
-          }
+        var.name="";
+        var.descr="";
+        var.isParam=0;
+        var.index=indexesToOutput[i];
+        if ((failed = omc_matlab4_vals(vals, &simresglob.matReader, &var, times, nrows))) {
+          msg[2] = inFile;
+          GC_asprintf((char**)msg+1, "%d", indexesToOutput[i]);
+          GC_asprintf((char**)msg+0, "%.15g", times[failed-1]);
+          c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Resampling %s failed to get variable %s at time %s.\n"), msg, 3);
+          return 0;
         }
       } else {
         vals = omc_matlab4_read_vals(&simresglob.matReader, indexesToOutput[i]);
@@ -1234,6 +1234,8 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
   int* row_ptrs;
   int* row_ids;
   int i;
+  /* the parallel algorithm uses its own initialization and needs no row pointers */
+  int need_rows = matching_id != do_ppf && (matching_id >= do_hk || cheap_id > do_old_cheap);
 
   if (clear_match==1)
   {
@@ -1245,7 +1247,7 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     }
   }
 
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if(need_rows) {
 
     row_ptrs = (int*) malloc((m+1) * sizeof(int));
     memset(row_ptrs, 0, (m+1) * sizeof(int));
@@ -1272,7 +1274,9 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     free(t_row_ptrs);
   }
 
-  cheap_matching(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, cheap_id);
+  if(matching_id != do_ppf) {
+    cheap_matching(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, cheap_id);
+  }
 
   if(matching_id == do_dfs) {
     match_dfs(col_ptrs, col_ids, match, row_match, n, m);
@@ -1294,8 +1298,10 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     match_abmp_bfs(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m);
   } else if(matching_id == do_pr_fifo_fair) {
     match_pr_fifo_fair(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, relabel_period);
+  } else if(matching_id == do_ppf) {
+    match_ppf(col_ptrs, col_ids, match, row_match, n, m);
   }
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if(need_rows) {
     free(row_ids);
     free(row_ptrs);
   }
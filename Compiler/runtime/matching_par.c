@@ -0,0 +1,347 @@
+/*
+ * File: matching_par.c
+ * Content: Contains a multithreaded maximum transversal algorithm
+ *
+ * The algorithm is a parallel variant of PF (see matching.c), following:
+ *
+ *   "A. Azad, M. Halappanavar, S. Rajamanickam, E. G. Boman, A. Khan and A. Pothen.
+ *   'Multithreaded Algorithms for Maximum Matching in Bipartite Graphs'
+ *   IPDPS 2012."
+ *
+ * A phase starts a depth first search with lookahead from every unmatched
+ * column. The searches run concurrently and claim the rows they visit with an
+ * atomic operation, so all augmenting paths of a phase are vertex disjoint and
+ * can be applied without further synchronization. Columns whose search failed
+ * without interference are not searched again. The algorithm stops after a
+ * phase without augmentation, the matching is maximum then. When only few
+ * unmatched columns are left or a phase finds only few augmenting paths, the
+ * matching is completed with PF+.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#include <windows.h>
+#define PPF_CAS(ptr, oldval, newval) (InterlockedCompareExchange((volatile LONG*)(ptr), (newval), (oldval)) == (oldval))
+#define PPF_FETCH_ADD(ptr, val) InterlockedExchangeAdd((volatile LONG*)(ptr), (val))
+#else
+#include <unistd.h>
+#define PPF_CAS(ptr, oldval, newval) __sync_bool_compare_and_swap((ptr), (oldval), (newval))
+#define PPF_FETCH_ADD(ptr, val) __sync_fetch_and_add((ptr), (val))
+#endif
+
+#include "matchmaker.h"
+
+/* smaller graphs are matched sequentially, the threads would cost more than they save */
+#define PPF_MIN_PARALLEL_COLS 4096
+/* number of columns a thread takes at once from the shared work list */
+#define PPF_CHUNK 256
+/* minimum number of unmatched columns per thread for a parallel phase */
+#define PPF_MIN_PARALLEL_WORK 1024
+/* a parallel phase must augment at least every PPF_MIN_AUGMENT_RATIO-th searched column */
+#define PPF_MIN_AUGMENT_RATIO 8
+
+static int ppf_num_threads = 0;
+
+void match_ppf_set_num_threads(int num_threads) {
+  ppf_num_threads = num_threads;
+}
+
+static int ppf_get_num_threads() {
+  if(ppf_num_threads > 0) {
+    return ppf_num_threads;
+  }
+#if defined(__MINGW32__) || defined(_MSC_VER)
+  {
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors > 0 ? sysinfo.dwNumberOfProcessors : 1;
+  }
+#else
+  {
+    long res = sysconf(_SC_NPROCESSORS_ONLN);
+    return res > 0 ? (int)res : 1;
+  }
+#endif
+}
+
+typedef struct {
+  int* col_ptrs;
+  int* col_ids;
+  int* match;
+  int* row_match;
+  int* visited;      /* id of the search that claimed a row, -1 for dead rows */
+  int* colptrs;      /* dfs position of each column */
+  int* lookahead;    /* lookahead position of each column */
+  int* work;         /* columns of the current pass */
+  int nwork;
+  int next;          /* next unprocessed entry of work, taken with PPF_FETCH_ADD */
+  int id_base;       /* search id of the first column of the current phase */
+  int naugmented;    /* augmentations of the current phase */
+} ppf_shared;
+
+typedef struct {
+  ppf_shared* shared;
+  int* stack;
+  int* popped;       /* columns of a failed search */
+  int* unmatched;    /* columns that are still unmatched after the pass */
+  int nunmatched;
+  int degree_one;    /* only for the initialization: 1 for the pass over degree one columns */
+  int started;       /* the thread of the current pass was created */
+} ppf_thread;
+
+/* Claims row for the search id. Rows are marked with the id of the search that
+ * visited them, ids of earlier phases are smaller than base, dead rows are -1.
+ * Returns 1 if the row was claimed, sets *blocked if another search has it. */
+static int ppf_claim(int* visited, int row, int id, int base, int* blocked) {
+  int v = visited[row];
+  while(v != -1 && v < base) {
+    if(PPF_CAS(&visited[row], v, id)) {
+      return 1;
+    }
+    v = visited[row];
+  }
+  if(v != -1 && v != id) {
+    *blocked = 1;
+  }
+  return 0;
+}
+
+/* Greedy initialization in the spirit of Karp-Sipser: columns of degree one are
+ * matched first, because their only row is the only choice for them. */
+static void* ppf_cheap_thread(void* arg) {
+  ppf_thread* t = (ppf_thread*)arg;
+  ppf_shared* s = t->shared;
+  int i, k, ptr, start;
+
+  while((start = PPF_FETCH_ADD(&s->next, PPF_CHUNK)) < s->nwork) {
+    int end = start + PPF_CHUNK < s->nwork ? start + PPF_CHUNK : s->nwork;
+    for(k = start; k < end; k++) {
+      i = s->work[k];
+      if(s->match[i] != -1 || (s->col_ptrs[i+1] - s->col_ptrs[i] == 1) != t->degree_one) {
+        continue;
+      }
+      for(ptr = s->col_ptrs[i]; ptr < s->col_ptrs[i+1]; ptr++) {
+        int row = s->col_ids[ptr];
+        if(s->row_match[row] == -1 && PPF_CAS(&s->row_match[row], -1, i)) {
+          s->match[i] = row;
+          break;
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+/* One phase of vertex disjoint depth first searches with lookahead. If a search
+ * fails without meeting a row of another search, its rows can never be part of
+ * an augmenting path again (see PF in matching.c), they are marked dead and the
+ * column is not searched again. */
+static void* ppf_phase_thread(void* arg) {
+  ppf_thread* t = (ppf_thread*)arg;
+  ppf_shared* s = t->shared;
+  int* col_ptrs = s->col_ptrs;
+  int* col_ids = s->col_ids;
+  int* match = s->match;
+  int* row_match = s->row_match;
+  int* visited = s->visited;
+  int* colptrs = s->colptrs;
+  int* lookahead = s->lookahead;
+  int* stack = t->stack;
+  int* popped = t->popped;
+  int base = s->id_base;
+  int i, k, start, naugmented = 0;
+
+  t->nunmatched = 0;
+  while((start = PPF_FETCH_ADD(&s->next, PPF_CHUNK)) < s->nwork) {
+    int end = start + PPF_CHUNK < s->nwork ? start + PPF_CHUNK : s->nwork;
+    for(k = start; k < end; k++) {
+      int current_col = s->work[k];
+      int id = base + k;
+      int stack_last = 0, npopped = 0, blocked = 0;
+      stack[0] = current_col; colptrs[current_col] = col_ptrs[current_col];
+
+      while(stack_last > -1) {
+        int stack_col = stack[stack_last];
+        int eptr = col_ptrs[stack_col + 1];
+        int ptr, row = -1;
+
+        /* a free row can only be claimed by a search that uses it for an augmentation */
+        for(ptr = lookahead[stack_col]; ptr < eptr; ptr++) {
+          if(row_match[col_ids[ptr]] == -1 && ppf_claim(visited, col_ids[ptr], id, base, &blocked)) {
+            row = col_ids[ptr];
+            break;
+          }
+        }
+        lookahead[stack_col] = ptr + 1;
+
+        if(row == -1) {
+          for(ptr = colptrs[stack_col]; ptr < eptr; ptr++) {
+            if(ppf_claim(visited, col_ids[ptr], id, base, &blocked)) {
+              row = col_ids[ptr];
+              break;
+            }
+          }
+          colptrs[stack_col] = ptr + 1;
+
+          if(row == -1) {
+            popped[npopped++] = stack_col;
+            --stack_last;
+            continue;
+          }
+          if(row_match[row] != -1) {
+            int col = row_match[row];
+            stack[++stack_last] = col; colptrs[col] = col_ptrs[col];
+            continue;
+          }
+        }
+
+        /* augment along the stack, all rows and columns on it belong to this search */
+        while(row != -1) {
+          int col = stack[stack_last--];
+          int temp = match[col];
+          match[col] = row; row_match[row] = col;
+          row = temp;
+        }
+        naugmented++;
+        break;
+      }
+
+      if(match[current_col] == -1) {
+        if(blocked) {
+          t->unmatched[t->nunmatched++] = current_col;
+        } else {
+          /* the last popped column is the root, it has no row */
+          for(i = 0; i < npopped - 1; i++) {
+            visited[match[popped[i]]] = -1;
+          }
+        }
+      }
+    }
+  }
+  PPF_FETCH_ADD(&s->naugmented, naugmented);
+  return NULL;
+}
+
+static void ppf_run(ppf_thread* threads, pthread_t* th, int num_threads, void* (*fn)(void*)) {
+  int i;
+  threads[0].shared->next = 0;
+  for(i = 1; i < num_threads; i++) {
+    /* if a thread cannot be created, the calling thread takes over its share of the work */
+    threads[i].started = pthread_create(&th[i], NULL, fn, &threads[i]) == 0;
+    if(!threads[i].started) {
+      threads[i].nunmatched = 0;
+    }
+  }
+  fn(&threads[0]);
+  for(i = 1; i < num_threads; i++) {
+    if(threads[i].started) {
+      pthread_join(th[i], NULL);
+    }
+  }
+}
+
+void match_ppf(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m) {
+  int num_threads = ppf_get_num_threads();
+  int i, t, nwork;
+  ppf_shared s;
+  ppf_thread* threads;
+  pthread_t* th;
+
+  if(num_threads < 2 || n < PPF_MIN_PARALLEL_COLS) {
+    old_cheap(col_ptrs, col_ids, match, row_match, n, m);
+    match_pf_fair(col_ptrs, col_ids, match, row_match, n, m);
+    return;
+  }
+
+  s.col_ptrs = col_ptrs;
+  s.col_ids = col_ids;
+  s.match = match;
+  s.row_match = row_match;
+  s.visited = (int*)malloc(sizeof(int) * m);
+  s.colptrs = (int*)malloc(sizeof(int) * n);
+  s.lookahead = (int*)malloc(sizeof(int) * n);
+  s.work = (int*)malloc(sizeof(int) * n);
+  s.id_base = 0;
+  memset(s.visited, 0, sizeof(int) * m);
+  memcpy(s.lookahead, col_ptrs, sizeof(int) * n);
+
+  threads = (ppf_thread*)malloc(sizeof(ppf_thread) * num_threads);
+  th = (pthread_t*)malloc(sizeof(pthread_t) * num_threads);
+  for(t = 0; t < num_threads; t++) {
+    threads[t].shared = &s;
+    threads[t].stack = (int*)malloc(sizeof(int) * n);
+    threads[t].popped = (int*)malloc(sizeof(int) * n);
+    threads[t].unmatched = (int*)malloc(sizeof(int) * n);
+    threads[t].nunmatched = 0;
+  }
+
+  nwork = 0;
+  for(i = 0; i < n; i++) {
+    if(match[i] == -1 && col_ptrs[i] != col_ptrs[i+1]) {
+      s.work[nwork++] = i;
+    }
+  }
+  s.nwork = nwork;
+
+  /* initialization, first the columns of degree one, then the others */
+  for(t = 0; t < num_threads; t++) {threads[t].degree_one = 1;}
+  ppf_run(threads, th, num_threads, ppf_cheap_thread);
+  for(t = 0; t < num_threads; t++) {threads[t].degree_one = 0;}
+  ppf_run(threads, th, num_threads, ppf_cheap_thread);
+
+  nwork = 0;
+  for(i = 0; i < s.nwork; i++) {
+    if(match[s.work[i]] == -1) {
+      s.work[nwork++] = s.work[i];
+    }
+  }
+  s.nwork = nwork;
+
+  /* the last phases find only few augmenting paths, they are left to the sequential algorithm */
+  while(s.nwork > PPF_MIN_PARALLEL_WORK * num_threads) {
+    /* search ids must be larger than all ids of earlier phases */
+    if(s.id_base > INT_MAX - 2 * n) {
+      for(i = 0; i < m; i++) {
+        if(s.visited[i] != -1) {s.visited[i] = 0;}
+      }
+      s.id_base = 0;
+    }
+    s.id_base += n + 1;
+    s.naugmented = 0;
+    ppf_run(threads, th, num_threads, ppf_phase_thread);
+    if(s.naugmented == 0) {
+      s.nwork = 0;
+      break;
+    }
+    nwork = 0;
+    for(t = 0; t < num_threads; t++) {
+      memcpy(s.work + nwork, threads[t].unmatched, sizeof(int) * threads[t].nunmatched);
+      nwork += threads[t].nunmatched;
+    }
+    if(s.naugmented * PPF_MIN_AUGMENT_RATIO < s.nwork) {
+      /* most searches of the phase failed on large overlapping trees */
+      break;
+    }
+    s.nwork = nwork;
+  }
+  if(s.nwork > 0) {
+    match_pf_fair(col_ptrs, col_ids, match, row_match, n, m);
+  }
+
+  for(t = 0; t < num_threads; t++) {
+    free(threads[t].stack);
+    free(threads[t].popped);
+    free(threads[t].unmatched);
+  }
+  free(th);
+  free(threads);
+  free(s.work);
+  free(s.lookahead);
+  free(s.colptrs);
+  free(s.visited);
+}
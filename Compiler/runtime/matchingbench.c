@@ -0,0 +1,173 @@
+/*
+ * File: matchingbench.c
+ * Content: Benchmark for the maximum transversal algorithms of matchmaker.h
+ *
+ * Reads a bipartite graph in Matrix Market coordinate format, e.g. written by
+ * omc with -d=dumpMatchingGraph, where the rows are the variables and the
+ * columns are the equations. The graph is stored in CSC format and matched
+ * with every given algorithm (see matchmaker.h for the ids).
+ *
+ * Usage: matchingbench file.mtx [-t threads] [-c cheap_id] [-r repeats] [matching_id ...]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "matchmaker.h"
+
+static double wall_time() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* reads the matrix into CSC format, returns 0 on success */
+static int read_matrix_market(const char* filename, int** col_ptrs_out, int** col_ids_out, int* n_out, int* m_out) {
+  FILE* f = fopen(filename, "r");
+  char line[1024];
+  int m, n, nz, i, k, row, col;
+  int *rows, *cols, *col_ptrs, *col_ids;
+
+  if(f == NULL) {
+    fprintf(stderr, "Cannot open %s\n", filename);
+    return 1;
+  }
+  do {
+    if(fgets(line, sizeof(line), f) == NULL) {
+      fprintf(stderr, "%s: missing size line\n", filename);
+      fclose(f);
+      return 1;
+    }
+  } while(line[0] == '%');
+  if(sscanf(line, "%d %d %d", &m, &n, &nz) != 3 || m < 0 || n < 0 || nz < 0) {
+    fprintf(stderr, "%s: invalid size line\n", filename);
+    fclose(f);
+    return 1;
+  }
+
+  rows = (int*)malloc(sizeof(int) * nz);
+  cols = (int*)malloc(sizeof(int) * nz);
+  col_ptrs = (int*)malloc(sizeof(int) * (n + 1));
+  col_ids = (int*)malloc(sizeof(int) * nz);
+  memset(col_ptrs, 0, sizeof(int) * (n + 1));
+  for(k = 0; k < nz; k++) {
+    /* values of real and integer matrices are ignored */
+    if(fgets(line, sizeof(line), f) == NULL || sscanf(line, "%d %d", &row, &col) != 2 ||
+       row < 1 || row > m || col < 1 || col > n) {
+      fprintf(stderr, "%s: invalid entry %d\n", filename, k + 1);
+      free(rows); free(cols); free(col_ptrs); free(col_ids);
+      fclose(f);
+      return 1;
+    }
+    rows[k] = row - 1;
+    cols[k] = col - 1;
+    col_ptrs[col]++;
+  }
+  fclose(f);
+
+  for(i = 0; i < n; i++) {col_ptrs[i+1] += col_ptrs[i];}
+  {
+    int* pos = (int*)malloc(sizeof(int) * n);
+    memcpy(pos, col_ptrs, sizeof(int) * n);
+    for(k = 0; k < nz; k++) {col_ids[pos[cols[k]]++] = rows[k];}
+    free(pos);
+  }
+  free(rows);
+  free(cols);
+
+  *col_ptrs_out = col_ptrs;
+  *col_ids_out = col_ids;
+  *n_out = n;
+  *m_out = m;
+  return 0;
+}
+
+/* returns the cardinality of the matching or -1 if it is inconsistent */
+static int check_matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m) {
+  int i, ptr, card = 0;
+  for(i = 0; i < n; i++) {
+    if(match[i] == -1) {
+      continue;
+    }
+    if(match[i] < 0 || match[i] >= m || row_match[match[i]] != i) {
+      return -1;
+    }
+    for(ptr = col_ptrs[i]; ptr < col_ptrs[i+1] && col_ids[ptr] != match[i]; ptr++) {}
+    if(ptr == col_ptrs[i+1]) {
+      return -1;
+    }
+    card++;
+  }
+  for(i = 0; i < m; i++) {
+    if(row_match[i] != -1 && (row_match[i] < 0 || row_match[i] >= n || match[row_match[i]] != i)) {
+      return -1;
+    }
+  }
+  return card;
+}
+
+int main(int argc, char** argv) {
+  int default_ids[] = {do_pf_fair, do_hk, do_pr_fifo_fair, do_ppf};
+  int* ids = (int*)malloc(sizeof(int) * argc);
+  int nids = 0, cheap_id = do_sk_cheap_rand, repeats = 3;
+  int *col_ptrs, *col_ids, *match, *row_match;
+  int n, m, i, r, res = 0;
+  const char* filename = NULL;
+
+  for(i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      match_ppf_set_num_threads(atoi(argv[++i]));
+    } else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      cheap_id = atoi(argv[++i]);
+    } else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      repeats = atoi(argv[++i]);
+    } else if(filename == NULL) {
+      filename = argv[i];
+    } else {
+      ids[nids++] = atoi(argv[i]);
+    }
+  }
+  if(filename == NULL) {
+    fprintf(stderr, "Usage: %s file.mtx [-t threads] [-c cheap_id] [-r repeats] [matching_id ...]\n", argv[0]);
+    return 1;
+  }
+  if(nids == 0) {
+    nids = sizeof(default_ids) / sizeof(default_ids[0]);
+    memcpy(ids, default_ids, sizeof(default_ids));
+  }
+  if(read_matrix_market(filename, &col_ptrs, &col_ids, &n, &m)) {
+    return 1;
+  }
+  printf("%s: %d columns, %d rows, %d nonzeros\n", filename, n, m, col_ptrs[n]);
+
+  match = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+  row_match = (int*)malloc(sizeof(int) * (m > 0 ? m : 1));
+  for(i = 0; i < nids; i++) {
+    double best = -1.0;
+    int card = 0;
+    for(r = 0; r < repeats; r++) {
+      double start = wall_time(), elapsed;
+      matching(col_ptrs, col_ids, match, row_match, n, m, ids[i], cheap_id, 1.0, 1);
+      elapsed = wall_time() - start;
+      if(best < 0.0 || elapsed < best) {
+        best = elapsed;
+      }
+      card = check_matching(col_ptrs, col_ids, match, row_match, n, m);
+    }
+    if(card < 0) {
+      printf("matching %2d: invalid matching\n", ids[i]);
+      res = 1;
+    } else {
+      printf("matching %2d: cardinality %d, best of %d runs %.4f s\n", ids[i], card, repeats, best);
+    }
+  }
+
+  free(row_match);
+  free(match);
+  free(col_ids);
+  free(col_ptrs);
+  free(ids);
+  return res;
+}
@@ -35,6 +35,7 @@
 #define do_abmp 8
 #define do_abmp_bfs 9
 #define do_pr_fifo_fair 10
+#define do_ppf 11
 
 void old_cheap(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m);
 void sk_cheap(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
@@ -52,6 +53,9 @@ void match_abmp(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* m
 void match_abmp_bfs(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 void match_pr_fifo_fair(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m, double relabel_period);
 
+void match_ppf(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m);
+void match_ppf_set_num_threads(int num_threads);
+
 void pr_global_relabel(int* l_label, int* r_label, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 
 void cheap_matching(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m, int cheap_id);
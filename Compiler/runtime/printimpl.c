@@ -31,6 +31,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 #include "errorext.h"
 #include "systemimpl.h"
@@ -43,18 +49,36 @@ extern char* _replace(const char* source_str, const char* search_str, const char
 
 #define GROWTH_FACTOR 1.4  /* According to some rumors of buffer growth */
 #define INITIAL_BUFSIZE 4000 /* Seems reasonable */
+#define MAX_CHUNKSIZE (1<<20) /* The chunks of the print buffer grow up to this size */
 #define MAXSAVEDBUFFERS 10   /* adrpo: added this so it compiles again! MathCore can change it later */
 
+/* The print buffer is a list of chunks (a rope). Data is never moved when the
+ * buffer grows; a new chunk is appended instead. Generated files can be hundreds
+ * of MB, copying them on every reallocation was a bottleneck. */
+typedef struct print_chunk_s {
+  struct print_chunk_s *next;
+  long size;    /* capacity of data */
+  long nfilled;
+  char data[1];
+} print_chunk;
+
+typedef struct print_buffer_s {
+  print_chunk *head;
+  print_chunk *tail;
+  long nfilled;         /* total length, including the data already streamed to the file */
+  char lastChar;
+  FILE *stream;         /* set by streamBufToFile, full chunks are written to this file */
+  char *streamFileName;
+  char *streamTmpFileName; /* the stream is renamed to streamFileName when it is complete */
+  int streamError;
+} print_buffer;
+
 typedef struct print_members_s {
-  char *buf;
+  print_buffer buffer;
   char *errorBuf;
-  int nfilled;
-  int cursize;
   int errorNfilled;
   int errorCursize;
-  char** savedBuffers;
-  long* savedCurSize;
-  long* savedNfilled;
+  print_buffer* savedBuffers;
 } print_members;
 
 #include <pthread.h>
@@ -62,6 +86,28 @@ typedef struct print_members_s {
 pthread_once_t printimpl_once_create_key = PTHREAD_ONCE_INIT;
 pthread_key_t printimplKey;
 
+/* Frees the chunks of the buffer and discards its unfinished stream */
+static void free_buffer(print_buffer *b)
+{
+  print_chunk *chunk = b->head, *next;
+  while (chunk) {
+    next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  if (b->stream) {
+    fclose(b->stream);
+    remove(b->streamTmpFileName);
+  }
+  if (b->streamFileName) {
+    free(b->streamFileName);
+  }
+  if (b->streamTmpFileName) {
+    free(b->streamTmpFileName);
+  }
+  memset(b, 0, sizeof(print_buffer));
+}
+
 static void free_printimpl(void *data)
 {
   int i;
@@ -69,17 +115,12 @@ static void free_printimpl(void *data)
   if (data == NULL) return;
   if (members->savedBuffers) {
     for (i=0; i<MAXSAVEDBUFFERS; i++) {
-      if (members->savedBuffers[i]) {
-        free(members->savedBuffers[i]);
-        members->savedBuffers[i] = NULL;
-      }
+      free_buffer(&members->savedBuffers[i]);
     }
     free(members->savedBuffers);
   }
-  if (members->buf != NULL) free(members->buf);
+  free_buffer(&members->buffer);
   if (members->errorBuf != NULL) free(members->errorBuf);
-  if (members->savedCurSize != NULL) free(members->savedCurSize);
-  if (members->savedNfilled != NULL) free(members->savedNfilled);
   free(members);
 }
 
@@ -109,67 +150,132 @@ static print_members* getMembers(threadData_t *threadData)
 }
 
 
-#define buf members->buf
 #define errorBuf members->errorBuf
-#define nfilled members->nfilled
-#define cursize members->cursize
 #define errorNfilled members->errorNfilled
 #define errorCursize members->errorCursize
 #define savedBuffers members->savedBuffers
-#define savedCurSize members->savedCurSize
-#define savedNfilled members->savedNfilled
 
-static int increase_buffer(threadData_t *threadData)
+static print_chunk* new_chunk(long size)
 {
-  print_members* members = getMembers(threadData);
-  char *new_buf;
-  int new_size;
-  if (cursize == 0) {
-    new_buf = (char*)malloc(INITIAL_BUFSIZE*sizeof(char));
-    if (new_buf == NULL) { return -1; }
-    new_buf[0]='\0';
-    cursize = INITIAL_BUFSIZE;
+  print_chunk *chunk = (print_chunk*)malloc(sizeof(print_chunk)+size);
+  if (chunk == NULL) { return NULL; }
+  chunk->next = NULL;
+  chunk->size = size;
+  chunk->nfilled = 0;
+  return chunk;
+}
+
+/* Writes all chunks to the stream of the buffer. A chunk of the maximum size is
+ * kept for the following output, the others are freed. Write errors are reported
+ * when the stream is closed. */
+static void stream_chunks(print_buffer *b)
+{
+  print_chunk *chunk = b->head, *next;
+  b->head = b->tail = NULL;
+  while (chunk) {
+    next = chunk->next;
+    if (chunk->nfilled > 0 && 1 != fwrite(chunk->data, chunk->nfilled, 1, b->stream)) {
+      b->streamError = 1;
+    }
+    if (next == NULL && chunk->size == MAX_CHUNKSIZE) {
+      chunk->nfilled = 0;
+      b->head = b->tail = chunk;
+    } else {
+      free(chunk);
+    }
+    chunk = next;
+  }
+}
+
+/* Makes room at the end of the buffer, either by appending a new chunk or by
+ * writing the full chunks to the stream of the buffer. Returns 0 on success. */
+static int increase_buffer(print_buffer *b)
+{
+  print_chunk *chunk;
+  long size;
+  if (b->stream) {
+    stream_chunks(b);
+    if (b->tail) {
+      return 0;
+    }
+    size = MAX_CHUNKSIZE;
   } else {
-    //fprintf(stderr,"increasing buffer from %d to %d \n",cursize,((int)(cursize * GROWTH_FACTOR)));
-    new_buf = (char*)malloc((new_size =(int) (cursize * GROWTH_FACTOR))*sizeof(char));
-    if (new_buf == NULL) { return -1; }
-    memcpy(new_buf,buf,cursize);
-    cursize = new_size;
+    size = b->tail ? b->tail->size * 2 : INITIAL_BUFSIZE;
+    if (size > MAX_CHUNKSIZE) {
+      size = MAX_CHUNKSIZE;
+    }
   }
-  if (buf) {
-    free(buf);
+  chunk = new_chunk(size);
+  if (chunk == NULL) { return -1; }
+  if (b->tail) {
+    b->tail->next = chunk;
+  } else {
+    b->head = chunk;
   }
-  buf = new_buf;
+  b->tail = chunk;
   return 0;
 }
 
-static int increase_buffer_fixed(threadData_t *threadData,int increase)
+/* Appends len bytes of str, or len times the character c if str is NULL. Returns 0 on success. */
+static int append_buffer(print_buffer *b, const char *str, char c, long len)
 {
-  print_members* members = getMembers(threadData);
-  char * new_buf;
-  int new_size;
-
-  if (cursize == 0) {
-    new_buf = (char*)malloc(increase*sizeof(char));
-    if (new_buf == NULL) { return -1; }
-    new_buf[0]='\0';
-    cursize = increase;
-  } else {
-  new_size = (int)(cursize+increase);
-    //fprintf(stderr,"increasing buffer_FIXED_ from %d to %d \n",cursize,new_size);
-    new_buf = (char*)malloc(new_size*sizeof(char));
-    if (new_buf == NULL) { return -1; }
-    //memcpy(new_buf,buf,cursize);
-    cursize = new_size;
+  long n;
+  if (len <= 0) {
+    return 0;
   }
-  //printf("new buff size set to: %d\n",cursize);
-  if (buf) {
-    free(buf);
+  while (len > 0) {
+    if (b->tail == NULL || b->tail->nfilled == b->tail->size) {
+      if (increase_buffer(b) != 0) {
+        return 1;
+      }
+    }
+    n = b->tail->size - b->tail->nfilled;
+    if (n > len) {
+      n = len;
+    }
+    if (str) {
+      memcpy(b->tail->data + b->tail->nfilled, str, n);
+      str += n;
+    } else {
+      memset(b->tail->data + b->tail->nfilled, c, n);
+    }
+    b->tail->nfilled += n;
+    b->nfilled += n;
+    len -= n;
   }
-  buf = new_buf;
+  b->lastChar = b->tail->data[b->tail->nfilled-1];
   return 0;
 }
 
+/* Returns the content of the buffer as one string. The chunks are merged only if
+ * there is more than one; returns NULL on failure. */
+static const char* flatten_buffer(print_buffer *b)
+{
+  print_chunk *chunk, *next, *res;
+  long len = 0;
+  if (b->head == NULL) {
+    return "";
+  }
+  if (b->head == b->tail && b->head->nfilled < b->head->size) {
+    b->head->data[b->head->nfilled] = '\0';
+    return b->head->data;
+  }
+  for (chunk = b->head; chunk; chunk = chunk->next) {
+    len += chunk->nfilled;
+  }
+  res = new_chunk(len+1);
+  if (res == NULL) { return NULL; }
+  for (chunk = b->head; chunk; chunk = next) {
+    next = chunk->next;
+    memcpy(res->data + res->nfilled, chunk->data, chunk->nfilled);
+    res->nfilled += chunk->nfilled;
+    free(chunk);
+  }
+  res->data[res->nfilled] = '\0';
+  b->head = b->tail = res;
+  return res->data;
+}
+
 static int error_increase_buffer(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
@@ -214,19 +320,6 @@ static int print_error_buf_impl(threadData_t *threadData,const char *str)
   return 0;
 }
 
-static void PrintImpl__setBufSize(threadData_t *threadData,long newSize)
-{
-  if (newSize > 0) {
-    printf(" setting init_size to: %ld\n",newSize);
-    increase_buffer_fixed(threadData,newSize);
-  }
-}
-
-static void PrintImpl__unSetBufSize(threadData_t *threadData)
-{
-  increase_buffer_fixed(threadData,INITIAL_BUFSIZE);
-}
-
 /* Returns 0 on success; 1 on failure */
 static int PrintImpl__printErrorBuf(threadData_t *threadData,const char* str)
 {
@@ -271,98 +364,133 @@ static const char* PrintImpl__getErrorString(threadData_t *threadData)
 static int PrintImpl__printBuf(threadData_t *threadData,const char* str)
 {
   print_members* members = getMembers(threadData);
-  long len = strlen(str);
-  /* printf("cursize: %d, nfilled %d, strlen: %d\n",cursize,nfilled,strlen(str)); */
-
-  while (nfilled + len + 1 > cursize) {
-    if(increase_buffer(threadData)!= 0) {
-      return 1;
-    }
-    /* printf("increased -- cursize: %d, nfilled %d\n",cursize,nfilled); */
-  }
-
-  /*
-   * nfilled += sprintf((char*)(buf+nfilled),"%s",str);
-   * replaced by (below), courtesy of Pavol Privitzer
-   */
-  memcpy(buf+nfilled, str, len);
-  nfilled += len;
-  buf[nfilled] = '\0';
-
-  return 0;
+  return append_buffer(&members->buffer, str, 0, strlen(str));
 }
 
 static void PrintImpl__clearBuf(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
-  nfilled=0;
-  if (buf != 0) {
-    /* adrpo 2008-12-15 free the print buffer as it might have got quite big meantime */
-    free(buf);
-    buf = NULL;
-    cursize = 0;
-  }
+  /* adrpo 2008-12-15 free the print buffer as it might have got quite big meantime */
+  free_buffer(&members->buffer);
 }
 
 /* returns NULL on failure */
 static const char* PrintImpl__getString(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
-  if(buf == NULL || buf[0]=='\0' || cursize==0){
-    return "";
+  return flatten_buffer(&members->buffer);
+}
+
+static void print_write_file_error(const char *filename)
+{
+  const char *c_tokens[1]={filename};
+  c_add_message(NULL,21, /* WRITING_FILE_ERROR */
+    ErrorType_scripting,
+    ErrorLevel_error,
+    gettext("Error writing to file %s."),
+    c_tokens,
+    1);
+}
+
+/* Closes the stream of the buffer after writing the rest of the buffer to it
+ * and replaces the file with it.
+ * returns 0 on success */
+static int print_close_stream(print_buffer *b)
+{
+  int error;
+  stream_chunks(b);
+  error = b->streamError || fflush(b->stream) != 0;
+  if (fclose(b->stream) != 0) {
+    error = 1;
+  }
+  b->stream = NULL;
+  if (!error && !SystemImpl__rename(b->streamTmpFileName, b->streamFileName)) {
+    error = 1;
+  }
+  if (error) {
+    remove(b->streamTmpFileName);
+    print_write_file_error(b->streamFileName);
+    fprintf(stderr, "Print.writeBuf: error writing to file: %s!\n", b->streamFileName);
+  }
+  free(b->streamFileName);
+  free(b->streamTmpFileName);
+  b->streamFileName = NULL;
+  b->streamTmpFileName = NULL;
+  b->streamError = 0;
+  return error;
+}
+
+/* Opens a temporary file next to the file and writes the buffer to it. From now
+ * on the buffer is written to it whenever a chunk is full, so only one chunk is
+ * kept in memory. writeBuf with the same file name writes the rest and renames
+ * the temporary file to the file; clearBuf removes it, so a failed rendering
+ * never replaces the file.
+ * returns 0 on success */
+static int PrintImpl__streamBufToFile(threadData_t *threadData,const char* filename)
+{
+  print_members* members = getMembers(threadData);
+  print_buffer *b = &members->buffer;
+#if defined(__MINGW32__) || defined(_MSC_VER)
+  const char *fileOpenMode = "wt"; /* on Windows do translation so that \n becomes \r\n */
+#else
+  const char *fileOpenMode = "wb";  /* on Unixes don't bother, do it binary mode */
+#endif
+  if (b->stream) {
+    fprintf(stderr, "Print.streamBufToFile: the buffer is already written to file %s!\n", b->streamFileName);
+    return 1;
   }
-  if (buf == 0) {
-    if (increase_buffer(threadData) != 0) {
-      return NULL;
-    }
+  b->streamTmpFileName = (char*) malloc(strlen(filename) + 32);
+  sprintf(b->streamTmpFileName, "%s.%d.tmp", filename, (int) getpid());
+  b->stream = fopen(b->streamTmpFileName,fileOpenMode);
+  if (b->stream == NULL) {
+    print_write_file_error(filename);
+    free(b->streamTmpFileName);
+    b->streamTmpFileName = NULL;
+    return 1;
   }
-  return buf;
+  b->streamFileName = strdup(filename);
+  stream_chunks(b);
+  return 0;
 }
 
 /* returns 0 on success */
 static int PrintImpl__writeBuf(threadData_t *threadData,const char* filename)
 {
   print_members* members = getMembers(threadData);
+  print_chunk *chunk;
 #if defined(__MINGW32__) || defined(_MSC_VER)
   const char *fileOpenMode = "wt"; /* on Windows do translation so that \n becomes \r\n */
 #else
   const char *fileOpenMode = "wb";  /* on Unixes don't bother, do it binary mode */
 #endif
   FILE * file = NULL;
+
+  if (members->buffer.stream) {
+    if (strcmp(members->buffer.streamFileName, filename)) {
+      fprintf(stderr, "Print.writeBuf: the buffer is written to file %s, not to %s!\n", members->buffer.streamFileName, filename);
+      return 1;
+    }
+    return print_close_stream(&members->buffer);
+  }
+
   /* check if we have something to write */
   /* open the file */
   /* adrpo: 2010-09-22 open the file in BINARY mode as otherwise \r\n becomes \r\r\n! */
   file = fopen(filename,fileOpenMode);
   if (file == NULL) {
-    const char *c_tokens[1]={filename};
-    c_add_message(NULL,21, /* WRITING_FILE_ERROR */
-      ErrorType_scripting,
-      ErrorLevel_error,
-      gettext("Error writing to file %s."),
-      c_tokens,
-      1);
+    print_write_file_error(filename);
     return 1;
   }
 
-  if (buf == NULL || buf[0]=='\0') {
-    /* nothing to write to file, just close it and return ! */
-    fclose(file);
-    return 0;
-  }
-
-  /*  write 1 element of size nfilled to file and check for errors */
-  if (1 != fwrite(buf, nfilled, 1,  file))
-  {
-    const char *c_tokens[1]={filename};
-    c_add_message(NULL,21, /* WRITING_FILE_ERROR */
-      ErrorType_scripting,
-      ErrorLevel_error,
-      gettext("Error writing to file %s."),
-      c_tokens,
-      1);
-    fprintf(stderr, "Print.writeBuf: error writing to file: %s!\n", filename);
-    fclose(file);
-    return 1;
+  /*  write the chunks to file and check for errors */
+  for (chunk = members->buffer.head; chunk; chunk = chunk->next) {
+    if (chunk->nfilled > 0 && 1 != fwrite(chunk->data, chunk->nfilled, 1,  file))
+    {
+      print_write_file_error(filename);
+      fprintf(stderr, "Print.writeBuf: error writing to file: %s!\n", filename);
+      fclose(file);
+      return 1;
+    }
   }
   if (fflush(file) != 0)
   {
@@ -374,6 +502,52 @@ static int PrintImpl__writeBuf(threadData_t *threadData,const char* filename)
 
 #include <regex.h>
 
+typedef struct convert_lines_s {
+  FILE *file;
+  regex_t re_begin, re_end;
+  mmc_uint_t nlines, modelicaLine;
+  char *modelicaFileName;
+} convert_lines;
+
+/* Writes one line (without the new line character) to the file and converts the
+ * #modelicaLine directives */
+static void convert_line(convert_lines *state, char *str)
+{
+  regmatch_t matches[3];
+  if (0==regexec(&state->re_begin, str, 3, matches, 0)) {
+    str[matches[1].rm_eo] = '\0';
+    str[matches[2].rm_eo] = '\0';
+    if (state->modelicaFileName) {
+      free(state->modelicaFileName);
+    }
+    /* the line is overwritten by the following ones, keep a copy of the file name */
+#if defined(__MINGW32__) || defined(_MSC_VER)
+    /* on Windows change the backslashes to forward slashes */
+    {
+      char *tmp = _replace(str + matches[1].rm_so, "\\", "/");
+      state->modelicaFileName = strdup(tmp);
+      GC_free(tmp);
+    }
+#else
+    state->modelicaFileName = strdup(str + matches[1].rm_so);
+#endif
+    state->modelicaLine = strtol(str + matches[2].rm_so, NULL, 10);
+  } else if (0==regexec(&state->re_end, str, 3, matches, 0)) {
+    if (state->modelicaFileName) { /* There is sometimes #endModlicaLine without a matching #modelicaLine */
+      free(state->modelicaFileName);
+      state->modelicaFileName = NULL;
+      fprintf(state->file,"#line %ld OMC_FILE\n", state->nlines++);
+    }
+  } else if (state->modelicaFileName) {
+    fprintf(state->file,"#line %ld \"%s\"\n", state->modelicaLine, state->modelicaFileName);
+    fprintf(state->file,"%s\n", str);
+    state->nlines+=2;
+  } else {
+    fprintf(state->file,"%s\n", str);
+    state->nlines++;
+  }
+}
+
 /* returns 0 on success */
 static int PrintImpl__writeBufConvertLines(threadData_t *threadData,const char *filename)
 {
@@ -383,11 +557,11 @@ static int PrintImpl__writeBufConvertLines(threadData_t *threadData,const char *
 #else
   const char *fileOpenMode = "wb";  /* on Unixes don't bother, do it binary mode */
 #endif
-  char *str = buf, *next;
-  FILE * file = NULL;
-  regex_t re_begin,re_end;
-  regmatch_t matches[3];
-  mmc_uint_t nlines = 6 /* We start at 6 because we write 6 lines before the first line */, modelicaLine = 0;
+  convert_lines state;
+  print_chunk *chunk;
+  char *str, *end, *next;
+  char *line = NULL; /* a line that spans more than one chunk */
+  long lineLen = 0, lineSize = 0;
   /* What we try to match: */
   /*#modelicaLine [/path/to/a.mo:4:3-4:12]*/
   /*#endModelicaLine*/
@@ -399,50 +573,50 @@ static int PrintImpl__writeBufConvertLines(threadData_t *threadData,const char *
 #else /* real OSes */
   const char *re_str[2] = {"^ */[*]#modelicaLine .([^:]*):([0-9]*):[0-9]*-[0-9]*:[0-9]*.[*]/$", "^ */[*]#endModelicaLine[*]/$"};
 #endif
-  char *modelicaFileName = NULL;
   char* strtmp = NULL;
 
-  if (str!=NULL && nfilled!=0) {
-    str[nfilled] = '\0';
-
-    /* First, compile the regular expressions */
-    if (regcomp(&re_begin, re_str[0], REG_EXTENDED) || regcomp(&re_end, re_str[1], 0)) {
-      c_add_message(NULL,21, /* WRITING_FILE_ERROR */
-        ErrorType_scripting,
-        ErrorLevel_error,
-        gettext("Error compiling regular expression: %s or %s."),
-        re_str,
-        2);
-      return 1;
-    }
+  if (members->buffer.stream) {
+    fprintf(stderr, "Print.writeBufConvertLines: the buffer is already written to file %s!\n", members->buffer.streamFileName);
+    return 1;
   }
 
-  /* check if we have something to write */
-  /* open the file */
-  /* adrpo: 2010-09-22 open the file in BINARY mode as otherwise \r\n becomes \r\r\n! */
-  file = fopen(filename,fileOpenMode);
-  if (file == NULL) {
-    const char *c_tokens[1]={filename};
+  state.nlines = 6; /* We start at 6 because we write 6 lines before the first line */
+  state.modelicaLine = 0;
+  state.modelicaFileName = NULL;
+
+  /* First, compile the regular expressions */
+  if (regcomp(&state.re_begin, re_str[0], REG_EXTENDED) || regcomp(&state.re_end, re_str[1], 0)) {
     c_add_message(NULL,21, /* WRITING_FILE_ERROR */
       ErrorType_scripting,
       ErrorLevel_error,
-      gettext("Error writing to file %s."),
-      c_tokens,
-      1);
-    regfree(&re_begin);
-    regfree(&re_end);
+      gettext("Error compiling regular expression: %s or %s."),
+      re_str,
+      2);
     return 1;
   }
-  if (str == NULL || str[0]=='\0') {
+
+  /* check if we have something to write */
+  /* open the file */
+  /* adrpo: 2010-09-22 open the file in BINARY mode as otherwise \r\n becomes \r\r\n! */
+  state.file = fopen(filename,fileOpenMode);
+  if (state.file == NULL) {
+    print_write_file_error(filename);
+    regfree(&state.re_begin);
+    regfree(&state.re_end);
+    return 1;
+  }
+  if (members->buffer.nfilled == 0) {
     /* nothing to write to file, just close it and return ! */
-    fclose(file);
+    fclose(state.file);
+    regfree(&state.re_begin);
+    regfree(&state.re_end);
     return 1;
   }
 #if defined(__MINGW32__) || defined(_MSC_VER)
   /* on Windows change the backslashes to forward slashes */
   strtmp = _replace(filename, "\\", "/");
 #endif
-  fprintf(file,"#ifdef OMC_BASE_FILE\n"
+  fprintf(state.file,"#ifdef OMC_BASE_FILE\n"
                "  #define OMC_FILE OMC_BASE_FILE\n"
                "#else\n"
                "  #define OMC_FILE \"%s\"\n"
@@ -453,96 +627,78 @@ static int PrintImpl__writeBufConvertLines(threadData_t *threadData,const char *
 #else
                filename);
 #endif
-  do {
-    next = strchr(str,'\n');
-    if (!next) {
-      fprintf(file,"%s",str);
-      break;
-    }
-    *next++ = '\0';
-    if (0==regexec(&re_begin, str, 3, matches, 0)) {
-      str[matches[1].rm_eo] = '\0';
-      str[matches[2].rm_eo] = '\0';
-      modelicaFileName = str + matches[1].rm_so;
-      modelicaLine = strtol(str + matches[2].rm_so, NULL, 10);
-#if defined(__MINGW32__) || defined(_MSC_VER)
-      /* on Windows change the backslashes to forward slashes */
-      modelicaFileName = _replace(modelicaFileName, "\\", "/");
-#endif
-    } else if (0==regexec(&re_end, str, 3, matches, 0)) {
-      if (modelicaFileName) { /* There is sometimes #endModlicaLine without a matching #modelicaLine */
-#if defined(__MINGW32__) || defined(_MSC_VER)
-        GC_free(modelicaFileName);
-#endif
-        modelicaFileName = NULL;
-        fprintf(file,"#line %ld OMC_FILE\n", nlines++);
+  /* The lines are converted chunk by chunk; only the lines that span chunk
+   * boundaries are copied */
+  for (chunk = members->buffer.head; chunk; chunk = chunk->next) {
+    str = chunk->data;
+    end = chunk->data + chunk->nfilled;
+    while (str < end) {
+      next = (char*)memchr(str, '\n', end - str);
+      if (next == NULL) {
+        next = end;
       }
-    } else if (modelicaFileName) {
-      fprintf(file,"#line %ld \"%s\"\n", modelicaLine, modelicaFileName);
-      fprintf(file,"%s\n", str);
-      nlines+=2;
-    } else {
-      fprintf(file,"%s\n", str);
-      nlines++;
+      if (lineLen > 0 || next == end) {
+        if (lineLen + (next - str) + 1 > lineSize) {
+          lineSize = 2 * (lineLen + (next - str) + 1);
+          line = (char*)realloc(line, lineSize);
+        }
+        memcpy(line + lineLen, str, next - str);
+        lineLen += next - str;
+        line[lineLen] = '\0';
+        if (next < end) {
+          convert_line(&state, line);
+          lineLen = 0;
+        }
+      } else {
+        /* We do destructive updates on the print buffer */
+        *next = '\0';
+        convert_line(&state, str);
+      }
+      str = next + 1;
     }
-    str = next;
-  } while (1);
-#if defined(__MINGW32__) || defined(_MSC_VER)
-  if (modelicaFileName) {
-    GC_free(modelicaFileName);
   }
-#endif
+  if (lineLen > 0) {
+    /* the last line has no new line character */
+    fprintf(state.file,"%s",line);
+  }
+  if (line) {
+    free(line);
+  }
+  if (state.modelicaFileName) {
+    free(state.modelicaFileName);
+  }
   /* We do destructive updates on the print buffer; hide our tracks */
-  *buf = 0;
-  nfilled = 0;
-  regfree(&re_begin);
-  regfree(&re_end);
-  fclose(file);
+  free_buffer(&members->buffer);
+  regfree(&state.re_begin);
+  regfree(&state.re_end);
+  fclose(state.file);
   return 0;
 }
 
 static long PrintImpl__getBufLength(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
-  return nfilled;
+  return members->buffer.nfilled;
 }
 
 /* returns 0 on success */
 static int PrintImpl__printBufSpace(threadData_t *threadData,long nSpaces)
 {
   print_members* members = getMembers(threadData);
-  if (nSpaces > 0) {
-   while (nfilled + nSpaces + 1 > cursize) {
-     if(increase_buffer(threadData)!= 0) {
-       return 1;
-     }
-   }
-   memset(buf+nfilled,' ',(size_t)nSpaces);
-   nfilled += nSpaces;
-   buf[nfilled] = '\0';
-  }
-  return 0;
+  return append_buffer(&members->buffer, NULL, ' ', nSpaces);
 }
 
 /* returns 0 on success */
 static int PrintImpl__printBufNewLine(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
-  while (nfilled + 1+1 > cursize) {
-    if(increase_buffer(threadData)!= 0) {
-      return 1;
-    }
-  }
-  buf[nfilled++] = '\n';
-  buf[nfilled] = '\0';
-
-  return 0;
+  return append_buffer(&members->buffer, NULL, '\n', 1);
 }
 
 static int PrintImpl__hasBufNewLineAtEnd(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
-  return (nfilled > 0 && buf[nfilled-1] == '\n') ? 1 : 0;
+  return (members->buffer.nfilled > 0 && members->buffer.lastChar == '\n') ? 1 : 0;
 }
 
 static int PrintImpl__restoreBuf(threadData_t *threadData,long handle)
@@ -552,17 +708,14 @@ static int PrintImpl__restoreBuf(threadData_t *threadData,long handle)
     fprintf(stderr,"Internal error, handle %ld out of range. Should be in [%d,%d]\n",handle,0,MAXSAVEDBUFFERS-1);
     return 1;
   } else {
-    if (buf) { free(buf);}
-    buf = savedBuffers[handle];
-    cursize = savedCurSize[handle];
-    nfilled = savedNfilled[handle];
-    savedBuffers[handle] = 0;
-    savedCurSize[handle] = 0;
-    savedNfilled[handle] = 0;
-    if (buf == 0) {
+    if (savedBuffers == NULL || savedBuffers[handle].head == NULL) {
       fprintf(stderr,"Internal error, handle %ld does not contain a valid buffer pointer\n",handle);
       return 1;
     }
+    free_buffer(&members->buffer);
+    /* the chunks are moved, not copied */
+    members->buffer = savedBuffers[handle];
+    memset(&savedBuffers[handle], 0, sizeof(print_buffer));
     return 0;
   }
 }
@@ -571,32 +724,15 @@ static long PrintImpl__saveAndClearBuf(threadData_t *threadData)
 {
   print_members* members = getMembers(threadData);
   long freeHandle,foundHandle=0;
-  if (!buf) {
-    increase_buffer(threadData);
-  }
   if (! savedBuffers) {
-    savedBuffers = (char**)calloc(MAXSAVEDBUFFERS,sizeof(char*));
+    savedBuffers = (print_buffer*)calloc(MAXSAVEDBUFFERS,sizeof(print_buffer));
     if (!savedBuffers) {
       fprintf(stderr, "Internal error allocating savedBuffers in Print.saveAndClearBuf\n");
       return -1;
     }
   }
-  if (! savedCurSize) {
-    savedCurSize = (long*)calloc(MAXSAVEDBUFFERS,sizeof(long));
-    if (!savedCurSize) {
-      fprintf(stderr, "Internal error allocating savedCurSize in Print.saveAndClearBuf\n");
-      return -1;
-    }
-  }
-  if (! savedNfilled) {
-    savedNfilled = (long*)calloc(MAXSAVEDBUFFERS,sizeof(long));
-    if (!savedNfilled) {
-      fprintf(stderr, "Internal error allocating savedNfilled in Print.saveAndClearBuf\n");
-      return -1;
-    }
-  }
   for (freeHandle=0; freeHandle< MAXSAVEDBUFFERS; freeHandle++) {
-    if (savedBuffers[freeHandle]==0)
+    if (savedBuffers[freeHandle].head==0)
     {
       foundHandle = 1;
       break;
@@ -606,15 +742,11 @@ static long PrintImpl__saveAndClearBuf(threadData_t *threadData)
     fprintf(stderr,"Internal error, can not save more than %d buffers, increase MAXSAVEDBUFFERS in printimpl.c\n",MAXSAVEDBUFFERS);
     return -1;
   }
-  if (!buf) {
-    increase_buffer(threadData); /* Initialize it; the saved buffers cannot handle NULL */
+  if (!members->buffer.head && increase_buffer(&members->buffer) != 0) { /* Initialize it; the saved buffers cannot handle NULL */
+    return -1;
   }
-  savedBuffers[freeHandle] = buf;
-  savedCurSize[freeHandle] = cursize;
-  savedNfilled[freeHandle] = nfilled;
-  buf = (char*)malloc(INITIAL_BUFSIZE*sizeof(char));
-  *buf = 0;
-  nfilled=0;
-  cursize=INITIAL_BUFSIZE;
+  /* the chunks are moved, not copied */
+  savedBuffers[freeHandle] = members->buffer;
+  memset(&members->buffer, 0, sizeof(print_buffer));
   return freeHandle;
 }
@@ -43,4 +43,5 @@ extern void Print_clearBuf(threadData_t *threadData);
 extern void Print_printBufSpace(threadData_t *threadData,int numSpace);
 extern void Print_printBufNewLine(threadData_t *threadData);
 extern void Print_writeBuf(threadData_t *threadData,const char* filename);
+extern void Print_streamBufToFile(threadData_t *threadData,const char* filename);
 extern void Print_writeBufConvertLines(threadData_t *threadData,const char* filename);
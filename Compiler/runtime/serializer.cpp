@@ -1,13 +1,24 @@
 
 
 #include <stack>
-//#include <unordered_map>
 #include <map>
 #include <string>
 #include <vector>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 #include "meta_modelica.h"
 #include <stdint.h>
+#include <pthread.h>
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 extern "C"
 {
@@ -16,6 +27,12 @@ extern "C"
 /* This is used to keep track of generated record_description,
    that way we don't generate new every time something is de-serialized */
 std::map<std::string,record_description*> record_cache;
+/* Protects record_cache, files are de-serialized by the threads of the parallel parser */
+static pthread_mutex_t record_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Header of the files written by Serializer_writeCacheFile: magic and size of the data */
+static const char CACHE_FILE_MAGIC[8] = {'O','M','C','S','E','R','0','1'};
+static const size_t CACHE_FILE_HEADER = 16;
 
 
 static const uint8_t TAG_INT_TINY     = 0x00;
@@ -142,13 +159,76 @@ void writeShared(mmc_uint_t index,std::string& buffer){
     //printf("\n");
 }
 
+/* Hash table (open addressing with linear probing) from the objects seen so far to
+   their index. Large objects like the Absyn of a library have millions of nodes,
+   looking them up in a std::map dominated the serialization time. */
+class ObjectCache {
+public:
+    ObjectCache() : count(0), keys(1024,(void*)0), values(1024) {}
+
+    uint64_t size() const { return count; }
+
+    /* Inserts ptr with the next free index. If ptr is already in the table it returns
+       false and its index */
+    bool insert(void* ptr,uint64_t &index){
+        if(2*(count+1) > keys.size()){
+            grow();
+        }
+        size_t mask = keys.size()-1;
+        size_t i = hash(ptr) & mask;
+        while(keys[i]!=0){
+            if(keys[i]==ptr){
+                index = values[i];
+                return false;
+            }
+            i = (i+1) & mask;
+        }
+        keys[i]   = ptr;
+        values[i] = count;
+        index     = count++;
+        return true;
+    }
+
+private:
+    uint64_t count;
+    std::vector<void*> keys;
+    std::vector<uint64_t> values;
+
+    static size_t hash(void* ptr){
+        uint64_t h = (uint64_t)(uintptr_t)ptr;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return (size_t)h;
+    }
+
+    void grow(){
+        std::vector<void*> oldKeys;
+        std::vector<uint64_t> oldValues;
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        keys.assign(2*oldKeys.size(),(void*)0);
+        values.resize(2*oldKeys.size());
+        size_t mask = keys.size()-1;
+        for(size_t j = 0; j<oldKeys.size(); j++){
+            if(oldKeys[j]!=0){
+                size_t i = hash(oldKeys[j]) & mask;
+                while(keys[i]!=0){
+                    i = (i+1) & mask;
+                }
+                keys[i]   = oldKeys[j];
+                values[i] = oldValues[j];
+            }
+        }
+    }
+};
+
 /* Tries to insert the object to the seen-object list. If it has been found before it writes a shared object instead.
    Returns true if the object is new, false if it's shared */
-bool isNewObject(void* ptr,std::string& buffer, std::map<void*,uint64_t> &objcache){
-    std::pair<std::map<void*,uint64_t>::iterator,bool> ret;
-    ret = objcache.insert(std::pair<void*,uint64_t>(ptr,objcache.size()));
-    if(ret.second==false){
-        writeShared(ret.first->second,buffer);
+bool isNewObject(void* ptr,std::string& buffer, ObjectCache &objcache){
+    uint64_t index;
+    if(!objcache.insert(ptr,index)){
+        writeShared(index,buffer);
         return false;
     }
     //printf("%i:",objcache.size()-1);
@@ -156,7 +236,7 @@ bool isNewObject(void* ptr,std::string& buffer, std::map<void*,uint64_t> &objcac
 }
 
 /* Record descriptions are serialized as [path,name,[field1,...,fieldn]] */
-void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std::string& buffer,std::map<void*,uint64_t> &objcache){
+void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std::string& buffer,ObjectCache &objcache){
     mmc_uint_t size = 0;
     //printf("ctor(%i,%i) -> ", 3,255);
     writeStruct(3,255,buffer); // Serializes the objec as an array.
@@ -196,8 +276,8 @@ void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std
 void serialize(modelica_metatype input_object,std::string& buffer){
 
     std::stack<modelica_metatype> objstack;
-    std::map<void*,uint64_t> objcache;
-    buffer.reserve(1024*1024);
+    ObjectCache objcache;
+    buffer.reserve(buffer.size()+1024*1024);
     //Inserts the object to the stack
     objstack.push(input_object);
 
@@ -276,29 +356,48 @@ void readFile(char* filename,std::string& buffer){
                 std::istreambuf_iterator<char>());
 }
 
+/* Thrown if the data ends before the object is complete or contains an invalid tag */
+struct deserialize_error {};
+
+/* Checks that n more bytes can be read at index */
+static inline void checkAvailable(mmc_uint_t index,uint64_t n,mmc_uint_t end){
+    if(index>end || n>end-index){
+        throw deserialize_error();
+    }
+}
+
 /* Reads 16 bits from the buffer and moves the index forward */
-uint16_t read16(mmc_uint_t &index,unsigned char* data){
+uint16_t read16(mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
+    checkAvailable(index,2,end);
     uint16_t value = (uint16_t)data[index]<<8 | data[index+1];
     index+=2;
     return value;
 }
 
 /* Reads 32 bits from the buffer and moves the index forward */
-uint32_t read32(mmc_uint_t &index,unsigned char* data){
+uint32_t read32(mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
+    checkAvailable(index,4,end);
     uint32_t value = (uint32_t)data[index]<<24 | (uint32_t)data[index+1]<<16 | (uint32_t)data[index+2]<<8 | (uint32_t)data[index+3];
     index+=4;
     return value;
 }
 
-/* Reads 32 bits from the buffer and moves the index forward */
-uint64_t read64(mmc_uint_t &index,unsigned char* data){
+/* Reads 64 bits from the buffer and moves the index forward */
+uint64_t read64(mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
+    checkAvailable(index,8,end);
     uint64_t value =
-            (uint64_t)data[index]<<56 | (uint64_t)data[index+1]<<48 | (uint64_t)data[index+2]<<32 | (uint64_t)data[index+3] | (uint64_t)data[index+4]<<24 | (uint64_t)data[index+5]<<16 | (uint64_t)data[index+6]<<8 | (uint64_t)data[index+7];
+            (uint64_t)data[index]<<56 | (uint64_t)data[index+1]<<48 | (uint64_t)data[index+2]<<40 | (uint64_t)data[index+3]<<32 | (uint64_t)data[index+4]<<24 | (uint64_t)data[index+5]<<16 | (uint64_t)data[index+6]<<8 | (uint64_t)data[index+7];
     index+=8;
     return value;
 }
 
-modelica_metatype readInteger(uint8_t tag,mmc_uint_t &index,unsigned char* data){
+/* Returns the tag of the next object */
+static inline uint8_t readTag(mmc_uint_t index,unsigned char* data,mmc_uint_t end){
+    checkAvailable(index,1,end);
+    return data[index]&0xF0;
+}
+
+modelica_metatype readInteger(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
     uint8_t uvalue8;
     int8_t  value8;
     int32_t value32;
@@ -315,12 +414,12 @@ modelica_metatype readInteger(uint8_t tag,mmc_uint_t &index,unsigned char* data)
             return mmc_mk_integer(value8);
         case TAG_INT_SMALL:
             index++;
-            value32 = read32(index,data);
+            value32 = read32(index,data,end);
             //printf("%i\n", value32);
             return mmc_mk_integer(value32);
         case TAG_INT_BIG:
             index++;
-            value64 = read64(index,data);
+            value64 = read64(index,data,end);
             //printf("%i\n", value64);
             return mmc_mk_integer(value64);
         default: return mmc_mk_integer(0);
@@ -328,31 +427,39 @@ modelica_metatype readInteger(uint8_t tag,mmc_uint_t &index,unsigned char* data)
 }
 
 
-modelica_metatype readReal(uint8_t tag,mmc_uint_t &index,unsigned char* data){
+modelica_metatype readReal(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
     index++;
-    uint64_t ivalue = read64(index,data);
+    uint64_t ivalue = read64(index,data,end);
     double* fvalue = (double*)(&ivalue);
     //printf("%f\n", *fvalue);
     return mmc_mk_real(*fvalue);
 }
 
-
-modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data){
+/* Reads the size of a string and checks that its characters are in the buffer */
+static uint64_t readStringSize(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
     uint64_t size = 0;
     switch(tag){
         case TAG_STRING_SMALL:
             index++;
+            checkAvailable(index,1,end);
             size = data[index];
             index++;
             break;
         case TAG_STRING_BIG:
             index++;
-            size = read64(index,data);
+            size = read64(index,data,end);
             break;
-        default: break;
+        default:
+            throw deserialize_error();
     }
+    checkAvailable(index,size,end);
+    return size;
+}
 
-    modelica_metatype res = mmc_mk_scon_len(size+1);
+modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
+    uint64_t size = readStringSize(tag,index,data,end);
+
+    modelica_metatype res = mmc_mk_scon_len(size);
     const char* str = (const char*)&(data[index]);
     index += size;
 
@@ -366,61 +473,44 @@ modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data){
     return res;
 }
 
-char* readString_raw(uint8_t tag,mmc_uint_t &index,unsigned char* data){
-    uint64_t size = 0;
-    switch(tag){
-        case TAG_STRING_SMALL:
-            index++;
-            size = data[index];
-            index++;
-            break;
-        case TAG_STRING_BIG:
-            index++;
-            size = read64(index,data);
-            break;
-        default: break;
-    }
-
-    char* res = new char[size+1];
+std::string readString_raw(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
+    uint64_t size = readStringSize(tag,index,data,end);
     const char* str = (const char*)&(data[index]);
     index += size;
+    return std::string(str,size);
+}
 
-    //for(int i = 0;i<size;i++){
-    //    putchar(str[i]);
-    //}
-    //printf("\n");
-    memcpy(res, str, size);
-    res[size]=0;
+/* Returns a copy of the string that is owned by a record_description */
+static char* copyString(const std::string& str){
+    char* res = new char[str.size()+1];
+    memcpy(res, str.c_str(), str.size()+1);
     return res;
 }
 
-modelica_metatype readShared(uint8_t tag,mmc_uint_t &index,unsigned char* data,std::vector<modelica_metatype> &shared){
-    uint64_t i64;
-    uint16_t i16;
-    uint32_t i32;
+modelica_metatype readShared(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end,std::vector<modelica_metatype> &shared){
+    uint64_t i = 0;
     index++;
     switch(tag){
         case TAG_SHARED_TINY:
-            i16 = read16(index,data);
-            //printf("shared(%i)\n",i16);
-            return shared[i16];
+            i = read16(index,data,end);
             break;
         case TAG_SHARED_SMALL:
-            i32 = read32(index,data);
-            //printf("shared(%i)\n",i32);
-            return shared[i32];
+            i = read32(index,data,end);
             break;
         case TAG_SHARED_BIG:
-            i64 = read64(index,data);
-            //printf("shared(%i)\n",i64);
-            return shared[i64];
+            i = read64(index,data,end);
             break;
         default: break;
     }
-    return 0;
+    //printf("shared(%i)\n",i);
+    // placeholders of the record descriptions are never referenced
+    if(i>=shared.size() || shared[i]==0){
+        throw deserialize_error();
+    }
+    return shared[i];
 }
 
-void readStruct(uint8_t tag, mmc_uint_t &index, uint8_t* data, mmc_uint_t &size, mmc_uint_t &ctor){
+void readStruct(uint8_t tag, mmc_uint_t &index, uint8_t* data, mmc_uint_t end, mmc_uint_t &size, mmc_uint_t &ctor){
     switch(tag){
         case TAG_STRUCT_SMALL:
             size = data[index] & 0x0F;
@@ -428,12 +518,16 @@ void readStruct(uint8_t tag, mmc_uint_t &index, uint8_t* data, mmc_uint_t &size,
             break;
         case TAG_STRUCT_BIG:
             index++;
-            size = read64(index,data);
+            size = read64(index,data,end);
             break;
-        default: break;
+        default:
+            throw deserialize_error();
     }
+    checkAvailable(index,1,end);
     ctor = data[index];
     index++;
+    // every field takes at least one byte
+    checkAvailable(index,size,end);
 }
 
 modelica_metatype allocValue(mmc_uint_t size,mmc_uint_t ctor){
@@ -449,83 +543,69 @@ void setToNextField(modelica_metatype sub,std::stack<std::pair<modelica_metatype
 }
 
 /* This is a special case of the de-serialization to restore the record_descriptions */
-record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,std::vector<modelica_metatype> &shared){
+record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,mmc_uint_t end,std::vector<modelica_metatype> &shared){
     mmc_uint_t size,ctor;
     struct record_description* pdesc;
-    uint8_t tag = data[index]&0xF0;
+    uint8_t tag = readTag(index,data,end);
     switch(tag){
         case TAG_SHARED_TINY:
         case TAG_SHARED_SMALL:
         case TAG_SHARED_BIG:
-            pdesc = (struct record_description*)readShared(tag,index,data,shared);
+            pdesc = (struct record_description*)readShared(tag,index,data,end,shared);
             break;
 
         case TAG_STRUCT_SMALL:
         case TAG_STRUCT_BIG:
           {
-            readStruct(tag,index,data,size,ctor); // skipping since we already know what it is
-            // Read the path
-            char* path = readString_raw(data[index]&0xF0,index,data);
-            // check if we already have a description for this path
-            std::map<std::string,record_description*>::iterator it = record_cache.find(std::string(path));
+            readStruct(tag,index,data,end,size,ctor); // skipping since we already know what it is
+            // Read the path, the name and the field names before the cache is locked
+            std::string path = readString_raw(readTag(index,data,end),index,data,end);
+            std::string name = readString_raw(readTag(index,data,end),index,data,end);
+            readStruct(readTag(index,data,end),index,data,end,size,ctor); // this should be an array
+            std::vector<std::string> fields(size);
+            // the fields are not in the list of shared objects of the serializer
+            for(mmc_uint_t i=0;i<size;i++){
+                fields[i] = readString_raw(readTag(index,data,end),index,data,end);
+            }
 
+            // check if we already have a description for this path
+            pthread_mutex_lock(&record_cache_lock);
+            std::map<std::string,record_description*>::iterator it = record_cache.find(path);
             if(it==record_cache.end()){
                 pdesc = new struct record_description;
-                shared.push_back(pdesc);
-
-                shared.push_back(path);
-                // Read the name
-                char* name = readString_raw(data[index]&0xF0,index,data);
-                shared.push_back(name);
-                // Read the array
-                readStruct(data[index]&0xF0,index,data,size,ctor); // this should be an array
-                shared.push_back(0); // pushes anything since this objects are not reused
-                char** fields = new char*[size];
-                // Now read the fields
-                for(int i=0;i<size;i++){
-                    char* field = readString_raw(data[index]&0xF0,index,data);
-                    shared.push_back(field);
-                    fields[i] = field;
+                pdesc->path = copyString(path);
+                pdesc->name = copyString(name);
+                const char** fieldNames = new const char*[size];
+                for(mmc_uint_t i=0;i<size;i++){
+                    fieldNames[i] = copyString(fields[i]);
                 }
-                pdesc->path = path;
-                pdesc->name = name;
-                pdesc->fieldNames = (const char**) fields;
+                pdesc->fieldNames = fieldNames;
                 // Insert the record description to the global cache of descriptions
-                record_cache.insert( std::pair<std::string,record_description*>(std::string(path),pdesc));
+                record_cache.insert(std::pair<std::string,record_description*>(path,pdesc));
             }
             else {
                 pdesc = it->second;
-                // Now we read the data but we release the memory since we are not gonna use it
-                // (This part can be optimized)
-                shared.push_back(pdesc);
-                shared.push_back(0);
-                // Read the name
-                char* name = readString_raw(data[index]&0xF0,index,data);
-                shared.push_back(0);
-                // Read the array
-                readStruct(data[index]&0xF0,index,data,size,ctor); // this should be an array
-                shared.push_back(0); // pushes anything since this objects are not reused
-                // Now read the fields
-                for(int i=0;i<size;i++){
-                    char* field = readString_raw(data[index]&0xF0,index,data);
-                    delete[] field;
-                    shared.push_back(0);
-                }
-                delete[] path;
-                delete[] name;
             }
+            pthread_mutex_unlock(&record_cache_lock);
+
+            shared.push_back(pdesc);
+            // the path, the name and the array are not reused
+            shared.push_back(0);
+            shared.push_back(0);
+            shared.push_back(0);
             break;
           }
         default:
-            pdesc = NULL;
+            throw deserialize_error();
     }
     return pdesc;
 }
 
-modelica_metatype deserialize(std::string& buffer){
+/* Reads the object from the first end bytes of data. Throws deserialize_error if
+   the data is not a complete object. */
+modelica_metatype deserializeData(unsigned char* data,mmc_uint_t end){
     modelica_metatype  result,current;
     result = allocValue(1,0);
-    unsigned char* data = (unsigned char*) buffer.c_str();
     mmc_uint_t index = 0;
     mmc_uint_t size=0;
     mmc_uint_t ctor=0;
@@ -535,37 +615,40 @@ modelica_metatype deserialize(std::string& buffer){
     stack.push(std::make_pair(result,1));
 
     while(!stack.empty()){
-       unsigned char tag = data[index] & 0xF0;
+       unsigned char tag = readTag(index,data,end);
        switch(tag){ // integer
           case TAG_INT_TINY:
           case TAG_INT_SMALL:
           case TAG_INT_BIG:
-            current = readInteger(tag,index,data);
+            current = readInteger(tag,index,data,end);
             setToNextField(current,stack);
             break;
           case TAG_DOUBLE:
-            current = readReal(tag,index,data);
+            current = readReal(tag,index,data,end);
             setToNextField(current,stack);
             break;
           case TAG_STRING_SMALL:
           case TAG_STRING_BIG:
-            current = readString(tag,index,data);
+            current = readString(tag,index,data,end);
             setToNextField(current,stack);
             shared.push_back(current);
             break;
           case TAG_SHARED_TINY:
           case TAG_SHARED_SMALL:
           case TAG_SHARED_BIG:
-            current = readShared(tag,index,data,shared);
+            current = readShared(tag,index,data,end,shared);
             setToNextField(current,stack);
             break;
           case TAG_STRUCT_SMALL:
           case TAG_STRUCT_BIG:
             size = 0;
             ctor = 0;
-            readStruct(tag,index,data,size,ctor);
+            readStruct(tag,index,data,end,size,ctor);
             //printf("%i:ctor(%i,%i)\n",shared.size(),size,ctor);
             if(ctor>=3 && ctor!=255){ // not an array
+                if(size==0){ // a record has at least its description
+                    throw deserialize_error();
+                }
                 current = allocValue(size,ctor);
                 shared.push_back(current);
                 setToNextField(current,stack);
@@ -573,7 +656,7 @@ modelica_metatype deserialize(std::string& buffer){
                     stack.push(std::make_pair(current,size));
                     size--;
                 }
-                modelica_metatype record_desc = readRecordDescription(index,data,shared);
+                modelica_metatype record_desc = readRecordDescription(index,data,end,shared);
                 setToNextField(record_desc,stack);
             }
             else {
@@ -586,16 +669,31 @@ modelica_metatype deserialize(std::string& buffer){
                 }
             }
             break;
-          default: break;
+          default:
+            throw deserialize_error();
        }
     }
 #if 0
-    uint64_t total = read64(index,data);
+    uint64_t total = read64(index,data,end);
     printf("Sent %i :  Received %i\n",total,shared.size());
 #endif
     return MMC_FETCH(MMC_OFFSET(MMC_UNTAGPTR(result), 1));
 }
 
+modelica_metatype deserialize(std::string& buffer){
+    modelica_metatype res = NULL;
+    bool failed = false;
+    try {
+        res = deserializeData((unsigned char*) buffer.c_str(),buffer.size());
+    } catch(deserialize_error&) {
+        failed = true;
+    }
+    if(failed){
+        MMC_THROW();
+    }
+    return res;
+}
+
 
 static int indent_level = 0;
 
@@ -683,6 +781,107 @@ modelica_metatype Serializer_bypass(modelica_metatype input_object){
     return out;
 }
 
+/* Writes the object with a header to a temporary file that is renamed to filename
+   afterwards, so that other processes never read a partially written file.
+   Returns 1 on success. */
+int Serializer_writeCacheFile(modelica_metatype input_object,const char* filename){
+    std::string buffer(CACHE_FILE_MAGIC,8);
+    std::string size;
+    std::ostringstream tmpname;
+    std::ofstream fs;
+
+    write64(0,buffer); // the size of the data is set when it is known
+    serialize(input_object,buffer);
+    write64(buffer.size()-CACHE_FILE_HEADER,size);
+    buffer.replace(8,8,size);
+
+    tmpname << filename << "." << getpid() << ".tmp";
+    fs.open(tmpname.str().c_str(),std::ofstream::out | std::ofstream::binary);
+    fs.write(buffer.c_str(),buffer.size());
+    fs.close();
+    if(fs.fail() || rename(tmpname.str().c_str(),filename)!=0){
+        remove(tmpname.str().c_str());
+        return 0;
+    }
+    return 1;
+}
+
+static modelica_metatype readCacheData(unsigned char* data,size_t size){
+    mmc_uint_t index = 8;
+    if(size<=CACHE_FILE_HEADER || memcmp(data,CACHE_FILE_MAGIC,8)!=0 || read64(index,data,size)!=size-CACHE_FILE_HEADER){
+        return mmc_mk_none();
+    }
+    // a truncated or corrupt file is a cache miss
+    try {
+        return mmc_mk_some(deserializeData(data+CACHE_FILE_HEADER,size-CACHE_FILE_HEADER));
+    } catch(deserialize_error&) {
+        return mmc_mk_none();
+    }
+}
+
+/* Reads a file written by Serializer_writeCacheFile. The file is mapped into memory
+   instead of being copied to a buffer first. Returns NONE() if the file does not
+   exist or is not a valid cache file. */
+modelica_metatype Serializer_readCacheFile(const char* filename){
+#if defined(_WIN32)
+    std::ifstream input_file(filename,std::ifstream::in | std::ifstream::binary);
+    std::string buffer;
+    if(!input_file){
+        return mmc_mk_none();
+    }
+    buffer.assign((std::istreambuf_iterator<char>(input_file)),
+                std::istreambuf_iterator<char>());
+    return readCacheData((unsigned char*) buffer.c_str(),buffer.size());
+#else
+    struct stat st;
+    int fd = open(filename,O_RDONLY);
+    if(fd<0){
+        return mmc_mk_none();
+    }
+    if(fstat(fd,&st)!=0 || (size_t)st.st_size<=CACHE_FILE_HEADER){
+        close(fd);
+        return mmc_mk_none();
+    }
+    void* data = mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if(data==MAP_FAILED){
+        return mmc_mk_none();
+    }
+    modelica_metatype res = readCacheData((unsigned char*) data,st.st_size);
+    munmap(data,st.st_size);
+    return res;
+#endif
+}
+
+/* Returns the 64 bit FNV-1a hash of the salt followed by the contents of the file as
+   hex string, or an empty string if the file can not be read. */
+modelica_metatype Serializer_fileHash(const char* filename,const char* salt){
+    std::ifstream input_file(filename,std::ifstream::in | std::ifstream::binary);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    char chunk[65536];
+    char res[17];
+
+    if(!input_file){
+        return mmc_mk_scon("");
+    }
+    for(const char* c = salt; *c; c++){
+        hash = (hash ^ (unsigned char)*c) * 0x100000001b3ULL;
+    }
+    hash = hash * 0x100000001b3ULL; // separates the salt from the contents
+    while(input_file){
+        input_file.read(chunk,sizeof(chunk));
+        std::streamsize n = input_file.gcount();
+        for(std::streamsize i = 0; i<n; i++){
+            hash = (hash ^ (unsigned char)chunk[i]) * 0x100000001b3ULL;
+        }
+    }
+    if(input_file.bad()){
+        return mmc_mk_scon("");
+    }
+    snprintf(res,sizeof(res),"%016llx",(unsigned long long)hash);
+    return mmc_mk_scon(res);
+}
+
 
 
 }
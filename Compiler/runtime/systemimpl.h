@@ -86,6 +86,7 @@ extern int SystemImpl__setLDFlags(const char *str);
 extern char* SystemImpl__pwd(void);
 extern int SystemImpl__regularFileExists(const char* str);
 extern int SystemImpl__removeFile(const char* filename);
+extern int SystemImpl__rename(const char *source, const char *dest);
 extern const char* SystemImpl__basename(const char *str);
 extern int SystemImpl__systemCall(const char* str, const char* outFile);
 extern void* SystemImpl__systemCallParallel(void *lst, int numThreads);
@@ -0,0 +1,153 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+
+/*
+ Compares the level scheduler with the work stealing scheduler on a task
+ graph dumped by the compiler (<model>_tasks.xml). The equations are replaced
+ by busy loops proportional to their estimated cost.
+
+ usage: bench_graph <xml-file> [equations] [threads] [repetitions] [work-per-cost]
+*/
+
+
+#include <cstdlib>
+
+#include <tbb/task_scheduler_init.h>
+
+#include "pm_task_system.hpp"
+#include "pm_cluster_system.hpp"
+#include "pm_cluster_level_scheduler.hpp"
+#include "pm_cluster_dynamic_scheduler.hpp"
+
+
+using namespace openmodelica::parmodelica;
+
+
+struct BenchTask : public TaskNode {
+
+    BenchTask() :
+      TaskNode()
+      , index(-1)
+      , work(0)
+    {}
+
+    long index;
+    std::set<std::string> lhs;
+    std::set<std::string> rhs;
+    std::string type;
+    long work;
+
+    bool depends_on(const TaskNode& other_b) const {
+        const BenchTask& other = static_cast<const BenchTask&>(other_b);
+
+        return utility::has_intersection(this->rhs.begin(),this->rhs.end(),
+                                         other.lhs.begin(), other.lhs.end())
+            || utility::has_intersection(this->lhs.begin(),this->lhs.end(),
+                                         other.rhs.begin(), other.rhs.end())
+            || utility::has_intersection(this->lhs.begin(),this->lhs.end(),
+                                         other.lhs.begin(), other.lhs.end());
+    }
+
+    void execute() {
+        volatile double sink = 0;
+        for(long i = 0; i < work; ++i)
+            sink = sink + i * 0.5;
+    }
+};
+
+
+/*! Fixes the amount of work of each task before the profiling run overwrites the costs. */
+void set_work(TaskSystem_v2<BenchTask>& task_system, long work_per_cost) {
+    typedef TaskSystem_v2<BenchTask>::GraphType GraphType;
+    typedef TaskSystem_v2<BenchTask>::ClusterType ClusterType;
+
+    GraphType& sys_graph = task_system.sys_graph;
+    GraphType::vertex_iterator vert_iter, vert_end;
+    boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+    for ( ; vert_iter != vert_end; ++vert_iter) {
+        ClusterType& curr_clust = sys_graph[*vert_iter];
+        for(ClusterType::iterator t_iter = curr_clust.begin(); t_iter != curr_clust.end(); ++t_iter)
+            t_iter->work = (long)(t_iter->cost * work_per_cost);
+    }
+}
+
+
+template<typename SchedulerT>
+double run(SchedulerT& scheduler, int repetitions) {
+    /*! the first execution profiles and clusters. */
+    scheduler.execute();
+    scheduler.execution_timer.reset_timer();
+
+    for(int i = 0; i < repetitions; ++i)
+        scheduler.execute();
+
+    return scheduler.execution_timer.get_elapsed_time() / repetitions;
+}
+
+
+int main(int argc, char** argv) {
+
+    if(argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <xml-file> [equations] [threads] [repetitions] [work-per-cost]" << std::endl;
+        return 1;
+    }
+
+    std::string xml_file = argv[1];
+    std::string eq_to_read = argc > 2 ? argv[2] : "ode-equations";
+    int nr_of_threads = argc > 3 ? std::atoi(argv[3]) : tbb::task_scheduler_init::default_num_threads();
+    int repetitions = argc > 4 ? std::atoi(argv[4]) : 1000;
+    long work_per_cost = argc > 5 ? std::atol(argv[5]) : 1000;
+
+    tbb::task_scheduler_init tbb_system(nr_of_threads);
+
+    TaskSystem_v2<BenchTask> level_system;
+    level_system.load_from_xml(xml_file, eq_to_read);
+    set_work(level_system, work_per_cost);
+    StepLevels<BenchTask> level_scheduler(level_system);
+
+    TaskSystem_v2<BenchTask> ws_system;
+    ws_system.load_from_xml(xml_file, eq_to_read);
+    set_work(ws_system, work_per_cost);
+    ClusterWorkStealingScheduler<BenchTask> ws_scheduler(ws_system);
+
+    double level_time = run(level_scheduler, repetitions);
+    double ws_time = run(ws_scheduler, repetitions);
+
+    std::cout << xml_file << " (" << eq_to_read << "), " << nr_of_threads << " threads, "
+              << repetitions << " repetitions" << std::endl;
+    std::cout << "level:         " << level_time << " s per evaluation" << std::endl;
+    std::cout << "work stealing: " << ws_time << " s per evaluation" << std::endl;
+    std::cout << "ratio:         " << level_time / ws_time << std::endl;
+
+    return 0;
+}
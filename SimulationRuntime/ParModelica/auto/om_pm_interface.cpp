@@ -79,7 +79,11 @@ void PM_functionDAE(int size, DATA* data, threadData_t* threadData, FunctionType
 
 void PM_functionODE(int size, DATA* data, threadData_t* threadData, FunctionType* functionODE_systems) {
 
-    pm_om_model.ODE_scheduler.execute();
+    pm_om_model.initialize_threads();
+    if(pm_om_model.use_work_stealing)
+        pm_om_model.ODE_ws_scheduler.execute();
+    else
+        pm_om_model.ODE_scheduler.execute();
 
   // pm_om_model.ODE_scheduler.execution_timer.start_timer();
     // for(int i = 0; i < size; ++i)
@@ -106,8 +110,14 @@ void PM_functionAlg(int size, DATA* data, threadData_t* threadData, FunctionType
 void dump_times() {
     utility::log("") << "Total INI: " << pm_om_model.INI_scheduler.execution_timer.get_elapsed_time() << std::endl;
     utility::log("") << "Total DAE: " << pm_om_model.DAE_scheduler.execution_timer.get_elapsed_time() << std::endl;
-    utility::log("") << "Total ODE: " << pm_om_model.ODE_scheduler.execution_timer.get_elapsed_time() << std::endl;
-    utility::log("") << "Total ODE: " << pm_om_model.ODE_scheduler.clustering_timer.get_elapsed_time() << std::endl;
+    if(pm_om_model.use_work_stealing) {
+        utility::log("") << "Total ODE: " << pm_om_model.ODE_ws_scheduler.execution_timer.get_elapsed_time() << std::endl;
+        utility::log("") << "Total ODE: " << pm_om_model.ODE_ws_scheduler.clustering_timer.get_elapsed_time() << std::endl;
+    }
+    else {
+        utility::log("") << "Total ODE: " << pm_om_model.ODE_scheduler.execution_timer.get_elapsed_time() << std::endl;
+        utility::log("") << "Total ODE: " << pm_om_model.ODE_scheduler.clustering_timer.get_elapsed_time() << std::endl;
+    }
     utility::log("") << "Total ALG: " << pm_om_model.total_alg_time.get_elapsed_time() << std::endl;
 }
 
@@ -39,8 +39,17 @@
 #include "om_pm_model.hpp"
 
 #include <cstring>
+#include <cstdlib>
 #include <pugixml.hpp>
 
+#include <simulation/options.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
 
 namespace openmodelica {
 namespace parmodelica {
@@ -81,12 +90,47 @@ void Equation::execute() {
 }
 
 
+ThreadPinningObserver::ThreadPinningObserver() :
+    nr_of_cores(1)
+{
+    next_core = 0;
+}
+
+void ThreadPinningObserver::start(int nr_of_cores_) {
+    nr_of_cores = nr_of_cores_ > 0 ? nr_of_cores_ : 1;
+    next_core = 0;
+    /*! TBB calls on_scheduler_entry for the master thread, which is already
+      in the scheduler, when observing starts and for the workers when they join.*/
+    observe(true);
+}
+
+void ThreadPinningObserver::on_scheduler_entry(bool /*is_worker*/) {
+    int core = next_core.fetch_and_increment() % nr_of_cores;
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    if(sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+        utility::warning() << "Could not pin thread to core " << core << newl;
+#else
+    (void)core;
+#endif
+}
+
+
 OMModel::OMModel() :
+    tbb_system(tbb::task_scheduler_init::deferred),
     INI_scheduler(INI_system),
     DAE_scheduler(DAE_system),
-    ODE_scheduler(ODE_system)
+    ODE_scheduler(ODE_system),
+    ODE_ws_scheduler(ODE_system)
 {
     intialized = false;
+    threads_initialized = false;
+    nr_of_threads = tbb::task_scheduler_init::default_num_threads();
+    use_work_stealing = false;
 }
 
 
@@ -111,6 +155,45 @@ void OMModel::initialize(const char* model_name_, DATA* data_, threadData_t* thr
 
 }
 
+void OMModel::initialize_threads() {
+
+    if(threads_initialized)
+        return;
+
+    int nr_of_cores = tbb::task_scheduler_init::default_num_threads();
+    if(omc_flag[FLAG_PM_THREADS]) {
+        nr_of_threads = std::atoi(omc_flagValue[FLAG_PM_THREADS]);
+        if(nr_of_threads < 1) {
+            utility::warning() << "Invalid value for -pmThreads: " << omc_flagValue[FLAG_PM_THREADS] << ". Using " << nr_of_cores << newl;
+            nr_of_threads = nr_of_cores;
+        }
+    }
+
+    if(omc_flag[FLAG_PM_SCHEDULER]) {
+        std::string scheduler = omc_flagValue[FLAG_PM_SCHEDULER];
+        if(scheduler == "dynamic")
+            use_work_stealing = true;
+        else if(scheduler != "level")
+            utility::warning() << "Unknown value for -pmScheduler: " << scheduler << ". Using level" << newl;
+    }
+
+    if(omc_flag[FLAG_PM_RECLUSTER]) {
+        int recluster_steps = std::atoi(omc_flagValue[FLAG_PM_RECLUSTER]);
+        ODE_scheduler.set_recluster_steps(recluster_steps);
+        ODE_ws_scheduler.set_recluster_steps(recluster_steps);
+    }
+
+    tbb_system.initialize(nr_of_threads);
+    if(omc_flag[FLAG_PM_AFFINITY])
+        thread_pinning.start(nr_of_cores);
+
+    utility::log("") << "ParModelica: " << nr_of_threads << " threads, "
+                     << (use_work_stealing ? "dynamic" : "level") << " scheduler"
+                     << (omc_flag[FLAG_PM_AFFINITY] ? ", pinned to cores" : "") << std::endl;
+
+    threads_initialized = true;
+}
+
 
 void load_equation(Equation& current_node, pugi::xml_node& xml_equ) {
 
@@ -40,6 +40,10 @@
 
 #include <simulation_data.h>
 
+#include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
+#include <tbb/atomic.h>
+
 #include "pm_task_system.hpp"
 #include "pm_cluster_level_scheduler.hpp"
 #include "pm_cluster_dynamic_scheduler.hpp"
@@ -84,6 +88,20 @@ public:
 };
 
 
+/*! Pins every thread that joins the TBB scheduler to a core, round robin.
+  The master thread gets core 0. */
+class ThreadPinningObserver
+  : public tbb::task_scheduler_observer {
+    tbb::atomic<int> next_core;
+    int nr_of_cores;
+
+public:
+    ThreadPinningObserver();
+    void start(int nr_of_cores);
+    void on_scheduler_entry(bool is_worker);
+};
+
+
 class OMModel
   : boost::noncopyable {
     typedef Equation::FunctionType FunctionType;
@@ -96,6 +114,7 @@ class OMModel
     typedef StepLevels<Equation> SchedulerT;
     // typedef ClusterDynamicScheduler<Equation> SchedulerT;
     typedef TaskSystem_v2<Equation> TaskSystemT;
+    typedef ClusterWorkStealingScheduler<Equation> WorkStealingSchedulerT;
 
 
 
@@ -105,10 +124,21 @@ private:
     DATA* data;
     threadData_t* threadData;
 
+    bool threads_initialized;
+    tbb::task_scheduler_init tbb_system;
+    ThreadPinningObserver thread_pinning;
+
 public:
     OMModel();
     void initialize(const char* , DATA* , threadData_t* , FunctionType*);
 
+    /*! Reads -pmThreads, -pmAffinity, -pmScheduler and -pmRecluster. PM_Model_init runs before
+      the simulation flags are parsed, so this is done on the first evaluation. */
+    void initialize_threads();
+
+    int nr_of_threads;
+    bool use_work_stealing;
+
     FunctionType* ini_system_funcs;
     TaskSystemT INI_system;
     SchedulerT INI_scheduler;
@@ -120,6 +150,7 @@ public:
     FunctionType* ode_system_funcs;
     TaskSystemT ODE_system;
     SchedulerT ODE_scheduler;
+    WorkStealingSchedulerT ODE_ws_scheduler;
 
     PMTimer total_alg_time;
     TaskSystemT ALG_system;
@@ -39,7 +39,8 @@
 */
 
 #include <tbb/flow_graph.h>
-#include <tbb/task_scheduler_init.h>
+#include <tbb/task_group.h>
+#include <tbb/atomic.h>
 
 #include "pm_clustering.hpp"
 
@@ -76,8 +77,6 @@ public:
     typedef typename TaskType::FunctionType FunctionType;
 
 private:
-    tbb::task_scheduler_init tbb_system;
-
     tbb::flow::graph dynamic_graph;
     tbb::flow::broadcast_node<tbb::flow::continue_msg> flow_root;
 
@@ -92,8 +91,7 @@ public:
     TaskSystemType& task_system;
 
     ClusterDynamicScheduler(TaskSystemType& task_system)
-        : tbb_system()
-        , flow_root(dynamic_graph)
+        : flow_root(dynamic_graph)
         , flow_graph_created(false)
         , task_system(task_system)
     {
@@ -171,6 +169,230 @@ public:
 
 
 
+/*! Executes the clusters of a task system as soon as all their parents are done.
+  Each cluster keeps a counter of unfinished parents. The thread that finishes a
+  cluster decrements the counters of its children, continues with the first
+  child that becomes ready and spawns the others into a tbb::task_group, where
+  idle threads steal them. Unlike StepLevels there is no barrier between levels,
+  so a slow cluster only delays its own successors. */
+template<typename TaskType>
+class ClusterWorkStealingScheduler :
+  boost::noncopyable {
+public:
+    typedef TaskSystem_v2<TaskType> TaskSystemType;
+
+    typedef typename TaskSystemType::GraphType GraphType;
+    typedef typename TaskSystemType::ClusterType ClusterType;
+    typedef typename TaskSystemType::ClusterIdType ClusterIdType;
+
+private:
+    struct ClusterRunner {
+        ClusterWorkStealingScheduler& scheduler;
+        int cluster_index;
+
+        ClusterRunner(ClusterWorkStealingScheduler& s, int i)
+          : scheduler(s)
+          , cluster_index(i)
+        {}
+
+        void operator()() const {
+            scheduler.run_from(cluster_index);
+        }
+    };
+
+    TaskSystemType& task_system;
+    bool profiled;
+    bool schedule_valid;
+
+    /*! Number of evaluations measured before the system is clustered again. 0 disables it.*/
+    int recluster_steps;
+    int measured_steps;
+    bool measure;
+
+    /*! The graph flattened to index based arrays. The root node is not included.*/
+    std::vector<ClusterType*> clusters;
+    std::vector<std::vector<int> > children;
+    std::vector<int> parent_counts;
+    std::vector<int> roots;
+    std::vector<tbb::atomic<int> > pending_parents;
+
+    tbb::task_group task_group;
+
+    void run_from(int cluster_index) {
+        while(true) {
+            if(measure)
+                clusters[cluster_index]->measure_execute();
+            else
+                clusters[cluster_index]->execute();
+
+            int next = -1;
+            const std::vector<int>& curr_children = children[cluster_index];
+            for(size_t i = 0; i < curr_children.size(); ++i) {
+                int child = curr_children[i];
+                if(--pending_parents[child] == 0) {
+                    if(next < 0)
+                        next = child;
+                    else
+                        task_group.run(ClusterRunner(*this, child));
+                }
+            }
+
+            if(next < 0)
+                return;
+            cluster_index = next;
+        }
+    }
+
+    void flatten_graph() {
+        GraphType& sys_graph = task_system.sys_graph;
+
+        clusters.clear();
+        children.clear();
+        parent_counts.clear();
+        roots.clear();
+
+        std::map<ClusterIdType, int> cluster_index_map;
+        typename GraphType::vertex_iterator vert_iter, vert_end;
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            if(*vert_iter == task_system.root_node_id)
+                continue;
+            cluster_index_map.insert(std::make_pair(*vert_iter, (int)clusters.size()));
+            clusters.push_back(&sys_graph[*vert_iter]);
+        }
+
+        children.resize(clusters.size());
+        parent_counts.resize(clusters.size(), 0);
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            if(*vert_iter == task_system.root_node_id)
+                continue;
+            int curr_index = cluster_index_map[*vert_iter];
+
+            typename GraphType::adjacency_iterator child_iter, child_end;
+            boost::tie(child_iter, child_end) = adjacent_vertices(*vert_iter, sys_graph);
+            for( ; child_iter != child_end; ++child_iter) {
+                int child_index = cluster_index_map[*child_iter];
+                children[curr_index].push_back(child_index);
+                ++parent_counts[child_index];
+            }
+        }
+
+        for(size_t i = 0; i < clusters.size(); ++i) {
+            if(parent_counts[i] == 0)
+                roots.push_back((int)i);
+        }
+
+        pending_parents.resize(clusters.size());
+    }
+
+public:
+    PMTimer execution_timer;
+	PMTimer clustering_timer;
+
+    /*! The number of threads is set by the tbb::task_scheduler_init of the
+      calling thread (see OMModel). */
+    ClusterWorkStealingScheduler(TaskSystemType& ts)
+        : task_system(ts)
+        , profiled(false)
+        , schedule_valid(false)
+        , recluster_steps(0)
+        , measured_steps(0)
+        , measure(false)
+    {
+    }
+
+    /*! See StepLevels::set_recluster_steps.*/
+    void set_recluster_steps(int nr_of_steps) {
+        recluster_steps = nr_of_steps;
+        measured_steps = 0;
+    }
+
+    void schedule() {
+
+        if(schedule_valid)
+            return;
+
+		clustering_timer.start_timer();
+        task_system.save_original_graph();
+        cluster_merge_common::apply(task_system);
+		cluster_merge_common::dump_graph(task_system);
+        flatten_graph();
+        schedule_valid = true;
+		clustering_timer.stop_timer();
+    }
+
+    void execute() {
+
+        if(!this->profiled)
+            return profile_execute();
+
+        if(measured_steps < recluster_steps)
+            return measure_execute();
+
+        execution_timer.start_timer();
+        execute_graph();
+        execution_timer.stop_timer();
+    }
+
+    void execute_graph() {
+
+        for(size_t i = 0; i < clusters.size(); ++i)
+            pending_parents[i] = parent_counts[i];
+
+        for(size_t i = 0; i < roots.size(); ++i)
+            task_group.run(ClusterRunner(*this, roots[i]));
+        task_group.wait();
+    }
+
+    void measure_execute() {
+
+        if(measured_steps == 0)
+            task_system.reset_task_costs();
+
+        execution_timer.start_timer();
+        measure = true;
+        execute_graph();
+        measure = false;
+        execution_timer.stop_timer();
+
+        ++measured_steps;
+        if(measured_steps < recluster_steps)
+            return;
+
+        task_system.restore_original_graph(measured_steps);
+        this->schedule_valid = false;
+        schedule();
+        utility::log("") << "Clustered again with costs measured over " << measured_steps << " evaluations" << std::endl;
+    }
+
+    /*! The first evaluation runs sequentially and measures the cost of each
+      task, the clustering uses these costs. */
+    void profile_execute() {
+
+        execution_timer.start_timer();
+
+        GraphType& sys_graph = task_system.sys_graph;
+
+        typename GraphType::vertex_iterator vert_iter, vert_end;
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        /*! skip the root node. */
+        ++vert_iter;
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            sys_graph[*vert_iter].profile_execute();
+        }
+
+        execution_timer.stop_timer();
+
+        this->profiled = true;
+        this->schedule_valid = false;
+        schedule();
+    }
+
+};
+
+
+
 } // parmodelica
 } // openmodelica
 
@@ -39,7 +39,6 @@
 */
 
 #include <tbb/parallel_for.h>
-#include <tbb/task_scheduler_init.h>
 
 #include "pm_clustering.hpp"
 
@@ -65,7 +64,10 @@ private:
     GraphType& sys_graph;
 
 public:
-    TBBConcurrentStepExecutor(GraphType& g) : sys_graph(g) {}
+    /*! Adds the measured time of each task to its cost while executing.*/
+    bool measure;
+
+    TBBConcurrentStepExecutor(GraphType& g) : sys_graph(g), measure(false) {}
 
     void operator()( tbb::blocked_range<ClusteIdIter>& range ) const {
 
@@ -73,7 +75,10 @@ public:
             ClusterIdType& curr_clust_id = *clustid_iter;
             ClusterType& curr_clust = sys_graph[curr_clust_id];
 
-            curr_clust.execute();
+            if(measure)
+                curr_clust.measure_execute();
+            else
+                curr_clust.execute();
         }
     }
 
@@ -106,7 +111,10 @@ private:
     bool profiled;
     bool schedule_valid;
 
-    tbb::task_scheduler_init tbb_system;
+    /*! Number of evaluations measured before the system is clustered again. 0 disables it.*/
+    int recluster_steps;
+    int measured_steps;
+
     TBBConcurrentStepExecutor<TaskType> step_executor;
 
 public:
@@ -115,13 +123,25 @@ public:
 	PMTimer clustering_timer;
     // PMTimer extra_timer;
 
+    /*! The number of threads is set by the tbb::task_scheduler_init of the
+      calling thread (see OMModel). */
     StepLevels(TaskSystemType& ts) :
       task_system(ts)
-      , tbb_system(4)
       , step_executor(task_system.sys_graph)
     {
         profiled = false;
         schedule_valid = false;
+        recluster_steps = 0;
+        measured_steps = 0;
+    }
+
+    /*! After the first (sequential) profiling evaluation the next nr_of_steps
+      parallel evaluations measure the time of each task. The system is then
+      clustered again with the averaged times and the new schedule is used
+      from the next evaluation on.*/
+    void set_recluster_steps(int nr_of_steps) {
+        recluster_steps = nr_of_steps;
+        measured_steps = 0;
     }
 
     void estimate_speedup() {
@@ -160,6 +180,8 @@ public:
 
         clustering_timer.start_timer();
 
+        task_system.save_original_graph();
+
         if(task_system.levels_valid == false)
             task_system.update_node_levels();
 
@@ -189,17 +211,8 @@ public:
     }
 
 
-    void execute()
+    void execute_levels()
     {
-
-        if(!this->profiled)
-            return profile_execute();
-
-        execution_timer.start_timer();
-        // extra_timer.start_timer();
-
-        // GraphType& sys_graph = task_system.sys_graph;
-
         if(task_system.levels_valid == false)
             task_system.update_node_levels();
 
@@ -227,6 +240,24 @@ public:
                 // }
             // }
         }
+    }
+
+
+    void execute()
+    {
+
+        if(!this->profiled)
+            return profile_execute();
+
+        if(measured_steps < recluster_steps)
+            return measure_execute();
+
+        execution_timer.start_timer();
+        // extra_timer.start_timer();
+
+        // GraphType& sys_graph = task_system.sys_graph;
+
+        execute_levels();
 
         execution_timer.stop_timer();
         // extra_timer.stop_timer();
@@ -263,6 +294,28 @@ public:
 
     }
 
+
+    void measure_execute()
+    {
+        if(measured_steps == 0)
+            task_system.reset_task_costs();
+
+        execution_timer.start_timer();
+        step_executor.measure = true;
+        execute_levels();
+        step_executor.measure = false;
+        execution_timer.stop_timer();
+
+        ++measured_steps;
+        if(measured_steps < recluster_steps)
+            return;
+
+        task_system.restore_original_graph(measured_steps);
+        this->schedule_valid = false;
+        schedule();
+        utility::log("") << "Clustered again with costs measured over " << measured_steps << " evaluations" << std::endl;
+    }
+
 };
 
 
@@ -157,6 +157,22 @@ public:
         }
     }
 
+    /*! Like profile_execute but adds the measured times to the task costs.
+      Used to average the costs over several evaluations. */
+    void measure_execute()
+    {
+        PMTimer task_timer;
+
+        iterator t_iter;
+        for(t_iter = this->begin(); t_iter != this->end(); ++t_iter) {
+            task_timer.start_timer();
+            t_iter->execute();
+            task_timer.stop_timer();
+            t_iter->cost += task_timer.get_elapsed_time();
+            task_timer.reset_timer();
+        }
+    }
+
 
     static bool
     cost_comparator(const TaskCluster<TaskType>& lhs,
@@ -234,6 +250,11 @@ public:
 private:
     long node_count;
 
+    /*! The unclustered graph, saved before the first clustering so that the
+      system can be clustered again with measured costs.*/
+    std::vector<TaskType> original_tasks;
+    std::vector<std::pair<long, long> > original_edges;
+
 public:
 
     std::set<ClusterIdType> active_nodes;
@@ -501,6 +522,94 @@ public:
     }
 
 
+    /*! Saves the graph as it is before any clustering. Each cluster holds a
+      single task at this point. Only the first call has an effect.*/
+    void save_original_graph() {
+
+        if(!original_tasks.empty())
+            return;
+
+        vertex_iterator vert_iter, vert_end;
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        /*! skip the root node. */
+        ++vert_iter;
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            const ClusterIdType& curr_clust_id = *vert_iter;
+            const TaskType& curr_task = sys_graph[curr_clust_id].front();
+            original_tasks.push_back(curr_task);
+
+            adjacency_iterator child_iter, child_end;
+            boost::tie(child_iter, child_end) = adjacent_vertices(curr_clust_id, sys_graph);
+            for ( ; child_iter != child_end; ++child_iter) {
+                original_edges.push_back(std::make_pair(curr_task.task_id, sys_graph[*child_iter].front().task_id));
+            }
+        }
+    }
+
+    /*! Sets the cost of every task in the (possibly clustered) graph to zero.*/
+    void reset_task_costs() {
+        vertex_iterator vert_iter, vert_end;
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            ClusterType& curr_clust = sys_graph[*vert_iter];
+            typename ClusterType::iterator task_iter;
+            for(task_iter = curr_clust.begin(); task_iter != curr_clust.end(); ++task_iter)
+                task_iter->cost = 0;
+        }
+    }
+
+    /*! Rebuilds the unclustered graph. The cost of each task is taken from the
+      current graph, divided by nr_of_samples. The graph can then be clustered
+      again with these costs.*/
+    void restore_original_graph(int nr_of_samples) {
+
+        if(original_tasks.empty())
+            return;
+
+        std::vector<double> measured_costs(original_tasks.size(), 0);
+        vertex_iterator vert_iter, vert_end;
+        boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+        /*! skip the root node. */
+        ++vert_iter;
+        for ( ; vert_iter != vert_end; ++vert_iter) {
+            ClusterType& curr_clust = sys_graph[*vert_iter];
+            typename ClusterType::iterator task_iter;
+            for(task_iter = curr_clust.begin(); task_iter != curr_clust.end(); ++task_iter)
+                measured_costs[task_iter->task_id] = task_iter->cost / nr_of_samples;
+        }
+
+        sys_graph.clear();
+        active_nodes.clear();
+        clusters_by_level.clear();
+        levels_valid = false;
+        total_cost = 0;
+
+        root_node_id = boost::add_vertex(sys_graph);
+        TaskType& root_node = sys_graph[root_node_id].add_task(TaskType());
+        root_node.task_id = -1;
+
+        std::vector<ClusterIdType> task_clust_ids(original_tasks.size());
+        for(size_t i = 0; i < original_tasks.size(); ++i) {
+            TaskType task = original_tasks[i];
+            task.cost = measured_costs[task.task_id];
+
+            ClusterIdType new_clust_id = boost::add_vertex(sys_graph);
+            active_nodes.insert(new_clust_id);
+            sys_graph[new_clust_id].add_task(task);
+            task_clust_ids[task.task_id] = new_clust_id;
+            total_cost += task.cost;
+        }
+
+        for(size_t i = 0; i < original_edges.size(); ++i) {
+            boost::add_edge(task_clust_ids[original_edges[i].first], task_clust_ids[original_edges[i].second], sys_graph);
+        }
+
+        for(size_t i = 0; i < task_clust_ids.size(); ++i) {
+            if(in_degree(task_clust_ids[i], sys_graph) == 0)
+                boost::add_edge(root_node_id, task_clust_ids[i], sys_graph);
+        }
+    }
+
     void load_from_xml(const std::string& file_name, const std::string& eq_to_read);
     void dump_graphml(const std::string& filename);
 
@@ -45,6 +45,12 @@
 */
 
 
+// The native backend compiles this file and the kernels with a
+// C++ compiler. See omc_ocl_native_kernel.h
+#ifdef OMC_OCL_NATIVE
+  #include "omc_ocl_native_kernel.h"
+#endif
+
 #ifdef cl_amd_printf
   #pragma OPENCL EXTENSION cl_amd_printf : enable
   #define PRINTF_AVAILABLE
@@ -123,15 +129,15 @@ typedef struct gi_array integer_array;
 struct lr_array
 {
     int ndims;
-    local modelica_integer* dim_size;
-    local modelica_real* data;
+    __local modelica_integer* dim_size;
+    __local modelica_real* data;
 };
 
 struct li_array
 {
     int ndims;
-    local modelica_integer* dim_size;
-    local modelica_integer* data;
+    __local modelica_integer* dim_size;
+    __local modelica_integer* data;
 };
 typedef struct lr_array local_real_array;
 typedef struct li_array local_integer_array;
@@ -166,6 +172,17 @@ modelica_integer  oclGetNumGroups(modelica_integer dim) {
 #define oclGlobalBarrier() barrier(CLK_GLOBAL_MEM_FENCE)
 #define oclLocalBarrier() barrier(CLK_LOCAL_MEM_FENCE)
 
+// The loop of a parfor kernel. Work items start at their global id
+// and stride over the range by the number of work items. The native
+// backend defines its own version with one contiguous chunk per
+// work item. OCL_NATIVE_KERNEL registers a kernel for the native
+// backend and is empty for OpenCL.
+#ifndef OMC_OCL_NATIVE
+#define OCL_PARFOR_RANGE_LOOP(i, start, step, stop) \
+    for (modelica_integer i = (get_global_id(0) * (step)) + (start); in_range_integer(i, start, stop); i += get_global_size(0) * (step))
+#define OCL_NATIVE_KERNEL(name)
+#endif
+
 
 
 inline int in_range_integer(modelica_integer i,
@@ -44,7 +44,9 @@
 #define _OMC_OCL_COMMON_HEADER
 
 #include <stdio.h>
-#ifdef __APPLE__
+#if defined(OMC_OCL_NATIVE)
+#include "omc_ocl_native.h"
+#elif defined(__APPLE__)
 #include <OpenCL/cl.h>
 #else
 #include <CL/cl.h>
@@ -0,0 +1,595 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+/*
+
+ The native ParModelica backend. Compiled instead of
+ omc_ocl_memory_ops.cpp and omc_ocl_util.cpp into
+ libParModelicaExplNative.a (together with omc_ocl_interface.cpp).
+
+ Device memory is host memory. Kernels are functions of the
+ kernels file, compiled with the model, and executed by a pool
+ of threads on the host CPU. The calling thread takes part in
+ the execution as worker 0. The number of threads is the number
+ of processors or the value of the environment variable
+ PARMODELICA_NUM_THREADS.
+
+ The work groups of a launch are split into one contiguous block
+ per thread. The work items of a group are executed one after
+ the other by the same thread, __local memory is a buffer of
+ that thread.
+
+ See the header files for more comments.
+
+*/
+
+#include <vector>
+#include <pthread.h>
+
+#include "omc_ocl_util.h"
+#include "omc_ocl_memory_ops.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#endif
+
+
+// Spins of an idle worker before it blocks
+#define OCL_NATIVE_SPINS 20000
+// Alignment of device memory and __local buffers
+#define OCL_NATIVE_MEM_ALIGN 64
+
+
+struct _cl_kernel{
+ const ocl_native_kernel_info* info;
+ std::vector<ocl_native_arg> args;
+};
+
+// The thread pool. It is used as the command queue.
+struct _cl_command_queue{
+ int nr_of_workers;
+ std::vector<pthread_t> threads;
+ pthread_mutex_t lock;
+ pthread_cond_t start_cond;
+ pthread_cond_t done_cond;
+ volatile unsigned int generation;
+ volatile int nr_of_busy;
+ volatile bool shut_down;
+
+ // The current launch
+ cl_kernel kernel;
+ ocl_native_work_item range;
+ size_t nr_of_groups;
+};
+
+static _cl_command_queue ocl_native_pool;
+
+cl_command_queue device_comm_queue = NULL;
+cl_context  device_context = NULL;
+cl_device_id ocl_device = NULL;
+
+OCL_NATIVE_TLS ocl_native_work_item ocl_native_current_item;
+
+static ocl_native_kernel_info* ocl_native_kernels = NULL;
+
+modelica_integer MAX_THREADS_WORKGROUP = 0;
+modelica_integer WORK_DIM = 0;
+size_t GLOBAL_SIZE[3];
+size_t LOCAL_SIZE[3];
+
+
+int ocl_native_register_kernel(ocl_native_kernel_info* info){
+    info->next = ocl_native_kernels;
+    ocl_native_kernels = info;
+    return 1;
+}
+
+void ocl_native_barrier(int flags){
+    const ocl_native_work_item& item = ocl_native_current_item;
+    if (item.local_size[0] * item.local_size[1] * item.local_size[2] > 1){
+        printf("Error: barrier() in a kernel with more than one work item per work group.\n");
+        printf("The native ParModelica backend does not support barriers. Use the OpenCL backend or a local size of 1.\n");
+        exit(1);
+    }
+}
+
+
+static void* ocl_native_alloc(size_t size){
+    void* mem = NULL;
+    // Never return NULL for an empty array
+    if (size == 0)
+        size = 1;
+#if defined(_WIN32)
+    mem = _aligned_malloc(size, OCL_NATIVE_MEM_ALIGN);
+#else
+    if (posix_memalign(&mem, OCL_NATIVE_MEM_ALIGN, size))
+        mem = NULL;
+#endif
+    if (!mem){
+        printf("Error allocating %lu bytes of device memory\n", (unsigned long)size);
+        exit(1);
+    }
+    return mem;
+}
+
+static void ocl_native_free(void* mem){
+#if defined(_WIN32)
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+}
+
+cl_int clReleaseMemObject(cl_mem memobj){
+    if (memobj)
+        ocl_native_free(memobj);
+    return CL_SUCCESS;
+}
+
+
+//////////////////////////////////////////////////////////////
+// Memory operations. See omc_ocl_memory_ops.h
+
+cl_mem ocl_device_alloc(size_t size){
+    if (!device_comm_queue)
+        ocl_initialize();
+    return (cl_mem)ocl_native_alloc(size);
+}
+
+cl_mem ocl_device_alloc_init(modelica_integer* host_array, size_t size){
+    return ocl_alloc_init(host_array, size);
+}
+
+cl_mem ocl_device_alloc_init(modelica_real* host_array, size_t size){
+    return ocl_alloc_init(host_array, size);
+}
+
+cl_mem ocl_alloc_init(void* src_data, size_t size){
+    cl_mem tmp = ocl_device_alloc(size);
+    if (src_data)
+        memcpy(tmp, src_data, size);
+    return tmp;
+}
+
+void ocl_create_execution_memory_buffer(device_buffer* d_buff){
+    d_buff->size = 30 * 1024 * 1024 * sizeof(modelica_integer);
+    d_buff->buffer = ocl_device_alloc(d_buff->size);
+}
+
+cl_mem ocl_alloc_init_real_arr(modelica_real* host_array, int a_size){
+    return ocl_alloc_init(host_array, sizeof(modelica_real) * a_size);
+}
+
+cl_mem ocl_alloc_init_integer_arr(modelica_integer* host_array, int a_size){
+    return ocl_alloc_init(host_array, sizeof(modelica_integer) * a_size);
+}
+
+void ocl_copy_to_device_real(cl_mem dev_dest_array, modelica_real* src_host_array, int a_size){
+    memcpy(dev_dest_array, src_host_array, a_size * sizeof(modelica_real));
+}
+
+void ocl_copy_device_to_device_real(cl_mem dev_src_array, cl_mem device_dest_array, int a_size){
+    if (dev_src_array != device_dest_array)
+        memcpy(device_dest_array, dev_src_array, a_size * sizeof(modelica_real));
+}
+
+void ocl_copy_back_to_host_real(cl_mem dev_output_array, modelica_real* dest_host_array, int a_size){
+    memcpy(dest_host_array, dev_output_array, a_size * sizeof(modelica_real));
+}
+
+void ocl_copy_to_device_integer(cl_mem dev_dest_array, modelica_integer* src_host_array, int a_size){
+    memcpy(dev_dest_array, src_host_array, a_size * sizeof(modelica_integer));
+}
+
+void ocl_copy_device_to_device_integer(cl_mem dev_src_array, cl_mem device_dest_array, int a_size){
+    if (dev_src_array != device_dest_array)
+        memcpy(device_dest_array, dev_src_array, a_size * sizeof(modelica_integer));
+}
+
+void ocl_copy_back_to_host_integer(cl_mem dev_output_array, modelica_integer* dest_host_array, int a_size){
+    memcpy(dest_host_array, dev_output_array, a_size * sizeof(modelica_integer));
+}
+
+
+//////////////////////////////////////////////////////////////
+// Thread pool
+
+// Executes the work groups [first_group, last_group) of the current launch
+static void ocl_native_run_groups(_cl_command_queue* pool, size_t first_group, size_t last_group){
+
+    static OCL_NATIVE_TLS std::vector<char>* local_memory = NULL;
+    const ocl_native_work_item& range = pool->range;
+    cl_kernel kernel = pool->kernel;
+
+    if (first_group >= last_group)
+        return;
+
+    // Each thread works on its own copy of the arguments. __local
+    // arguments point to the local memory of the thread.
+    std::vector<ocl_native_arg> args(kernel->args);
+    size_t local_size = 0;
+    for (size_t i = 0; i < args.size(); i++){
+        if (args[i].kind == OCL_NATIVE_ARG_LOCAL)
+            local_size += (args[i].size + OCL_NATIVE_MEM_ALIGN - 1) / OCL_NATIVE_MEM_ALIGN * OCL_NATIVE_MEM_ALIGN;
+    }
+    if (local_size > 0){
+        if (!local_memory)
+            local_memory = new std::vector<char>();
+        if (local_memory->size() < local_size + OCL_NATIVE_MEM_ALIGN)
+            local_memory->resize(local_size + OCL_NATIVE_MEM_ALIGN);
+        char* next = &(*local_memory)[0];
+        next += (OCL_NATIVE_MEM_ALIGN - (size_t)next % OCL_NATIVE_MEM_ALIGN) % OCL_NATIVE_MEM_ALIGN;
+        memset(next, 0, local_size);
+        for (size_t i = 0; i < args.size(); i++){
+            if (args[i].kind == OCL_NATIVE_ARG_LOCAL){
+                args[i].value.pointer = next;
+                next += (args[i].size + OCL_NATIVE_MEM_ALIGN - 1) / OCL_NATIVE_MEM_ALIGN * OCL_NATIVE_MEM_ALIGN;
+            }
+        }
+    }
+
+    ocl_native_invoker invoker = kernel->info->invoker;
+    const ocl_native_arg* arg_ptr = args.empty() ? NULL : &args[0];
+    ocl_native_work_item& item = ocl_native_current_item;
+    item = range;
+
+    for (size_t group = first_group; group < last_group; group++){
+        item.group_id[0] = group % range.num_groups[0];
+        item.group_id[1] = (group / range.num_groups[0]) % range.num_groups[1];
+        item.group_id[2] = group / (range.num_groups[0] * range.num_groups[1]);
+
+        for (size_t z = 0; z < range.local_size[2]; z++){
+            item.local_id[2] = z;
+            item.global_id[2] = item.group_id[2] * range.local_size[2] + z;
+            for (size_t y = 0; y < range.local_size[1]; y++){
+                item.local_id[1] = y;
+                item.global_id[1] = item.group_id[1] * range.local_size[1] + y;
+                for (size_t x = 0; x < range.local_size[0]; x++){
+                    item.local_id[0] = x;
+                    item.global_id[0] = item.group_id[0] * range.local_size[0] + x;
+                    invoker(arg_ptr);
+                }
+            }
+        }
+    }
+}
+
+static void ocl_native_run_worker_share(_cl_command_queue* pool, int worker){
+    size_t first = pool->nr_of_groups * worker / pool->nr_of_workers;
+    size_t last = pool->nr_of_groups * (worker + 1) / pool->nr_of_workers;
+    ocl_native_run_groups(pool, first, last);
+}
+
+static void* ocl_native_worker_main(void* arg){
+
+    _cl_command_queue* pool = &ocl_native_pool;
+    int worker = (int)(size_t)arg;
+    unsigned int seen = 0;
+
+    while (true){
+        int spins = 0;
+        while (pool->generation == seen && ++spins < OCL_NATIVE_SPINS){}
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen)
+            pthread_cond_wait(&pool->start_cond, &pool->lock);
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (pool->shut_down)
+            break;
+
+        ocl_native_run_worker_share(pool, worker);
+
+        if (__sync_sub_and_fetch(&pool->nr_of_busy, 1) == 0){
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_signal(&pool->done_cond);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+    return NULL;
+}
+
+static int ocl_native_nr_of_processors(){
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long nr = sysconf(_SC_NPROCESSORS_ONLN);
+    return nr > 0 ? (int)nr : 1;
+#endif
+}
+
+static void ocl_native_start_pool(){
+
+    _cl_command_queue* pool = &ocl_native_pool;
+    const char* env = getenv("PARMODELICA_NUM_THREADS");
+
+    pool->nr_of_workers = env ? atoi(env) : ocl_native_nr_of_processors();
+    if (pool->nr_of_workers < 1)
+        pool->nr_of_workers = 1;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->generation = 0;
+    pool->nr_of_busy = 0;
+    pool->shut_down = false;
+
+    pool->threads.resize(pool->nr_of_workers - 1);
+    for (int i = 1; i < pool->nr_of_workers; i++){
+        if (pthread_create(&pool->threads[i - 1], NULL, ocl_native_worker_main, (void*)(size_t)i)){
+            printf("Error creating thread %d of the native ParModelica backend\n", i);
+            exit(1);
+        }
+    }
+
+#if BE_OCL_VERBOSE
+    printf("--- Native ParModelica backend with %d threads\n", pool->nr_of_workers);
+#endif
+}
+
+static void ocl_native_stop_pool(){
+
+    _cl_command_queue* pool = &ocl_native_pool;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shut_down = true;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->threads.size(); i++)
+        pthread_join(pool->threads[i], NULL);
+    pool->threads.clear();
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+// Stops the threads before the library is unloaded or the program exits
+struct ocl_native_pool_guard{
+    ~ocl_native_pool_guard(){
+        ocl_clean_up();
+    }
+};
+static ocl_native_pool_guard ocl_native_guard;
+
+
+//////////////////////////////////////////////////////////////
+// Kernels and thread management. See omc_ocl_util.h
+
+void ocl_initialize(){
+    if (!device_comm_queue){
+        ocl_native_start_pool();
+        device_comm_queue = &ocl_native_pool;
+        // default number of work items is one per thread
+        MAX_THREADS_WORKGROUP = ocl_native_pool.nr_of_workers;
+        if (WORK_DIM == 0 && GLOBAL_SIZE[0] == 0)
+            GLOBAL_SIZE[0] = MAX_THREADS_WORKGROUP;
+    }
+}
+
+void ocl_build_p_from_src(){
+    // The kernels are compiled with the model. Nothing to build.
+}
+
+cl_kernel ocl_create_kernel(cl_program program, const char* kernel_name){
+
+    if (!device_comm_queue)
+        ocl_initialize();
+
+    for (ocl_native_kernel_info* info = ocl_native_kernels; info; info = info->next){
+        if (strcmp(info->name, kernel_name) == 0){
+            cl_kernel kernel = new _cl_kernel;
+            kernel->info = info;
+            kernel->args.resize(info->nr_of_args);
+            for (int i = 0; i < info->nr_of_args; i++)
+                kernel->args[i].kind = OCL_NATIVE_ARG_NONE;
+            return kernel;
+        }
+    }
+
+    printf("Error creating Kernel:\n");
+    printf("Kernel %s not found. Is the kernels file compiled and linked with -DOMC_OCL_NATIVE?\n", kernel_name);
+    exit(1);
+}
+
+cl_int clReleaseKernel(cl_kernel kernel){
+    delete kernel;
+    return CL_SUCCESS;
+}
+
+static ocl_native_arg* ocl_native_kernel_arg(cl_kernel kernel, int arg_nr){
+    if (arg_nr < 0 || arg_nr >= (int)kernel->args.size()){
+        printf("Error: setting argument nr:  %d. Kernel %s has %d arguments\n",
+            arg_nr + 1, kernel->info->name, (int)kernel->args.size());
+        exit(1);
+    }
+    return &kernel->args[arg_nr];
+}
+
+void ocl_set_kernel_args(cl_kernel kernel, int count, ...){
+    va_list arguments;
+    va_start(arguments, count);
+    for (int i = 0; i < count; i++)
+        ocl_set_kernel_arg(kernel, i, va_arg(arguments, cl_mem));
+    va_end(arguments);
+}
+
+void ocl_set_kernel_arg(cl_kernel kernel, int arg_nr, cl_mem in_arg){
+    ocl_native_arg* arg = ocl_native_kernel_arg(kernel, arg_nr);
+    arg->kind = OCL_NATIVE_ARG_POINTER;
+    arg->value.pointer = in_arg;
+}
+
+void ocl_set_kernel_arg(cl_kernel kernel, int arg_nr, modelica_integer in_arg){
+    ocl_native_arg* arg = ocl_native_kernel_arg(kernel, arg_nr);
+    arg->kind = OCL_NATIVE_ARG_INTEGER;
+    arg->value.integer = in_arg;
+}
+
+void ocl_set_kernel_arg(cl_kernel kernel, int arg_nr, modelica_real in_arg){
+    ocl_native_arg* arg = ocl_native_kernel_arg(kernel, arg_nr);
+    arg->kind = OCL_NATIVE_ARG_REAL;
+    arg->value.real = in_arg;
+}
+
+void ocl_set_local_kernel_arg(cl_kernel kernel, int arg_nr, size_t in_size){
+    ocl_native_arg* arg = ocl_native_kernel_arg(kernel, arg_nr);
+    arg->kind = OCL_NATIVE_ARG_LOCAL;
+    arg->size = in_size;
+    arg->value.pointer = NULL;
+}
+
+void ocl_execute_kernel(cl_kernel kernel){
+
+    _cl_command_queue* pool = &ocl_native_pool;
+    ocl_native_work_item& range = pool->range;
+
+#if BE_OCL_VERBOSE
+    timeval t1, t2;
+    double elapsedTime;
+    gettimeofday(&t1, NULL);
+#endif
+
+    for (size_t i = 0; i < kernel->args.size(); i++){
+        if (kernel->args[i].kind == OCL_NATIVE_ARG_NONE){
+            printf("Error: argument nr: %d of kernel %s is not set\n", (int)i + 1, kernel->info->name);
+            exit(1);
+        }
+    }
+
+    // WORK_DIM == 0: only the global size is given. Every work item is its own work group.
+    range.work_dim = WORK_DIM == 0 ? 1 : (unsigned int)WORK_DIM;
+    for (int d = 0; d < 3; d++){
+        range.global_size[d] = 1;
+        range.local_size[d] = 1;
+    }
+    for (unsigned int d = 0; d < range.work_dim; d++){
+        range.global_size[d] = GLOBAL_SIZE[d];
+        range.local_size[d] = WORK_DIM == 0 ? 1 : LOCAL_SIZE[d];
+        if (range.local_size[d] == 0 || range.global_size[d] % range.local_size[d] != 0){
+            printf("Error: global size %lu is not a multiple of local size %lu in dimension %d\n",
+                (unsigned long)range.global_size[d], (unsigned long)range.local_size[d], d + 1);
+            exit(1);
+        }
+    }
+    pool->nr_of_groups = 1;
+    for (int d = 0; d < 3; d++){
+        range.num_groups[d] = range.global_size[d] / range.local_size[d];
+        pool->nr_of_groups *= range.num_groups[d];
+    }
+    pool->kernel = kernel;
+
+    if (pool->nr_of_workers > 1 && pool->nr_of_groups > 1){
+        pool->nr_of_busy = pool->nr_of_workers - 1;
+        pthread_mutex_lock(&pool->lock);
+        pool->generation++;
+        pthread_cond_broadcast(&pool->start_cond);
+        pthread_mutex_unlock(&pool->lock);
+
+        ocl_native_run_worker_share(pool, 0);
+
+        int spins = 0;
+        while (pool->nr_of_busy > 0 && ++spins < OCL_NATIVE_SPINS){}
+        pthread_mutex_lock(&pool->lock);
+        while (pool->nr_of_busy > 0)
+            pthread_cond_wait(&pool->done_cond, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    else {
+        ocl_native_run_groups(pool, 0, pool->nr_of_groups);
+    }
+
+#if BE_OCL_VERBOSE
+    gettimeofday(&t2, NULL);
+    elapsedTime = (t2.tv_sec - t1.tv_sec) * 1000.0;      // sec to ms
+    elapsedTime += (t2.tv_usec - t1.tv_usec) / 1000.0;   // us to ms
+    printf ("\tKernel Execution      :        %lf ms\n", elapsedTime);
+#endif
+}
+
+
+void ocl_set_num_threads(integer_array_t global_threads_in, integer_array_t local_threads_in){
+
+    WORK_DIM = global_threads_in.dim_size[0];
+
+    for (modelica_integer i=0; i < WORK_DIM; i++){
+        GLOBAL_SIZE[i] = (size_t)(*integer_array_element_addr_c99_1(&global_threads_in, 1, i+1));
+        LOCAL_SIZE[i] = (size_t)(*integer_array_element_addr_c99_1(&local_threads_in, 1, i+1));
+    }
+}
+
+void ocl_set_num_threads(modelica_integer global_threads_in, modelica_integer local_threads_in){
+
+    WORK_DIM = 1;
+    GLOBAL_SIZE[0] = global_threads_in;
+    LOCAL_SIZE[0] = local_threads_in;
+}
+
+void ocl_set_num_threads(modelica_integer global_threads_in){
+
+    WORK_DIM = 0;
+
+    if(global_threads_in == 0){
+        if (!device_comm_queue)
+            ocl_initialize();
+        GLOBAL_SIZE[0] = MAX_THREADS_WORKGROUP;
+    }
+    else
+        GLOBAL_SIZE[0] = global_threads_in;
+}
+
+modelica_integer ocl_get_num_threads(){
+
+    //TODO: fix to return the number of threads in each dimension
+    return 0;
+}
+
+
+void ocl_clean_up(){
+    if (device_comm_queue){
+        ocl_native_stop_pool();
+        device_comm_queue = NULL;
+    }
+}
+
+void ocl_error_check(int operation, cl_int error_code){
+    if (error_code != CL_SUCCESS)
+        printf("Error %d in native ParModelica operation %d\n", error_code, operation);
+}
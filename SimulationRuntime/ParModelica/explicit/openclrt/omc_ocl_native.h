@@ -0,0 +1,135 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+/*
+
+ Types and functions of the native ParModelica backend. If
+ OMC_OCL_NATIVE is defined this header replaces the OpenCL
+ headers. The OpenCL objects used by the generated code and by
+ omc_ocl_interface.cpp are replaced by plain host objects:
+   - a cl_mem is host memory, kernels work directly on it.
+   - a cl_kernel is a kernel compiled together with the model
+     (see omc_ocl_native_kernel.h) and its arguments.
+   - the command queue is a pool of threads on the host CPU.
+
+ This header is included by the host code and by the kernels
+ file. It must not depend on openmodelica.h.
+
+*/
+
+
+#ifndef _OMC_OCL_NATIVE_H
+#define _OMC_OCL_NATIVE_H
+
+#include <stddef.h>
+
+#if defined(_MSC_VER)
+  #define OCL_NATIVE_TLS __declspec(thread)
+#else
+  #define OCL_NATIVE_TLS __thread
+#endif
+
+// Number of iterations a parfor chunk is aligned to. Chunks of
+// a multiple of 8 elements start on a cache line for double and
+// 64 bit integer arrays and leave full vectors to the compiler.
+#define OCL_NATIVE_CHUNK_ALIGN 8
+
+
+typedef int cl_int;
+typedef unsigned int cl_uint;
+typedef unsigned long long cl_ulong;
+
+typedef struct _cl_mem* cl_mem;
+typedef struct _cl_kernel* cl_kernel;
+typedef struct _cl_program* cl_program;
+typedef struct _cl_context* cl_context;
+typedef struct _cl_device_id* cl_device_id;
+typedef struct _cl_command_queue* cl_command_queue;
+
+#define CL_SUCCESS 0
+
+
+enum ocl_native_arg_kind {OCL_NATIVE_ARG_NONE, OCL_NATIVE_ARG_POINTER, OCL_NATIVE_ARG_INTEGER,
+                          OCL_NATIVE_ARG_REAL, OCL_NATIVE_ARG_LOCAL};
+
+// A kernel argument as set by ocl_set_kernel_arg. For __local
+// arguments size is the requested size and pointer is set to the
+// local memory of the executing work group.
+typedef struct ocl_native_arg_s{
+ int kind;
+ size_t size;
+ union{
+  void* pointer;
+  long long integer;
+  double real;
+ } value;
+} ocl_native_arg;
+
+// Calls the kernel function with the arguments for the current work item.
+typedef void (*ocl_native_invoker)(const ocl_native_arg* args);
+
+// A kernel of the kernels file. Registered by OCL_NATIVE_KERNEL
+// when the program starts.
+typedef struct ocl_native_kernel_info_s{
+ const char* name;
+ ocl_native_invoker invoker;
+ int nr_of_args;
+ struct ocl_native_kernel_info_s* next;
+} ocl_native_kernel_info;
+
+// The ids of the work item executed by the calling thread.
+// Read by get_global_id() etc. in the kernels.
+typedef struct ocl_native_work_item_s{
+ unsigned int work_dim;
+ size_t global_id[3];
+ size_t local_id[3];
+ size_t group_id[3];
+ size_t global_size[3];
+ size_t local_size[3];
+ size_t num_groups[3];
+} ocl_native_work_item;
+
+extern OCL_NATIVE_TLS ocl_native_work_item ocl_native_current_item;
+
+
+// DEFINED IN: omc_ocl_native.cpp
+int ocl_native_register_kernel(ocl_native_kernel_info* info);
+
+// barrier() of a kernel. Work items of a work group run one after
+// the other on the same thread, so only work groups with a single
+// work item can synchronize. Exits otherwise.
+void ocl_native_barrier(int flags);
+
+cl_int clReleaseKernel(cl_kernel kernel);
+cl_int clReleaseMemObject(cl_mem memobj);
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+/*
+
+ Included by OCLRuntimeUtil.cl if the kernels file is compiled
+ with a C++ compiler for the native ParModelica backend
+ (-x c++ -DOMC_OCL_NATIVE). It maps the OpenCL C kernel language
+ used by the generated kernels to C++:
+   - the __ address space qualifiers are removed, all memory is host memory.
+   - the work item functions read the ids of the work item the
+     calling thread executes.
+   - OCL_NATIVE_KERNEL registers a kernel by name so that
+     ocl_create_kernel can find it.
+
+*/
+
+
+#ifndef _OMC_OCL_NATIVE_KERNEL_H
+#define _OMC_OCL_NATIVE_KERNEL_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "omc_ocl_native.h"
+
+#define PRINTF_AVAILABLE
+#define DOUBLE_PREC_AVAILABLE
+
+#define __kernel
+#define __global
+#define __local
+#define __constant const
+#define __private
+
+#define CLK_LOCAL_MEM_FENCE 1
+#define CLK_GLOBAL_MEM_FENCE 2
+#define barrier(flags) ocl_native_barrier(flags)
+
+
+inline unsigned int get_work_dim() {
+    return ocl_native_current_item.work_dim;
+}
+
+inline size_t get_global_id(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.global_id[dim] : 0;
+}
+
+inline size_t get_local_id(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.local_id[dim] : 0;
+}
+
+inline size_t get_group_id(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.group_id[dim] : 0;
+}
+
+inline size_t get_global_size(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.global_size[dim] : 1;
+}
+
+inline size_t get_local_size(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.local_size[dim] : 1;
+}
+
+inline size_t get_num_groups(unsigned int dim) {
+    return dim < 3 ? ocl_native_current_item.num_groups[dim] : 1;
+}
+
+
+// Number of iterations of the parfor loop start:step:stop the
+// current work item executes. The iterations are split into one
+// contiguous chunk per work item instead of the strided
+// distribution used by OpenCL, so each thread streams through its
+// own part of the arrays. *first is set to the first iteration.
+inline long ocl_native_parfor_chunk(long start, long step, long stop, long* first)
+{
+    long n, chunk, begin;
+    size_t work_items = get_global_size(0);
+
+    if (step == 0 || (step > 0 && stop < start) || (step < 0 && stop > start))
+        return 0;
+    n = (stop - start) / step + 1;
+
+    chunk = (long)((n + work_items - 1) / work_items);
+    chunk = (chunk + OCL_NATIVE_CHUNK_ALIGN - 1) / OCL_NATIVE_CHUNK_ALIGN * OCL_NATIVE_CHUNK_ALIGN;
+    begin = (long)get_global_id(0) * chunk;
+    if (begin >= n)
+        return 0;
+
+    *first = start + begin * step;
+    return (n - begin < chunk) ? n - begin : chunk;
+}
+
+#define OCL_PARFOR_RANGE_LOOP(i, start, step, stop) \
+    for (modelica_integer i = 0, i##_count = ocl_native_parfor_chunk(start, step, stop, &i); i##_count > 0; --i##_count, i += (step))
+
+
+// Converts a stored kernel argument to the type of the kernel parameter.
+template <typename T>
+struct ocl_native_arg_cast {
+    static T get(const ocl_native_arg& arg) {
+        return arg.kind == OCL_NATIVE_ARG_REAL ? (T)arg.value.real : (T)arg.value.integer;
+    }
+};
+
+template <typename T>
+struct ocl_native_arg_cast<T*> {
+    static T* get(const ocl_native_arg& arg) {
+        return (T*)arg.value.pointer;
+    }
+};
+
+template <int... I> struct ocl_native_indices {};
+
+template <int N, int... I>
+struct ocl_native_make_indices : ocl_native_make_indices<N - 1, N - 1, I...> {};
+
+template <int... I>
+struct ocl_native_make_indices<0, I...> {
+    typedef ocl_native_indices<I...> type;
+};
+
+template <typename... A, int... I>
+inline void ocl_native_call(void (*kernel)(A...), const ocl_native_arg* args, ocl_native_indices<I...>) {
+    kernel(ocl_native_arg_cast<A>::get(args[I])...);
+}
+
+template <typename... A>
+inline void ocl_native_invoke(void (*kernel)(A...), const ocl_native_arg* args) {
+    ocl_native_call(kernel, args, typename ocl_native_make_indices<sizeof...(A)>::type());
+}
+
+template <typename... A>
+inline int ocl_native_nr_of_args(void (*)(A...)) {
+    return (int)sizeof...(A);
+}
+
+#define OCL_NATIVE_KERNEL(name) \
+    static void ocl_native_invoke_##name(const ocl_native_arg* args) { ocl_native_invoke(name, args); } \
+    static ocl_native_kernel_info ocl_native_info_##name = {#name, ocl_native_invoke_##name, ocl_native_nr_of_args(name), NULL}; \
+    static int ocl_native_registered_##name = ocl_native_register_kernel(&ocl_native_info_##name);
+
+#endif
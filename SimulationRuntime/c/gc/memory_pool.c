@@ -220,15 +220,99 @@ omc_alloc_interface_t omc_alloc_interface = {
 #endif
 };
 
+typedef struct {
+  char *memory;
+  size_t size;
+  size_t used;
+  size_t highWaterMark;
+  unsigned long resets;
+  unsigned long overflows;
+  int active;
+} omc_arena;
+
+static omc_arena arena = {0};
+
+void omc_arena_init(size_t size)
+{
+  omc_arena_free();
+  arena.memory = (char*) malloc(size);
+  arena.size = arena.memory ? size : 0;
+}
+
+void omc_arena_free(void)
+{
+  free(arena.memory);
+  memset(&arena, 0, sizeof(omc_arena));
+}
+
+void omc_arena_activate(int active)
+{
+  arena.active = active && arena.memory;
+}
+
+int omc_arena_is_active(void)
+{
+  return arena.active;
+}
+
+void omc_arena_reset(void)
+{
+  if (!arena.active) {
+    return;
+  }
+  if (arena.used > arena.highWaterMark) {
+    arena.highWaterMark = arena.used;
+  }
+  arena.used = 0;
+  arena.resets++;
+}
+
+omc_arena_statistics omc_arena_get_statistics(void)
+{
+  omc_arena_statistics res;
+  res.size = arena.size;
+  res.highWaterMark = arena.used > arena.highWaterMark ? arena.used : arena.highWaterMark;
+  res.resets = arena.resets;
+  res.overflows = arena.overflows;
+  return res;
+}
+
+/* bump allocation in the arena; only for data without pointers, since the
+ * arena is not scanned by the garbage collector */
+static inline void* arena_malloc_atomic(size_t sz)
+{
+  void *res = NULL;
+  sz = round_up(sz ? sz : 1, 16);
+#if !defined(OMC_NO_THREADS)
+  pthread_mutex_lock(&memory_pool_mutex);
+#endif
+  if (arena.size - arena.used >= sz) {
+    res = arena.memory + arena.used;
+    arena.used += sz;
+  } else {
+    arena.overflows++;
+  }
+#if !defined(OMC_NO_THREADS)
+  pthread_mutex_unlock(&memory_pool_mutex);
+#endif
+  return res ? res : omc_alloc_interface.malloc_atomic(sz);
+}
+
 /* allocates n reals in the real_buffer */
 m_real* real_alloc(int n)
 {
+  if (arena.active) {
+    return (m_real*) arena_malloc_atomic(n*sizeof(m_real));
+  }
   return (m_real*) omc_alloc_interface.malloc_atomic(n*sizeof(m_real));
 }
 
 /* allocates n integers in the integer_buffer */
 m_integer* integer_alloc(int n)
 {
+  if (arena.active) {
+    return (m_integer*) arena_malloc_atomic(n*sizeof(m_integer));
+  }
   return (m_integer*) omc_alloc_interface.malloc_atomic(n*sizeof(m_integer));
 }
 
@@ -241,11 +325,17 @@ m_string* string_alloc(int n)
 /* allocates n booleans in the boolean_buffer */
 m_boolean* boolean_alloc(int n)
 {
+  if (arena.active) {
+    return (m_boolean*) arena_malloc_atomic(n*sizeof(m_boolean));
+  }
   return (m_boolean*) omc_alloc_interface.malloc_atomic(n*sizeof(m_boolean));
 }
 
 _index_t* size_alloc(int n)
 {
+  if (arena.active) {
+    return (_index_t*) arena_malloc_atomic(n*sizeof(_index_t));
+  }
   return (_index_t*) omc_alloc_interface.malloc(n*sizeof(_index_t));
 }
 
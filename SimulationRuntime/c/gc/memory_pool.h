@@ -48,6 +48,28 @@ extern _index_t** index_alloc(int n);
 
 void* generic_alloc(int n, size_t sze);
 
+/* Arena for array temporaries.
+ *
+ * While the arena is active, real_alloc, integer_alloc, boolean_alloc and
+ * size_alloc take their memory from one preallocated block by bumping a
+ * pointer. The solvers call omc_arena_reset at points where no array
+ * temporaries are alive (after each evaluation of the model equations and
+ * after each accepted step). If the arena is exhausted, the allocation falls
+ * back to the regular allocator and is counted as overflow. */
+typedef struct {
+  size_t size;            /* size of the arena in bytes */
+  size_t highWaterMark;   /* maximum number of bytes in use between two resets */
+  unsigned long resets;
+  unsigned long overflows;
+} omc_arena_statistics;
+
+extern void omc_arena_init(size_t size);
+extern void omc_arena_free(void);
+extern void omc_arena_activate(int active);
+extern int omc_arena_is_active(void);
+extern void omc_arena_reset(void);
+extern omc_arena_statistics omc_arena_get_statistics(void);
+
 #if defined(__cplusplus)
 } /* end extern "C" */
 #endif
@@ -44,12 +44,19 @@
 #include "util/omc_error.h"
 #include "meta/meta_modelica.h"
 #include "util/modelica_string.h"
+#include "util/omc_mmap.h"
 
 #include <limits.h>
 #include "util/uthash.h"
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <expat.h>
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 typedef struct hash_string_string
 {
@@ -343,6 +350,228 @@ static void XMLCALL endElement(void *userData, const char *name)
   /* do nothing! */
 }
 
+/*
+ * Binary cache of the parsed setup file (-initXmlCache).
+ *
+ * The cache contains all maps of omc_ModelInput as they are after parsing
+ * the XML file (i.e. before any override is applied). It is keyed by the
+ * size and a FNV-1a hash of the XML content and is rebuilt whenever they
+ * do not match.
+ *
+ * layout (all integers in native byte order):
+ *   header    : magic[8], version (u32), sizeof(long) (u32), xmlSize (u64), xmlHash (u64)
+ *   md, de    : nEntries (u32), nEntries * (string key, string value)
+ *   15 x vars : nVars (u32), nVars * (index (i64), nEntries (u32), nEntries * (string key, string value))
+ *   string    : length (u32), length bytes, '\0'
+ *
+ * On load the file is memory mapped and the hash nodes point directly into
+ * the mapped strings, so neither expat nor strdup is involved.
+ */
+#define OMC_INIT_CACHE_MAGIC "OMCINIT\0"
+#define OMC_INIT_CACHE_VERSION 1
+
+typedef struct {
+  const char *data;
+  size_t size;
+  size_t pos;
+  int fail;
+} omc_InitCacheReader;
+
+static omc_ModelVariables** initCacheVariableMaps(omc_ModelInput *mi, int i)
+{
+  omc_ModelVariables **maps[] = {&mi->rSta, &mi->rDer, &mi->rAlg, &mi->rPar, &mi->rAli, &mi->rSen,
+                                 &mi->iAlg, &mi->iPar, &mi->iAli,
+                                 &mi->bAlg, &mi->bPar, &mi->bAli,
+                                 &mi->sAlg, &mi->sPar, &mi->sAli};
+  return i < sizeof(maps)/sizeof(*maps) ? maps[i] : NULL;
+}
+
+static uint64_t initCacheHash(const char *data, size_t size)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  size_t i;
+  for (i = 0; i < size; i++) {
+    hash ^= (unsigned char) data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static void initCacheWriteString(FILE *file, const char *str)
+{
+  uint32_t len = strlen(str);
+  fwrite(&len, sizeof(len), 1, file);
+  fwrite(str, 1, len+1, file);
+}
+
+static void initCacheWriteMap(FILE *file, hash_string_string *ht)
+{
+  hash_string_string *c, *tmp;
+  uint32_t n = HASH_COUNT(ht);
+  fwrite(&n, sizeof(n), 1, file);
+  HASH_ITER(hh, ht, c, tmp) {
+    initCacheWriteString(file, c->id);
+    initCacheWriteString(file, c->val);
+  }
+}
+
+static void writeInitCache(omc_ModelInput *mi, const char *cacheFile, uint64_t xmlSize, uint64_t xmlHash)
+{
+  hash_long_var *c, *tmp;
+  uint32_t version = OMC_INIT_CACHE_VERSION, sizeofLong = sizeof(long), n;
+  omc_ModelVariables **vars;
+  char *tmpFile = NULL;
+  FILE *file;
+  int i, err;
+
+  if (0 > GC_asprintf(&tmpFile, "%s.%ld.tmp", cacheFile, (long) getpid())) {
+    return;
+  }
+  file = fopen(tmpFile, "wb");
+  if (!file) {
+    warningStreamPrint(LOG_SIMULATION, 0, "simulation_input_xml.c: could not create cache file %s", cacheFile);
+    return;
+  }
+  fwrite(OMC_INIT_CACHE_MAGIC, 1, 8, file);
+  fwrite(&version, sizeof(version), 1, file);
+  fwrite(&sizeofLong, sizeof(sizeofLong), 1, file);
+  fwrite(&xmlSize, sizeof(xmlSize), 1, file);
+  fwrite(&xmlHash, sizeof(xmlHash), 1, file);
+  initCacheWriteMap(file, mi->md);
+  initCacheWriteMap(file, mi->de);
+  for (i = 0; NULL != (vars = initCacheVariableMaps(mi, i)); i++) {
+    n = HASH_COUNT(*vars);
+    fwrite(&n, sizeof(n), 1, file);
+    HASH_ITER(hh, *vars, c, tmp) {
+      int64_t index = c->id;
+      fwrite(&index, sizeof(index), 1, file);
+      initCacheWriteMap(file, c->val);
+    }
+  }
+  err = ferror(file);
+  if (fclose(file) || err || rename(tmpFile, cacheFile)) {
+    /* another process may have created the cache in the meantime */
+    remove(tmpFile);
+    infoStreamPrint(LOG_SIMULATION, 0, "simulation_input_xml.c: could not write cache file %s", cacheFile);
+    return;
+  }
+  infoStreamPrint(LOG_SIMULATION, 0, "wrote setup file cache %s", cacheFile);
+}
+
+static const void* initCacheRead(omc_InitCacheReader *r, size_t n)
+{
+  const void *res;
+  if (r->fail || r->size - r->pos < n) {
+    r->fail = 1;
+    return NULL;
+  }
+  res = r->data + r->pos;
+  r->pos += n;
+  return res;
+}
+
+static uint32_t initCacheReadU32(omc_InitCacheReader *r)
+{
+  uint32_t res = 0;
+  const void *p = initCacheRead(r, sizeof(res));
+  if (p) {
+    memcpy(&res, p, sizeof(res));
+  }
+  return res;
+}
+
+static const char* initCacheReadString(omc_InitCacheReader *r)
+{
+  uint32_t len = initCacheReadU32(r);
+  const char *res = (const char*) initCacheRead(r, (size_t)len+1);
+  if (res && res[len] != '\0') {
+    r->fail = 1;
+  }
+  return r->fail ? NULL : res;
+}
+
+static hash_string_string* initCacheReadMap(omc_InitCacheReader *r)
+{
+  hash_string_string *ht = NULL, *nodes;
+  uint32_t i, n = initCacheReadU32(r);
+  if (r->fail || n == 0 || n > r->size) {
+    return NULL;
+  }
+  /* one block per map; the keys and values live in the mapped file */
+  nodes = (hash_string_string*) calloc(n, sizeof(hash_string_string));
+  for (i = 0; i < n && !r->fail; i++) {
+    nodes[i].id = initCacheReadString(r);
+    nodes[i].val = initCacheReadString(r);
+    if (!r->fail) {
+      HASH_ADD_KEYPTR(hh, ht, nodes[i].id, strlen(nodes[i].id), &nodes[i]);
+    }
+  }
+  return ht;
+}
+
+/* returns 1 if mi was populated from a valid cache, 0 otherwise */
+static int readInitCache(omc_ModelInput *mi, omc_mmap_read *map, const char *cacheFile, uint64_t xmlSize, uint64_t xmlHash)
+{
+  omc_InitCacheReader r = {0};
+  omc_ModelVariables **vars;
+  uint64_t cachedSize, cachedHash;
+  const void *p;
+  long fileSize;
+  int i;
+  FILE *file = fopen(cacheFile, "rb");
+
+  if (!file) {
+    return 0;
+  }
+  fseek(file, 0, SEEK_END);
+  fileSize = ftell(file);
+  fclose(file);
+  if (fileSize < 32) {
+    return 0;
+  }
+
+  *map = omc_mmap_open_read(cacheFile);
+  r.data = map->data;
+  r.size = map->size;
+
+  p = initCacheRead(&r, 8);
+  if (!p || memcmp(p, OMC_INIT_CACHE_MAGIC, 8) || initCacheReadU32(&r) != OMC_INIT_CACHE_VERSION || initCacheReadU32(&r) != sizeof(long)) {
+    r.fail = 1;
+  }
+  if (!r.fail) {
+    memcpy(&cachedSize, initCacheRead(&r, 8), 8);
+    memcpy(&cachedHash, initCacheRead(&r, 8), 8);
+    r.fail = cachedSize != xmlSize || cachedHash != xmlHash;
+  }
+  if (r.fail) {
+    omc_mmap_close_read(*map);
+    infoStreamPrint(LOG_SIMULATION, 0, "setup file cache %s is outdated", cacheFile);
+    return 0;
+  }
+
+  mi->md = initCacheReadMap(&r);
+  mi->de = initCacheReadMap(&r);
+  for (i = 0; !r.fail && NULL != (vars = initCacheVariableMaps(mi, i)); i++) {
+    uint32_t j, n = initCacheReadU32(&r);
+    for (j = 0; j < n && !r.fail; j++) {
+      int64_t index = 0;
+      if (NULL != (p = initCacheRead(&r, sizeof(index)))) {
+        memcpy(&index, p, sizeof(index));
+        addHashLongVar(vars, (long) index, initCacheReadMap(&r));
+      }
+    }
+  }
+  if (r.fail) {
+    /* the tables are partially filled; leak them like the XML path does on error */
+    memset(mi, 0, sizeof(omc_ModelInput));
+    omc_mmap_close_read(*map);
+    warningStreamPrint(LOG_SIMULATION, 0, "simulation_input_xml.c: setup file cache %s is corrupt, ignoring it", cacheFile);
+    return 0;
+  }
+  infoStreamPrint(LOG_SIMULATION, 0, "read setup file cache %s", cacheFile);
+  return 1;
+}
+
 static void read_var_info(omc_ScalarVariable *v, VAR_INFO *info)
 {
   modelica_integer inputIndex;
@@ -422,8 +651,12 @@ void read_input_xml(MODEL_DATA* modelData,
 {
   omc_ModelInput mi = {0};
   const char *filename, *guid, *override, *overrideFile;
+  char *cacheFile = NULL;
   FILE* file = NULL;
   XML_Parser parser = NULL;
+  omc_mmap_read xmlMap = {0}, cacheMap = {0};
+  uint64_t xmlHash = 0;
+  int useCache = 0, cacheHit = 0;
   hash_string_long *mapAlias = NULL, *mapAliasParam = NULL, *mapAliasSen = NULL;
   long *it, *itParam;
   mmc_sint_t i;
@@ -453,46 +686,92 @@ void read_input_xml(MODEL_DATA* modelData,
     if(!file) {
       throwStreamPrint(NULL, "simulation_input_xml.c: Error: can not read file %s as setup file to the generated simulation code.",filename);
     }
+
+    useCache = omc_flag[FLAG_INIT_XML_CACHE];
+    if(useCache)
+    {
+      /* the cache is keyed by the file content; map it once for hashing and (on a miss) parsing */
+      fclose(file);
+      file = NULL;
+      xmlMap = omc_mmap_open_read(filename);
+      xmlHash = initCacheHash(xmlMap.data, xmlMap.size);
+      if (0 > GC_asprintf(&cacheFile, "%s.cache", filename)) {
+        throwStreamPrint(NULL, "simulation_input_xml.c: Error: can not allocate memory.");
+      }
+      cacheHit = readInitCache(&mi, &cacheMap, cacheFile, xmlMap.size, xmlHash);
+    }
   }
-  /* create the XML parser */
-  parser = XML_ParserCreate(NULL);
-  if(!parser)
-  {
-    fclose(file);
-    throwStreamPrint(NULL, "simulation_input_xml.c: Error: couldn't allocate memory for the XML parser!");
-  }
-  /* set our user data */
-  XML_SetUserData(parser, &mi);
-  /* set the handlers for start/end of element. */
-  XML_SetElementHandler(parser, startElement, endElement);
-  if(NULL == modelData->initXMLData)
+
+  if(!cacheHit)
   {
-    int done;
-    char buf[BUFSIZ] = {0};
-    do
+    /* create the XML parser */
+    parser = XML_ParserCreate(NULL);
+    if(!parser)
     {
-      size_t len = fread(buf, 1, sizeof(buf), file);
-      done = len < sizeof(buf);
-      if(XML_STATUS_ERROR == XML_Parse(parser, buf, len, done))
-      {
+      if(file) {
         fclose(file);
+      }
+      throwStreamPrint(NULL, "simulation_input_xml.c: Error: couldn't allocate memory for the XML parser!");
+    }
+    /* set our user data */
+    XML_SetUserData(parser, &mi);
+    /* set the handlers for start/end of element. */
+    XML_SetElementHandler(parser, startElement, endElement);
+    if(useCache)
+    {
+      if(XML_STATUS_ERROR == XML_Parse(parser, xmlMap.data, xmlMap.size, 1))
+      {
         warningStreamPrint(LOG_STDOUT, 0, "simulation_input_xml.c: Error: failed to read the XML file %s: %s at line %lu\n",
             filename,
             XML_ErrorString(XML_GetErrorCode(parser)),
             XML_GetCurrentLineNumber(parser));
         XML_ParserFree(parser);
+        omc_mmap_close_read(xmlMap);
         throwStreamPrint(NULL, "see last warning");
       }
-    }while(!done);
-    fclose(file);
-  } else if(XML_STATUS_ERROR == XML_Parse(parser, modelData->initXMLData, strlen(modelData->initXMLData), 1)) { /* Got the full string already */
-    fprintf(stderr, "%s, %s %lu\n", modelData->initXMLData, XML_ErrorString(XML_GetErrorCode(parser)), XML_GetCurrentLineNumber(parser));
-    warningStreamPrint(LOG_STDOUT, 0, "simulation_input_xml.c: Error: failed to read the XML data %s: %s at line %lu\n",
-             modelData->initXMLData,
-             XML_ErrorString(XML_GetErrorCode(parser)),
-             XML_GetCurrentLineNumber(parser));
+    }
+    else if(NULL == modelData->initXMLData)
+    {
+      int done;
+      char buf[BUFSIZ] = {0};
+      do
+      {
+        size_t len = fread(buf, 1, sizeof(buf), file);
+        done = len < sizeof(buf);
+        if(XML_STATUS_ERROR == XML_Parse(parser, buf, len, done))
+        {
+          fclose(file);
+          warningStreamPrint(LOG_STDOUT, 0, "simulation_input_xml.c: Error: failed to read the XML file %s: %s at line %lu\n",
+              filename,
+              XML_ErrorString(XML_GetErrorCode(parser)),
+              XML_GetCurrentLineNumber(parser));
+          XML_ParserFree(parser);
+          throwStreamPrint(NULL, "see last warning");
+        }
+      }while(!done);
+      fclose(file);
+    } else if(XML_STATUS_ERROR == XML_Parse(parser, modelData->initXMLData, strlen(modelData->initXMLData), 1)) { /* Got the full string already */
+      fprintf(stderr, "%s, %s %lu\n", modelData->initXMLData, XML_ErrorString(XML_GetErrorCode(parser)), XML_GetCurrentLineNumber(parser));
+      warningStreamPrint(LOG_STDOUT, 0, "simulation_input_xml.c: Error: failed to read the XML data %s: %s at line %lu\n",
+               modelData->initXMLData,
+               XML_ErrorString(XML_GetErrorCode(parser)),
+               XML_GetCurrentLineNumber(parser));
+      XML_ParserFree(parser);
+      throwStreamPrint(NULL, "see last warning");
+    }
+    /* all attributes are copied into mi, the parser is not needed anymore */
     XML_ParserFree(parser);
-    throwStreamPrint(NULL, "see last warning");
+
+    if(useCache)
+    {
+      omc_mmap_close_read(xmlMap);
+      /* store the maps before any override is applied */
+      writeInitCache(&mi, cacheFile, xmlMap.size, xmlHash);
+    }
+  }
+  else
+  {
+    omc_mmap_close_read(xmlMap);
   }
 
   /* now we should have all the data inside omc_ModelInput mi. */
@@ -506,7 +785,6 @@ void read_input_xml(MODEL_DATA* modelData,
         modelData->modelGUID,
         filename);
   } else if (strcmp(modelData->modelGUID, guid)) {
-    XML_ParserFree(parser);
     warningStreamPrint(LOG_STDOUT, 0, "Error, the GUID: %s from input data file: %s does not match the GUID compiled in the model: %s",
         guid,
         filename,
@@ -584,7 +862,6 @@ void read_input_xml(MODEL_DATA* modelData,
       warningStreamPrint(LOG_SIMULATION, 0, "nystr in setup file: %ld from model code: %ld", nystrchk, modelData->nVariablesString);
       messageClose(LOG_SIMULATION);
     }
-    XML_ParserFree(parser);
     EXIT(-1);
   }
 
@@ -821,7 +1098,10 @@ void read_input_xml(MODEL_DATA* modelData,
   }
   messageClose(LOG_DEBUG);
 
-  XML_ParserFree(parser);
+  if(cacheHit) {
+    /* all values are copied into modelData, release the mapped cache */
+    omc_mmap_close_read(cacheMap);
+  }
 }
 
 /* reads modelica_string value from a string */
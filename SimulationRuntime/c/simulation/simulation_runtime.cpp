@@ -60,6 +60,7 @@
 #endif
 
 #include "util/omc_error.h"
+#include "util/omc_log_async.h"
 #include "simulation_data.h"
 #include "openmodelica_func.h"
 #include "meta/meta_modelica.h"
@@ -823,6 +824,13 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
   }
 
   setGlobalVerboseLevel(argc, argv);
+  if(omc_flag[FLAG_LV_ASYNC]) {
+    if(omc_log_async_start(atol(omc_flagValue[FLAG_LV_ASYNC]))) {
+      warningStreamPrint(LOG_STDOUT, 0, "Asynchronous logging is not available, -lvAsync is ignored.");
+    } else {
+      atexit(omc_log_async_stop);
+    }
+  }
   initializeDataStruc(data, threadData);
   if(!data)
   {
@@ -956,6 +964,8 @@ int _main_SimulationRuntime(int argc, char**argv, DATA *data, threadData_t *thre
     fflush(NULL);
   MMC_CATCH_INTERNAL(globalJumpBuffer)
 
+  omc_log_async_stop();
+
 #ifndef NO_INTERACTIVE_DEPENDENCY
   if(sim_communication_port_open)
   {
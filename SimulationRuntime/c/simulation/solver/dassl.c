@@ -818,6 +818,7 @@ int functionODE_residual(double *t, double *y, double *yd, double* cj, double *d
 
   /* eval input vars */
   data->callback->functionODE(data, threadData);
+  omc_arena_reset();
 
   /* get the difference between the temp_xd(=localData->statesDerivatives)
      and xd(=statesDerivativesBackup) */
@@ -893,6 +894,7 @@ int functionDAE_residual(double *t, double *y, double *yd, double* cj, double *d
 
   /* eval residual vars */
   data->simulationInfo->daeModeData->evaluateDAEResiduals(data, threadData);
+  omc_arena_reset();
 
   /* get data->simulationInfo->residualVars  */
   for(i=0; i < data->simulationInfo->daeModeData->nResidualVars; i++)
@@ -991,6 +991,7 @@ int residualFunctionIDA(double time, N_Vector yy, N_Vector yp, N_Vector res, voi
   {
     /* eval residual vars */
     data->simulationInfo->daeModeData->evaluateDAEResiduals(data, threadData);
+    omc_arena_reset();
     /* get residual variables */
     for(i=0; i < idaData->N; i++)
     {
@@ -1001,6 +1002,7 @@ int residualFunctionIDA(double time, N_Vector yy, N_Vector yp, N_Vector res, voi
   {
     /* eval function ODE */
     data->callback->functionODE(data, threadData);
+    omc_arena_reset();
     for(i=0; i < idaData->N; i++)
     {
         NV_Ith_S(res, i) = data->localData[0]->realVars[data->modelData->nStates + i] - NV_Ith_S(yp, i);
@@ -217,7 +217,11 @@ int prefixedName_performQSSSimulation(DATA* data, threadData_t *threadData, SOLV
   uinteger k = 0, j = 0;
 
     threadData->currentErrorStage = ERROR_SIMULATION;
-    omc_alloc_interface.collect_a_little();
+    if (omc_arena_is_active()) {
+      omc_arena_reset();
+    } else {
+      omc_alloc_interface.collect_a_little();
+    }
 
 #if !defined(OMC_EMCC)
     /* try */
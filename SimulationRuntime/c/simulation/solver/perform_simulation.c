@@ -358,7 +358,12 @@ int prefixedName_performSimulation(DATA* data, threadData_t *threadData, SOLVER_
     }
 #endif
 
-    omc_alloc_interface.collect_a_little();
+    /* array temporaries of the last step are dead now */
+    if (omc_arena_is_active()) {
+      omc_arena_reset();
+    } else {
+      omc_alloc_interface.collect_a_little();
+    }
 
     /* try */
 #if !defined(OMC_EMCC)
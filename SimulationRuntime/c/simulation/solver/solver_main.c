@@ -95,6 +95,32 @@ static int ipopt_step(DATA* data, threadData_t *threadData, SOLVER_INFO* solverI
 
 static void writeOutputVars(char* names, DATA* data);
 
+/*! \fn initArena
+ *
+ *  Allocates and activates the arena for array temporaries if the
+ *  simulation flag -arena is given. The arena is only used during the
+ *  integration, i.e. after the initialization of the model.
+ */
+static void initArena()
+{
+  double size;
+
+  if (!omc_flag[FLAG_ARENA]) {
+    return;
+  }
+  size = atof(omc_flagValue[FLAG_ARENA]);
+  if (size <= 0) {
+    return;
+  }
+  omc_arena_init((size_t) (size * 1024 * 1024));
+  if (omc_arena_get_statistics().size == 0) {
+    warningStreamPrint(LOG_STDOUT, 0, "Could not allocate the arena for array temporaries (%g MB). Continue without it.", size);
+    return;
+  }
+  infoStreamPrint(LOG_SOLVER, 0, "Using an arena of %g MB for array temporaries", size);
+  omc_arena_activate(1);
+}
+
 int solver_main_step(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo)
 {
   TRACE_PUSH
@@ -586,6 +612,17 @@ int finishSimulation(DATA* data, threadData_t *threadData, SOLVER_INFO* solverIn
     infoStreamPrint(LOG_STATS, 0, "%5ld time events", solverInfo->sampleEvents);
     messageClose(LOG_STATS);
 
+    if(omc_flag[FLAG_ARENA])
+    {
+      omc_arena_statistics arenaStats = omc_arena_get_statistics();
+      infoStreamPrint(LOG_STATS, 1, "arena for array temporaries");
+      infoStreamPrint(LOG_STATS, 0, "%12lu bytes size", (unsigned long) arenaStats.size);
+      infoStreamPrint(LOG_STATS, 0, "%12lu bytes maximum in use", (unsigned long) arenaStats.highWaterMark);
+      infoStreamPrint(LOG_STATS, 0, "%12lu resets", arenaStats.resets);
+      infoStreamPrint(LOG_STATS, 0, "%12lu overflows", arenaStats.overflows);
+      messageClose(LOG_STATS);
+    }
+
     if(S_OPTIMIZATION == solverInfo->solverMethod || /* skip solver statistics for optimization */
        S_QSS == solverInfo->solverMethod) /* skip also for qss, since not available*/
     {
@@ -748,7 +785,9 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
       overwriteOldSimulationData(data);
 
       infoStreamPrint(LOG_SOLVER, 0, "Start numerical integration (startTime: %g, stopTime: %g)", simInfo->startTime, simInfo->stopTime);
+      initArena();
       retVal = data->callback->performQSSSimulation(data, threadData, &solverInfo);
+      omc_arena_activate(0);
       omc_alloc_interface.collect_a_little();
 
       /* terminate the simulation */
@@ -769,7 +808,9 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
       storeOldValues(data);
 
       infoStreamPrint(LOG_SOLVER, 0, "Start numerical solver from %g to %g", simInfo->startTime, simInfo->stopTime);
+      initArena();
       retVal = data->callback->performSimulation(data, threadData, &solverInfo);
+      omc_arena_activate(0);
       omc_alloc_interface.collect_a_little();
       /* terminate the simulation */
       if (solverInfo.solverMethod == S_SYM_IMP_EULER) data->callback->symEulerUpdate(data, 0);
@@ -791,6 +832,7 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
 #if !defined(OMC_EMCC)
     MMC_CATCH_INTERNAL(simulationJumpBuffer)
 #endif
+  omc_arena_activate(0);
 
   /*  free external input data */
   externalInputFree(data);
@@ -800,6 +842,7 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
   {
     freeSolverData(data, &solverInfo);
   }
+  omc_arena_free();
 
   TRACE_POP
   return retVal;
@@ -0,0 +1,340 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "omc_log_async.h"
+#include "omc_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(OMC_NO_THREADS) && (defined(__GNUC__) || defined(__clang__))
+#define OMC_LOG_ASYNC_SUPPORTED 1
+#include <pthread.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(OMC_LOG_ASYNC_SUPPORTED)
+
+#define LOG_ASYNC_MSG_SIZE 2048
+
+#define LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define CAS(x, expected, desired) __atomic_compare_exchange_n(&(x), &(expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define INC(x, v) __atomic_fetch_add(&(x), (v), __ATOMIC_ACQ_REL)
+
+typedef enum {
+  LOG_ENTRY_MESSAGE,
+  LOG_ENTRY_CLOSE,
+  LOG_ENTRY_CLOSE_WARNING
+} LOG_ENTRY_KIND;
+
+typedef struct {
+  int kind;
+  int type;
+  int stream;
+  int indentNext;
+  int subline;
+  const int *indexes; /* equation indexes are static data of the generated code */
+  char msg[LOG_ASYNC_MSG_SIZE];
+} log_entry;
+
+/* head is only written by the producer, tail by the consumer and by the
+ * producer when it drops the oldest entry */
+typedef struct log_ring_s {
+  log_entry *entries;
+  unsigned long head;
+  unsigned long tail;
+  struct log_ring_s *next;
+} log_ring;
+
+static struct {
+  int running;
+  unsigned long ringSize;
+  log_ring *rings;          /* prepend-only list of all rings */
+  pthread_mutex_t ringsMutex;
+  pthread_key_t ringKey;
+  pthread_t thread;
+  unsigned long pushed;
+  unsigned long done;       /* written or dropped */
+  unsigned long dropped;
+  void (*message)(int type, int stream, int indentNext, char *msg, int subline, const int *indexes);
+  void (*close)(int stream);
+  void (*closeWarning)(int stream);
+} logAsync = {0, 0, NULL, PTHREAD_MUTEX_INITIALIZER};
+
+static void logAsyncSleep()
+{
+#if defined(_WIN32)
+  Sleep(1);
+#else
+  struct timespec ts = {0, 200000};
+  nanosleep(&ts, NULL);
+#endif
+}
+
+static log_ring* getRing()
+{
+  log_ring *ring = (log_ring*) pthread_getspecific(logAsync.ringKey);
+  if (ring) {
+    return ring;
+  }
+  ring = (log_ring*) calloc(1, sizeof(log_ring));
+  if (!ring) {
+    return NULL;
+  }
+  ring->entries = (log_entry*) malloc(logAsync.ringSize * sizeof(log_entry));
+  if (!ring->entries) {
+    free(ring);
+    return NULL;
+  }
+  pthread_mutex_lock(&logAsync.ringsMutex);
+  ring->next = logAsync.rings;
+  STORE(logAsync.rings, ring);
+  pthread_mutex_unlock(&logAsync.ringsMutex);
+  pthread_setspecific(logAsync.ringKey, ring);
+  return ring;
+}
+
+static void push(int kind, int type, int stream, int indentNext, const char *msg, int subline, const int *indexes)
+{
+  log_ring *ring = getRing();
+  unsigned long head, tail;
+  log_entry *entry;
+
+  if (!ring) {
+    /* out of memory; keep the message order of this thread at least */
+    omc_log_async_flush();
+    switch (kind) {
+    case LOG_ENTRY_MESSAGE: logAsync.message(type, stream, indentNext, (char*) msg, subline, indexes); break;
+    case LOG_ENTRY_CLOSE: logAsync.close(stream); break;
+    default: logAsync.closeWarning(stream); break;
+    }
+    return;
+  }
+
+  INC(logAsync.pushed, 1);
+  head = ring->head;
+  tail = LOAD(ring->tail);
+  if (head - tail >= logAsync.ringSize) {
+    /* full: drop the oldest entry, unless the consumer just took it */
+    if (CAS(ring->tail, tail, tail+1)) {
+      INC(logAsync.dropped, 1);
+      INC(logAsync.done, 1);
+    }
+  }
+
+  entry = ring->entries + head % logAsync.ringSize;
+  entry->kind = kind;
+  entry->type = type;
+  entry->stream = stream;
+  entry->indentNext = indentNext;
+  entry->subline = subline;
+  entry->indexes = indexes;
+  if (msg) {
+    strncpy(entry->msg, msg, LOG_ASYNC_MSG_SIZE-1);
+    entry->msg[LOG_ASYNC_MSG_SIZE-1] = '\0';
+  }
+  STORE(ring->head, head+1);
+
+  if (stream == LOG_ASSERT || type == LOG_TYPE_ERROR) {
+    omc_log_async_flush();
+  }
+}
+
+static void messageAsync(int type, int stream, int indentNext, char *msg, int subline, const int *indexes)
+{
+  push(LOG_ENTRY_MESSAGE, type, stream, indentNext, msg, subline, indexes);
+}
+
+static void messageCloseAsync(int stream)
+{
+  push(LOG_ENTRY_CLOSE, LOG_TYPE_UNKNOWN, stream, 0, NULL, 0, NULL);
+}
+
+static void messageCloseWarningAsync(int stream)
+{
+  push(LOG_ENTRY_CLOSE_WARNING, LOG_TYPE_UNKNOWN, stream, 0, NULL, 0, NULL);
+}
+
+/* takes one entry out of the ring and writes it; returns 0 if the ring is empty */
+static int pop(log_ring *ring)
+{
+  static log_entry entry;
+  unsigned long tail = LOAD(ring->tail);
+
+  while (tail != LOAD(ring->head)) {
+    const log_entry *src = ring->entries + tail % logAsync.ringSize;
+    entry.kind = src->kind;
+    entry.type = src->type;
+    entry.stream = src->stream;
+    entry.indentNext = src->indentNext;
+    entry.subline = src->subline;
+    entry.indexes = src->indexes;
+    if (entry.kind == LOG_ENTRY_MESSAGE) {
+      strncpy(entry.msg, src->msg, LOG_ASYNC_MSG_SIZE);
+      entry.msg[LOG_ASYNC_MSG_SIZE-1] = '\0';
+    }
+    /* if the producer dropped the entry meanwhile, the copy may be torn */
+    if (!CAS(ring->tail, tail, tail+1)) {
+      continue;
+    }
+    switch (entry.kind) {
+    case LOG_ENTRY_MESSAGE: logAsync.message(entry.type, entry.stream, entry.indentNext, entry.msg, entry.subline, entry.indexes); break;
+    case LOG_ENTRY_CLOSE: logAsync.close(entry.stream); break;
+    default: logAsync.closeWarning(entry.stream); break;
+    }
+    INC(logAsync.done, 1);
+    return 1;
+  }
+  return 0;
+}
+
+static int drain()
+{
+  int n = 0;
+  log_ring *ring;
+  for (ring = LOAD(logAsync.rings); ring; ring = ring->next) {
+    n += pop(ring);
+  }
+  return n;
+}
+
+static void* logAsyncThread(void *arg)
+{
+  while (LOAD(logAsync.running)) {
+    if (!drain()) {
+      logAsyncSleep();
+    }
+  }
+  while (drain());
+  return NULL;
+}
+
+int omc_log_async_start(unsigned long ringSize)
+{
+  if (logAsync.running) {
+    return 0;
+  }
+  if (pthread_key_create(&logAsync.ringKey, NULL)) {
+    return 1;
+  }
+  logAsync.ringSize = ringSize > 0 ? ringSize : 1;
+  logAsync.pushed = 0;
+  logAsync.done = 0;
+  logAsync.dropped = 0;
+  logAsync.message = messageFunction;
+  logAsync.close = messageClose;
+  logAsync.closeWarning = messageCloseWarning;
+  logAsync.running = 1;
+  if (pthread_create(&logAsync.thread, NULL, logAsyncThread, NULL)) {
+    logAsync.running = 0;
+    pthread_key_delete(logAsync.ringKey);
+    return 1;
+  }
+  messageFunction = messageAsync;
+  messageClose = messageCloseAsync;
+  messageCloseWarning = messageCloseWarningAsync;
+  return 0;
+}
+
+void omc_log_async_stop(void)
+{
+  log_ring *ring;
+
+  if (!logAsync.running) {
+    return;
+  }
+  STORE(logAsync.running, 0);
+  pthread_join(logAsync.thread, NULL);
+
+  messageFunction = logAsync.message;
+  messageClose = logAsync.close;
+  messageCloseWarning = logAsync.closeWarning;
+
+  while ((ring = logAsync.rings)) {
+    logAsync.rings = ring->next;
+    free(ring->entries);
+    free(ring);
+  }
+  pthread_key_delete(logAsync.ringKey);
+
+  if (logAsync.dropped) {
+    warningStreamPrint(LOG_STDOUT, 0, "%lu log messages were dropped because the logging buffer was full. Use a larger value for -lvAsync.", logAsync.dropped);
+  }
+}
+
+void omc_log_async_flush(void)
+{
+  if (!LOAD(logAsync.running) || pthread_equal(pthread_self(), logAsync.thread)) {
+    return;
+  }
+  while (LOAD(logAsync.done) < LOAD(logAsync.pushed)) {
+    logAsyncSleep();
+  }
+}
+
+unsigned long omc_log_async_dropped(void)
+{
+  return LOAD(logAsync.dropped);
+}
+
+#else
+
+int omc_log_async_start(unsigned long ringSize)
+{
+  return 1;
+}
+
+void omc_log_async_stop(void)
+{
+}
+
+void omc_log_async_flush(void)
+{
+}
+
+unsigned long omc_log_async_dropped(void)
+{
+  return 0;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Asynchronous backend for the omc_error streams.
+ *
+ * omc_log_async_start replaces messageFunction, messageClose and
+ * messageCloseWarning by functions that only copy the formatted message into
+ * a bounded ring of the calling thread. A background thread takes the
+ * messages out of the rings and passes them to the previous message functions
+ * (text, xml or xmltcp), so printing, escaping and flushing no longer happen
+ * on the simulation thread.
+ *
+ * The rings are single-producer/single-consumer and lock-free. If a ring is
+ * full, the oldest message is dropped and counted. Messages of type error and
+ * messages to LOG_ASSERT wait until everything before them has been written,
+ * so nothing is lost when the simulation aborts afterwards.
+ */
+
+#ifndef OMC_LOG_ASYNC_H
+#define OMC_LOG_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Starts the background thread; ringSize is the number of messages per thread.
+ * Returns 0 on success. */
+extern int omc_log_async_start(unsigned long ringSize);
+/* Writes all pending messages, stops the background thread and restores the
+ * previous message functions. Must not be called while other threads log. */
+extern void omc_log_async_stop(void);
+/* Waits until all messages logged so far have been written. */
+extern void omc_log_async_flush(void);
+/* Number of messages dropped because a ring was full. */
+extern unsigned long omc_log_async_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -35,6 +35,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include "read_matlab4.h"
+#include "omc_mmap.h"
 
 extern const char *omc_mat_Aclass;
 
@@ -108,6 +109,13 @@ int mat_element_length(int type)
 void omc_free_matlab4_reader(ModelicaMatReader *reader)
 {
   unsigned int i;
+#if HAVE_MMAP
+  if (reader->mapData) {
+    munmap(reader->mapData, reader->mapSize);
+    reader->mapData = NULL;
+    reader->data_2 = NULL;
+  }
+#endif
   if (reader->file) {
     fclose(reader->file);
     reader->file = 0;
@@ -137,6 +145,32 @@ void omc_free_matlab4_reader(ModelicaMatReader *reader)
     free(reader->vars);
     reader->vars=NULL;
   }
+  if (reader->varLastUse) {
+    free(reader->varLastUse);
+    reader->varLastUse=NULL;
+  }
+}
+
+/* Maps the data_2 matrix into memory so that single variables can be read
+ * without seeking; keeps using the FILE* if that is not possible */
+static void map_data_2(ModelicaMatReader *reader, size_t matrix_length)
+{
+#if HAVE_MMAP
+  struct stat s;
+  size_t size = reader->var_offset + matrix_length;
+  void *data;
+  if (matrix_length == 0 || fstat(fileno(reader->file), &s) < 0 || (size_t) s.st_size < size) {
+    /* do not map a file that is still being written */
+    return;
+  }
+  data = mmap(0, size, PROT_READ, MAP_SHARED, fileno(reader->file), 0);
+  if (data == MAP_FAILED) {
+    return;
+  }
+  reader->mapData = data;
+  reader->mapSize = size;
+  reader->data_2 = (const char*) data + reader->var_offset;
+#endif
 }
 
 void remSpaces(char *ch){
@@ -404,6 +438,7 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
         reader->nvar = hdr.mrows;
         reader->var_offset = ftell(reader->file);
         reader->vars = (double**) calloc(reader->nvar*2,sizeof(double*));
+        map_data_2(reader, matrix_length);
         if(-1==fseek(reader->file,matrix_length,SEEK_CUR)) return "Corrupt header: data_2 matrix";
       }
       if(binTrans==0) {
@@ -414,6 +449,7 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
         reader->nvar = hdr.ncols;
         reader->var_offset = ftell(reader->file);
         reader->vars = (double**) calloc(reader->nvar*2,sizeof(double*));
+        reader->preloaded = 1;
         if(reader->doublePrecision==1)
         {
           double *tmp=NULL;
@@ -540,6 +576,60 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
   return res;
 }
 
+/* reads the value of variable absVarIndex (1-based) at row i from the mapped data_2 */
+static OMC_INLINE double mapped_val(ModelicaMatReader *reader, size_t absVarIndex, size_t i)
+{
+  size_t k = i*reader->nvar + absVarIndex-1;
+  if(reader->doublePrecision==1) {
+    double d;
+    memcpy(&d, reader->data_2 + k*sizeof(double), sizeof(double));
+    return d;
+  } else {
+    float f;
+    memcpy(&f, reader->data_2 + k*sizeof(float), sizeof(float));
+    return f;
+  }
+}
+
+/* Releases least recently used columns until another one fits into the cache */
+static void release_cached_vars(ModelicaMatReader *reader)
+{
+  while(reader->maxCachedVars > 0 && reader->nCachedVars >= reader->maxCachedVars) {
+    unsigned int i, lru = 0;
+    /* the time column is needed for every interpolation; never release it */
+    for(i=1; i<reader->nvar*2; i++) {
+      if(reader->vars[i] && (!lru || reader->varLastUse[i] < reader->varLastUse[lru])) {
+        lru = i;
+      }
+    }
+    if(!lru) {
+      return;
+    }
+    free(reader->vars[lru]);
+    reader->vars[lru] = NULL;
+    reader->nCachedVars--;
+    reader->readAll = 0;
+  }
+}
+
+void omc_matlab4_set_cache_size(ModelicaMatReader *reader, int maxVars)
+{
+  unsigned int i;
+  if(reader->preloaded) {
+    /* the columns cannot be read back with the transposed layout; keep them all */
+    return;
+  }
+  if(!reader->varLastUse && reader->nvar) {
+    reader->varLastUse = (unsigned long*) calloc(reader->nvar*2, sizeof(unsigned long));
+  }
+  reader->maxCachedVars = maxVars;
+  reader->nCachedVars = 0;
+  for(i=0; i<reader->nvar*2; i++) {
+    if(reader->vars[i]) reader->nCachedVars++;
+  }
+  release_cached_vars(reader);
+}
+
 /* Writes the number of values in the returned array if nvals is non-NULL */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
 {
@@ -548,8 +638,23 @@ double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
   assert(absVarIndex > 0 && absVarIndex <= reader->nvar);
   if(!reader->vars[ix]) {
     unsigned int i;
-    double *tmp = (double*) malloc(reader->nrows*sizeof(double));
-    if(reader->doublePrecision==1)
+    double *tmp;
+    release_cached_vars(reader);
+    tmp = (double*) malloc(reader->nrows*sizeof(double));
+    if(reader->data_2)
+    {
+      /* strided gather from the mapped file */
+      for(i=0; i<reader->nrows; i++) {
+        tmp[i] = mapped_val(reader, absVarIndex, i);
+      }
+      if(varIndex < 0)
+      {
+        for(i=0; i<reader->nrows; i++) {
+          tmp[i] = -tmp[i];
+        }
+      }
+    }
+    else if(reader->doublePrecision==1)
     {
       for(i=0; i<reader->nrows; i++) {
         fseek(reader->file,reader->var_offset + sizeof(double)*(i*reader->nvar + absVarIndex-1), SEEK_SET);
@@ -592,6 +697,10 @@ double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
       /* fprintf(stderr, "tmp[%d]=%g\n", i, tmp[i]); */
     }
     reader->vars[ix] = tmp;
+    reader->nCachedVars++;
+  }
+  if(reader->varLastUse) {
+    reader->varLastUse[ix] = ++reader->useCounter;
   }
   return reader->vars[ix];
 }
@@ -660,10 +769,14 @@ int omc_matlab4_read_all_vals(ModelicaMatReader *reader)
   if (!tmp) {
     return 1;
   }
-  fseek(reader->file, reader->var_offset, SEEK_SET);
-  if (nvar*reader->nrows != fread(tmp, reader->doublePrecision==1 ? sizeof(double) : sizeof(float), nvar*nrows, reader->file)) {
-    free(tmp);
-    return 1;
+  if (reader->data_2) {
+    memcpy(tmp, reader->data_2, (reader->doublePrecision==1 ? sizeof(double) : sizeof(float))*nvar*nrows);
+  } else {
+    fseek(reader->file, reader->var_offset, SEEK_SET);
+    if (nvar*reader->nrows != fread(tmp, reader->doublePrecision==1 ? sizeof(double) : sizeof(float), nvar*nrows, reader->file)) {
+      free(tmp);
+      return 1;
+    }
   }
   if(reader->doublePrecision != 1) {
     for (i=nvar*nrows-1; i>=0; i--) {
@@ -680,6 +793,7 @@ int omc_matlab4_read_all_vals(ModelicaMatReader *reader)
     if (!reader->vars[i]) {
       reader->vars[i] = (double*) malloc(nrows*sizeof(double));
       memcpy(reader->vars[i], tmp + i*nrows, nrows*sizeof(double));
+      reader->nCachedVars++;
     }
   }
   free(tmp);
@@ -696,7 +810,9 @@ double omc_matlab4_read_single_val(double *res, ModelicaMatReader *reader, int v
     *res = reader->vars[ix][timeIndex];
     return 0;
   }
-  if(reader->doublePrecision==1) {
+  if(reader->data_2) {
+    *res = mapped_val(reader, absVarIndex, timeIndex);
+  } else if(reader->doublePrecision==1) {
     fseek(reader->file,reader->var_offset + sizeof(double)*(timeIndex*reader->nvar + absVarIndex-1), SEEK_SET);
     if(1 != fread(res, sizeof(double), 1, reader->file)) {
       *res = 0;
@@ -751,6 +867,57 @@ void find_closest_points(double key, double *vec, int nelem, int *index1, double
   *weight2 = 1.0 - *weight1;
 }
 
+/* Same as find_closest_points for many keys. If the keys are ascending, the
+ * search continues from the previous result (galloping), so a sorted batch
+ * costs O(nkeys + nelem) instead of O(nkeys*log(nelem)). */
+static void find_closest_points_batch(const double *keys, int nkeys, const double *vec, int nelem, int *index1, double *weight1, int *index2, double *weight2)
+{
+  int k, pos = 0;
+  for(k=0; k<nkeys; k++) {
+    double key = keys[k];
+    int lo, hi;
+    if(k > 0 && key >= keys[k-1]) {
+      int step = 1;
+      lo = pos;
+      hi = pos;
+      while(hi < nelem && vec[hi] < key) {
+        lo = hi + 1;
+        hi = lo + step;
+        step *= 2;
+      }
+      if(hi > nelem) hi = nelem;
+    } else {
+      lo = 0;
+      hi = nelem;
+    }
+    /* first element >= key */
+    while(lo < hi) {
+      int mid = lo + (hi-lo)/2;
+      if(vec[mid] < key) lo = mid + 1; else hi = mid;
+    }
+    pos = lo;
+    if(lo < nelem && vec[lo] == key) {
+      /* If we have events (multiple identical time stamps), use the right limit */
+      while(lo < nelem-1 && vec[lo+1] == key) lo++;
+      index1[k] = lo;
+      weight1[k] = 1.0;
+      index2[k] = -1;
+      weight2[k] = 0.0;
+    } else if(lo == 0 || lo == nelem) {
+      /* outside of the interval; use the closest point */
+      index1[k] = lo == 0 ? 0 : nelem-1;
+      weight1[k] = 1.0;
+      index2[k] = -1;
+      weight2[k] = 0.0;
+    } else {
+      index1[k] = lo;
+      index2[k] = lo-1;
+      weight1[k] = (key - vec[lo-1]) / (vec[lo]-vec[lo-1]);
+      weight2[k] = 1.0 - weight1[k];
+    }
+  }
+}
+
 double omc_matlab4_startTime(ModelicaMatReader *reader)
 {
   return reader->params[0];
@@ -790,6 +957,56 @@ int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_
   return 0;
 }
 
+/* Returns 0 on success, 1 + the index of the first invalid time stamp otherwise */
+int omc_matlab4_vals(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, const double *times, int ntimes)
+{
+  int k;
+  double *timevals, *vals = NULL;
+  int *i1, *i2;
+  double *w1, *w2;
+
+  if(var->isParam) {
+    double val = var->index < 0 ? -reader->params[abs(var->index)-1] : reader->params[var->index-1];
+    for(k=0; k<ntimes; k++) {
+      res[k] = val;
+    }
+    return 0;
+  }
+  for(k=0; k<ntimes; k++) {
+    if(times[k] > omc_matlab4_stopTime(reader) || times[k] < omc_matlab4_startTime(reader)) return k+1;
+  }
+  if(ntimes == 0) return 0;
+  if(!(timevals = omc_matlab4_read_vals(reader,1))) return 1;
+  /* without the mapped file a whole column is cheaper than many seeks */
+  if(!reader->data_2 && ntimes > 1) {
+    if(!(vals = omc_matlab4_read_vals(reader,var->index))) return 1;
+  }
+
+  i1 = (int*) malloc(2*ntimes*sizeof(int));
+  w1 = (double*) malloc(2*ntimes*sizeof(double));
+  i2 = i1 + ntimes;
+  w2 = w1 + ntimes;
+  find_closest_points_batch(times, ntimes, timevals, reader->nrows, i1, w1, i2, w2);
+  for(k=0; k<ntimes; k++) {
+    double y1, y2 = 0;
+    if(vals) {
+      y1 = vals[i1[k]];
+      if(i2[k] != -1) y2 = vals[i2[k]];
+    } else {
+      if(omc_matlab4_read_single_val(&y1,reader,var->index,i1[k]) ||
+         (i2[k] != -1 && omc_matlab4_read_single_val(&y2,reader,var->index,i2[k]))) {
+        free(i1);
+        free(w1);
+        return k+1;
+      }
+    }
+    res[k] = i2[k] == -1 ? y1 : w1[k]*y1 + w2[k]*y2;
+  }
+  free(i1);
+  free(w1);
+  return 0;
+}
+
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader)
 {
   unsigned int i;
@@ -54,6 +54,14 @@ typedef struct {
   int readAll; /* Read all variables already */
   double **vars;
   char doublePrecision; /* data_1 and data_2 in double ore single precision */
+  const char *data_2; /* data_2 matrix mapped into memory (binTrans only), or NULL */
+  void *mapData;
+  size_t mapSize;
+  int preloaded; /* data_2 is not transposed and was read completely when opening the file */
+  int maxCachedVars; /* maximum number of decoded columns kept in vars; 0 = no limit */
+  int nCachedVars;
+  unsigned long *varLastUse; /* LRU time stamps of the columns in vars */
+  unsigned long useCounter;
 } ModelicaMatReader;
 
 /* Returns 0 on success; the error message on error.
@@ -73,13 +81,31 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
 /* Writes the number of values in the returned array if nvals is non-NULL
  * Returns all values that the given variable may have.
  * Note: This function is _not_ defined for parameters; check var->isParam and then send the index
- * No bounds checking is performed. The returned data persists until the reader is closed.
+ * No bounds checking is performed. The returned data persists until the reader is closed
+ * (see omc_matlab4_set_cache_size for the exception).
  */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex);
 
 /* Returns 0 on success */
 int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, double time);
 
+/* Interpolates the variable at all given time stamps. Ascending time stamps
+ * are searched incrementally, which is much faster than calling
+ * omc_matlab4_val for each of them.
+ * Returns 0 on success, or 1 + the index of the first time stamp that is not
+ * within the simulation interval.
+ */
+int omc_matlab4_vals(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, const double *times, int ntimes);
+
+/* Limits the number of decoded columns that omc_matlab4_read_vals keeps in
+ * memory besides the time column (0 = no limit, the default). The least recently used column is
+ * released first, so with a limit the data returned by
+ * omc_matlab4_read_vals is only valid until the next call of it.
+ * Files that are not stored transposed are read completely when they are
+ * opened; the limit has no effect on them.
+ */
+void omc_matlab4_set_cache_size(ModelicaMatReader *reader, int maxVars);
+
 /* For debugging */
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader);
 
@@ -41,6 +41,32 @@
 #include <stdarg.h>
 #include <math.h>
 #include <float.h>
+#include <string.h>
+
+/* The BLAS is linked into the runtime libraries; OMC_NO_BLAS is set if configure
+   found no LAPACK/BLAS. The minimal and FMI runtimes never use it. */
+#if !defined(OMC_MINIMAL_RUNTIME) && !defined(OMC_FMI_RUNTIME) && !defined(OMC_NO_BLAS)
+#define OMC_REAL_ARRAY_USE_BLAS 1
+extern int dgemm_(char *transa, char *transb, int *m, int *n, int *k, double *alpha,
+                  double *a, int *lda, double *b, int *ldb, double *beta, double *c, int *ldc);
+extern int dgemv_(char *trans, int *m, int *n, double *alpha, double *a, int *lda,
+                  double *x, int *incx, double *beta, double *y, int *incy);
+#else
+#define OMC_REAL_ARRAY_USE_BLAS 0
+#endif
+
+/* Number of multiply-adds above which the matrix kernels call the BLAS */
+#if !defined(OMC_REAL_ARRAY_BLAS_GEMM_THRESHOLD)
+#define OMC_REAL_ARRAY_BLAS_GEMM_THRESHOLD 32768
+#endif
+#if !defined(OMC_REAL_ARRAY_BLAS_GEMV_THRESHOLD)
+#define OMC_REAL_ARRAY_BLAS_GEMV_THRESHOLD 16384
+#endif
+
+/* Block sizes of the cache-blocked kernels (in elements) */
+#define OMC_REAL_ARRAY_BLOCK_K 128
+#define OMC_REAL_ARRAY_BLOCK_J 256
+#define OMC_REAL_ARRAY_BLOCK_T 32
 
 static inline modelica_real *real_ptrget(const real_array_t *a, size_t i)
 {
@@ -623,7 +649,7 @@ void cat_real_array(int k, real_array_t* dest, int n,
                     real_array_t* first,...)
 {
     va_list ap;
-    int i, j, r, c;
+    int i, j, c;
     int n_sub = 1, n_super = 1;
     int new_k_dim_size = 0;
     real_array_t **elts = (real_array_t**)malloc(sizeof(real_array_t *) * n);
@@ -660,16 +686,14 @@ void cat_real_array(int k, real_array_t* dest, int n,
         n_sub *= elts[0]->dim_size[i];
     }
 
-    /* concatenation along k-th dimension */
+    /* concatenation along k-th dimension; each block is contiguous in source and dest */
     j = 0;
     for(i = 0; i < n_super; i++) {
         for(c = 0; c < n; c++) {
             int n_sub_k = n_sub * elts[c]->dim_size[k-1];
-            for(r = 0; r < n_sub_k; r++) {
-                real_set(dest, j,
-                            real_get(*elts[c], r + (i * n_sub_k)));
-                j++;
-            }
+            memcpy(real_ptrget(dest, j), real_ptrget(elts[c], i * n_sub_k),
+                   sizeof(modelica_real) * n_sub_k);
+            j += n_sub_k;
         }
     }
     free(elts);
@@ -685,7 +709,7 @@ void cat_alloc_real_array(int k, real_array_t* dest, int n,
                           real_array_t* first,...)
 {
     va_list ap;
-    int i, j, r, c;
+    int i, j, c;
     int n_sub = 1, n_super = 1;
     int new_k_dim_size = 0;
     real_array_t **elts = (real_array_t**)malloc(sizeof(real_array_t *) * n);
@@ -729,16 +753,14 @@ void cat_alloc_real_array(int k, real_array_t* dest, int n,
         dest->dim_size[j] = elts[0]->dim_size[j];
     }
     dest->dim_size[k-1] = new_k_dim_size;
-    /* concatenation along k-th dimension */
+    /* concatenation along k-th dimension; each block is contiguous in source and dest */
     j = 0;
     for(i = 0; i < n_super; i++) {
         for(c = 0; c < n; c++) {
             int n_sub_k = n_sub * elts[c]->dim_size[k-1];
-            for(r = 0; r < n_sub_k; r++) {
-                real_set(dest, j,
-                            real_get(*elts[c], r + (i * n_sub_k)));
-                j++;
-            }
+            memcpy(real_ptrget(dest, j), real_ptrget(elts[c], i * n_sub_k),
+                   sizeof(modelica_real) * n_sub_k);
+            j += n_sub_k;
         }
     }
     free(elts);
@@ -936,26 +958,47 @@ modelica_real mul_real_scalar_product(const real_array_t a, const real_array_t b
 
 void mul_real_matrix_product(const real_array_t * a,const real_array_t * b,real_array_t* dest)
 {
-    modelica_real tmp;
     size_t i_size;
     size_t j_size;
     size_t k_size;
-    size_t i;
-    size_t j;
-    size_t k;
+    size_t i, j, k, jj, kk, j_end, k_end;
+    const modelica_real *A = (const modelica_real *) a->data;
+    const modelica_real *B = (const modelica_real *) b->data;
+    modelica_real *C = (modelica_real *) dest->data;
 
     /* Assert that dest has correct size */
     i_size = dest->dim_size[0];
     j_size = dest->dim_size[1];
     k_size = a->dim_size[1];
 
-    for(i = 0; i < i_size; ++i) {
-        for(j = 0; j < j_size; ++j) {
-            tmp = 0;
-            for(k = 0; k < k_size; ++k) {
-                tmp += real_get(*a, (i * k_size) + k)*real_get(*b, (k * j_size) + j);
+#if OMC_REAL_ARRAY_USE_BLAS
+    if(i_size * j_size * k_size >= OMC_REAL_ARRAY_BLAS_GEMM_THRESHOLD) {
+        /* row-major C = A*B is column-major C^T = B^T*A^T */
+        char trans = 'N';
+        int m = (int) j_size, n = (int) i_size, kb = (int) k_size;
+        double alpha = 1.0, beta = 0.0;
+        dgemm_(&trans, &trans, &m, &n, &kb, &alpha, (double*) B, &m, (double*) A, &kb, &beta, C, &m);
+        return;
+    }
+#endif
+
+    /* i-k-j order, blocked over k and j, so the inner loop streams through
+     * contiguous rows of B and C and can be vectorized by the compiler */
+    memset(C, 0, sizeof(modelica_real) * i_size * j_size);
+    for(kk = 0; kk < k_size; kk += OMC_REAL_ARRAY_BLOCK_K) {
+        k_end = kk + OMC_REAL_ARRAY_BLOCK_K < k_size ? kk + OMC_REAL_ARRAY_BLOCK_K : k_size;
+        for(jj = 0; jj < j_size; jj += OMC_REAL_ARRAY_BLOCK_J) {
+            j_end = jj + OMC_REAL_ARRAY_BLOCK_J < j_size ? jj + OMC_REAL_ARRAY_BLOCK_J : j_size;
+            for(i = 0; i < i_size; ++i) {
+                modelica_real *c_row = C + i * j_size;
+                for(k = kk; k < k_end; ++k) {
+                    const modelica_real a_ik = A[i * k_size + k];
+                    const modelica_real *b_row = B + k * j_size;
+                    for(j = jj; j < j_end; ++j) {
+                        c_row[j] += a_ik * b_row[j];
+                    }
+                }
             }
-            real_set(dest, (i * j_size) + j, tmp);
         }
     }
 }
@@ -966,7 +1009,9 @@ void mul_real_matrix_vector(const real_array_t * a, const real_array_t * b,real_
     size_t j;
     size_t i_size;
     size_t j_size;
-    modelica_real tmp;
+    const modelica_real *A = (const modelica_real *) a->data;
+    const modelica_real *x = (const modelica_real *) b->data;
+    modelica_real *y = (modelica_real *) dest->data;
 
     /* Assert a matrix */
     /* Assert b vector */
@@ -975,12 +1020,29 @@ void mul_real_matrix_vector(const real_array_t * a, const real_array_t * b,real_
     i_size = a->dim_size[0];
     j_size = a->dim_size[1];
 
+#if OMC_REAL_ARRAY_USE_BLAS
+    if(i_size * j_size >= OMC_REAL_ARRAY_BLAS_GEMV_THRESHOLD) {
+        /* row-major A is the column-major A^T */
+        char trans = 'T';
+        int m = (int) j_size, n = (int) i_size, inc = 1;
+        double alpha = 1.0, beta = 0.0;
+        dgemv_(&trans, &m, &n, &alpha, (double*) A, &m, (double*) x, &inc, &beta, y, &inc);
+        return;
+    }
+#endif
+
+    /* two independent accumulators per row to break the dependency chain */
     for(i = 0; i < i_size; ++i) {
-        tmp = 0;
-        for(j = 0; j < j_size; ++j) {
-            tmp += real_get(*a, (i * j_size) + j) * real_get(*b, j);
+        const modelica_real *a_row = A + i * j_size;
+        modelica_real tmp0 = 0, tmp1 = 0;
+        for(j = 0; j + 1 < j_size; j += 2) {
+            tmp0 += a_row[j] * x[j];
+            tmp1 += a_row[j+1] * x[j+1];
+        }
+        if(j < j_size) {
+            tmp0 += a_row[j] * x[j];
         }
-        real_set(dest, i, tmp);
+        y[i] = tmp0 + tmp1;
     }
 }
 
@@ -988,24 +1050,39 @@ void mul_real_matrix_vector(const real_array_t * a, const real_array_t * b,real_
 void mul_real_vector_matrix(const real_array_t * a, const real_array_t * b,real_array_t* dest)
 {
     size_t i;
-    size_t j;
+    size_t k;
     size_t i_size;
-    size_t j_size;
-    modelica_real tmp;
+    size_t k_size;
+    const modelica_real *x = (const modelica_real *) a->data;
+    const modelica_real *B = (const modelica_real *) b->data;
+    modelica_real *y = (modelica_real *) dest->data;
 
     /* Assert a vector */
     /* Assert b matrix */
     /* Assert dest vector of correct size */
 
-    i_size = a->dim_size[0];
-    j_size = b->dim_size[1];
+    k_size = b->dim_size[0];
+    i_size = b->dim_size[1];
 
-    for(i = 0; i < i_size; ++i) {
-        tmp = 0;
-        for(j = 0; j < j_size; ++j) {
-            tmp += real_get(*a, j) * real_get(*b, (j * j_size) + i);
+#if OMC_REAL_ARRAY_USE_BLAS
+    if(i_size * k_size >= OMC_REAL_ARRAY_BLAS_GEMV_THRESHOLD) {
+        /* y = B^T x; the row-major B already is the column-major B^T */
+        char trans = 'N';
+        int m = (int) i_size, n = (int) k_size, inc = 1;
+        double alpha = 1.0, beta = 0.0;
+        dgemv_(&trans, &m, &n, &alpha, (double*) B, &m, (double*) x, &inc, &beta, y, &inc);
+        return;
+    }
+#endif
+
+    /* accumulate scaled rows of B, the inner loop is contiguous */
+    memset(y, 0, sizeof(modelica_real) * i_size);
+    for(k = 0; k < k_size; ++k) {
+        const modelica_real x_k = x[k];
+        const modelica_real *b_row = B + k * i_size;
+        for(i = 0; i < i_size; ++i) {
+            y[i] += x_k * b_row[i];
         }
-        real_set(dest, i, tmp);
     }
 }
 
@@ -1343,9 +1420,8 @@ void transpose_alloc_real_array(const real_array_t * a, real_array_t* dest)
  */
 void transpose_real_array(const real_array_t * a, real_array_t* dest)
 {
-    size_t i;
-    size_t j;
-    /*  size_t k;*/
+    size_t i, ii;
+    size_t j, jj;
     size_t n,m;
 
     if(a->ndims == 1) {
@@ -1360,9 +1436,16 @@ void transpose_real_array(const real_array_t * a, real_array_t* dest)
 
     omc_assert_macro(dest->dim_size[0] == m && dest->dim_size[1] == n);
 
-    for(i = 0; i < n; ++i) {
-        for(j = 0; j < m; ++j) {
-            real_set(dest, (j * n) + i, real_get(*a, (i * m) + j));
+    /* tiled, so that both source rows and destination rows stay in cache */
+    for(ii = 0; ii < n; ii += OMC_REAL_ARRAY_BLOCK_T) {
+        size_t i_end = ii + OMC_REAL_ARRAY_BLOCK_T < n ? ii + OMC_REAL_ARRAY_BLOCK_T : n;
+        for(jj = 0; jj < m; jj += OMC_REAL_ARRAY_BLOCK_T) {
+            size_t j_end = jj + OMC_REAL_ARRAY_BLOCK_T < m ? jj + OMC_REAL_ARRAY_BLOCK_T : m;
+            for(i = ii; i < i_end; ++i) {
+                for(j = jj; j < j_end; ++j) {
+                    real_set(dest, (j * n) + i, real_get(*a, (i * m) + j));
+                }
+            }
         }
     }
 }
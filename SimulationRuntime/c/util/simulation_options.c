@@ -35,6 +35,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */            "abortSlowSimulation",
   /* FLAG_ALARM */                 "alarm",
+  /* FLAG_ARENA */                 "arena",
   /* FLAG_CLOCK */                 "clock",
   /* FLAG_CPU */                   "cpu",
   /* FLAG_CSV_OSTEP */             "csvOstep",
@@ -57,6 +58,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_IIT */                   "iit",
   /* FLAG_ILS */                   "ils",
   /* FLAG_INITIAL_STEP_SIZE */     "initialStepSize",
+  /* FLAG_INIT_XML_CACHE */        "initXmlCache",
   /* FLAG_INPUT_CSV */             "csvInput",
   /* FLAG_INPUT_FILE */            "exInputFile",
   /* FLAG_INPUT_FILE_STATES */     "stateFile",
@@ -75,6 +77,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_LSS_MAX_DENSITY */       "lssMaxDensity",
   /* FLAG_LSS_MIN_SIZE */          "lssMinSize",
   /* FLAG_LV */                    "lv",
+  /* FLAG_LV_ASYNC */              "lvAsync",
   /* FLAG_MAX_BISECTION_ITERATIONS */  "mbi",
   /* FLAG_MAX_EVENT_ITERATIONS */  "mei",
   /* FLAG_MAX_ORDER */             "maxIntegrationOrder",
@@ -100,6 +103,10 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_OUTPUT */                "output",
   /* FLAG_OVERRIDE */              "override",
   /* FLAG_OVERRIDE_FILE */         "overrideFile",
+  /* FLAG_PM_AFFINITY */           "pmAffinity",
+  /* FLAG_PM_RECLUSTER */          "pmRecluster",
+  /* FLAG_PM_SCHEDULER */          "pmScheduler",
+  /* FLAG_PM_THREADS */            "pmThreads",
   /* FLAG_PORT */                  "port",
   /* FLAG_R */                     "r",
   /* FLAG_RT */                    "rt",
@@ -116,6 +123,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */            "aborts if the simulation chatters",
   /* FLAG_ALARM */                 "aborts after the given number of seconds (0 disables)",
+  /* FLAG_ARENA */                 "value specifies the size in MB of the arena for array temporaries (0 disables)",
   /* FLAG_CLOCK */                 "selects the type of clock to use -clock=RT, -clock=CYC or -clock=CPU",
   /* FLAG_CPU */                   "dumps the cpu-time into the result file",
   /* FLAG_CSV_OSTEP */             "value specifies csv-files for debuge values for optimizer step",
@@ -138,6 +146,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_IIT */                   "[double] value specifies a time for the initialization of the model",
   /* FLAG_ILS */                   "[int] default: 1",
   /* FLAG_INITIAL_STEP_SIZE */     "value specifies an initial stepsize for the dassl solver",
+  /* FLAG_INIT_XML_CACHE */        "reads the setup XML file from a binary cache, which is created on the first run",
   /* FLAG_INPUT_CSV */             "value specifies an csv-file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE */            "value specifies an external file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE_STATES */     "value specifies an file with states start values for the optimization of the model",
@@ -156,6 +165,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_LSS_MAX_DENSITY */       "[double (default 0.2)] value specifies the maximum density for using a linear sparse solver",
   /* FLAG_LSS_MIN_SIZE */          "[int (default 4001)] value specifies the minimum system size for using a linear sparse solver",
   /* FLAG_LV */                    "[string list] value specifies the logging level",
+  /* FLAG_LV_ASYNC */              "[int] value specifies the number of buffered log messages per thread and enables asynchronous logging",
   /* FLAG_MAX_BISECTION_ITERATIONS */  "[int (default 0)] value specifies the maximum number of bisection iterations for state event detection or zero for default behavior",
   /* FLAG_MAX_EVENT_ITERATIONS */  "[int (default 20)] value specifies the maximum number of event iterations",
   /* FLAG_MAX_ORDER */             "value specifies maximum integration order, used by dassl solver",
@@ -181,6 +191,10 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_OUTPUT */                "output the variables a, b and c at the end of the simulation to the standard output",
   /* FLAG_OVERRIDE */              "override the variables or the simulation settings in the XML setup file",
   /* FLAG_OVERRIDE_FILE */         "will override the variables or the simulation settings in the XML setup file with the values from the file",
+  /* FLAG_PM_AFFINITY */           "[ParModelica auto] pin the worker threads to consecutive cores",
+  /* FLAG_PM_RECLUSTER */          "value specifies the number of steps [ParModelica auto] measures before clustering again",
+  /* FLAG_PM_SCHEDULER */          "value specifies the [ParModelica auto] executor (level|dynamic)",
+  /* FLAG_PM_THREADS */            "value specifies the number of threads used by [ParModelica auto]",
   /* FLAG_PORT */                  "value specifies the port for simulation status (default disabled)",
   /* FLAG_R */                     "value specifies a new result file than the default Model_res.mat",
   /* FLAG_RT */                    "value specifies the scaling factor for real-time synchronization (0 disables)",
@@ -198,6 +212,14 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Aborts if the simulation chatters.",
   /* FLAG_ALARM */
   "  Aborts after the given number of seconds (default=0 disables the alarm).",
+  /* FLAG_ARENA */
+  "  Value specifies the size in MB of an arena that is used for array temporaries\n"
+  "  during the simulation (default=0 disables the arena).\n"
+  "  Arrays of Real, Integer and Boolean created while evaluating the model are taken\n"
+  "  from the arena and released all at once after each evaluation and each\n"
+  "  accepted step, instead of being handled by the garbage collector.\n"
+  "  If the arena is too small, the remaining arrays are allocated as usual;\n"
+  "  use -lv=LOG_STATS to see the used size and the number of overflows.",
   /* FLAG_CLOCK */
   "  Selects the type of clock to use. Valid options include:\n\n"
   "  * RT (monotonic real-time clock)\n"
@@ -256,6 +278,11 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  The value is an Integer with default value 1.",
   /* FLAG_INITIAL_STEP_SIZE */
   "  Value specifies an initial stepsize for the dassl solver.",
+  /* FLAG_INIT_XML_CACHE */
+  "  Reads the setup XML file from a binary cache file (Model_init.xml.cache) instead\n"
+  "  of parsing the XML. The cache is created on the first run and is rebuilt whenever\n"
+  "  the content of the XML file changes. Values given by -override or -overrideFile\n"
+  "  are still applied on top of the cached values.",
    /* FLAG_INPUT_CSV */
   "  Value specifies an csv-file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE */
@@ -304,6 +331,12 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   /* FLAG_LV */
   "  Value (a comma-separated String list) specifies which logging levels to\n"
   "  enable. Multiple options can be enabled at the same time.",
+  /* FLAG_LV_ASYNC */
+  "  Value specifies the number of log messages that are buffered per thread.\n"
+  "  The messages are written by a background thread, so that logging with -lv\n"
+  "  slows down the simulation less. If the buffer is full, the oldest messages\n"
+  "  are dropped; the number of dropped messages is printed at the end.\n"
+  "  Errors and assertions are always written before the simulation continues.",
   /* FLAG_MAX_BISECTION_ITERATIONS */
   "  value specifies the maximum number of bisection iterations for state event\n"
   "  detection or zero for default behavior",
@@ -382,6 +415,25 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Note that: -overrideFile CANNOT be used with -override.\n"
   "  Use when variables for -override are too many.\n"
   "  overrideFileName contains lines of the form: var1=start1",
+  /* FLAG_PM_AFFINITY */
+  "  Pins the threads of the automatic ParModelica parallelization to consecutive\n"
+  "  cores, starting with core 0 for the main thread.",
+  /* FLAG_PM_RECLUSTER */
+  "  Value specifies the number of evaluations of the ODE system during which the\n"
+  "  automatic ParModelica parallelization measures the execution time of each\n"
+  "  equation. Afterwards the equations are clustered and scheduled again with\n"
+  "  the averaged times, and the new schedule is used for the rest of the\n"
+  "  simulation. The default 0 keeps the schedule from the first evaluation.",
+  /* FLAG_PM_SCHEDULER */
+  "  Value specifies how the automatic ParModelica parallelization executes the\n"
+  "  clustered task graph.\n"
+  "  * level (default): the levels of the graph are executed one after the other\n"
+  "    with a barrier in between\n"
+  "  * dynamic: a cluster starts as soon as all its parents are finished, idle\n"
+  "    threads steal work from the others",
+  /* FLAG_PM_THREADS */
+  "  Value specifies the number of threads used by the automatic ParModelica\n"
+  "  parallelization. The default is the number of available cores.",
   /* FLAG_PORT */
   "  Value specifies the port for simulation status (default disabled).",
   /* FLAG_R */
@@ -408,6 +460,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
 
   /* FLAG_ABORT_SLOW */            FLAG_TYPE_FLAG,
   /* FLAG_ALARM */                 FLAG_TYPE_OPTION,
+  /* FLAG_ARENA */                 FLAG_TYPE_OPTION,
   /* FLAG_CLOCK */                 FLAG_TYPE_OPTION,
   /* FLAG_CPU */                   FLAG_TYPE_FLAG,
   /* FLAG_CSV_OSTEP */             FLAG_TYPE_OPTION,
@@ -430,6 +483,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_IIT */                   FLAG_TYPE_OPTION,
   /* FLAG_ILS */                   FLAG_TYPE_OPTION,
   /* FLAG_INITIAL_STEP_SIZE */     FLAG_TYPE_OPTION,
+  /* FLAG_INIT_XML_CACHE */        FLAG_TYPE_FLAG,
   /* FLAG_INPUT_CSV */             FLAG_TYPE_OPTION,
   /* FLAG_INPUT_FILE */            FLAG_TYPE_OPTION,
   /* FLAG_INPUT_FILE_STATES */     FLAG_TYPE_OPTION,
@@ -448,6 +502,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_LSS_MAX_DENSITY */       FLAG_TYPE_OPTION,
   /* FLAG_LSS_MIN_SIZE */          FLAG_TYPE_OPTION,
   /* FLAG_LV */                    FLAG_TYPE_OPTION,
+  /* FLAG_LV_ASYNC */              FLAG_TYPE_OPTION,
   /* FLAG_MAX_BISECTION_ITERATIONS */  FLAG_TYPE_OPTION,
   /* FLAG_MAX_EVENT_ITERATIONS */  FLAG_TYPE_OPTION,
   /* FLAG_MAX_ORDER */             FLAG_TYPE_OPTION,
@@ -473,6 +528,10 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_OUTPUT */                FLAG_TYPE_OPTION,
   /* FLAG_OVERRIDE */              FLAG_TYPE_OPTION,
   /* FLAG_OVERRIDE_FILE */         FLAG_TYPE_OPTION,
+  /* FLAG_PM_AFFINITY */           FLAG_TYPE_FLAG,
+  /* FLAG_PM_RECLUSTER */          FLAG_TYPE_OPTION,
+  /* FLAG_PM_SCHEDULER */          FLAG_TYPE_OPTION,
+  /* FLAG_PM_THREADS */            FLAG_TYPE_OPTION,
   /* FLAG_PORT */                  FLAG_TYPE_OPTION,
   /* FLAG_R */                     FLAG_TYPE_OPTION,
   /* FLAG_RT */                    FLAG_TYPE_OPTION,
@@ -43,6 +43,7 @@ enum _FLAG
 
   FLAG_ABORT_SLOW,
   FLAG_ALARM,
+  FLAG_ARENA,
   FLAG_CLOCK,
   FLAG_CPU,
   FLAG_CSV_OSTEP,
@@ -65,6 +66,7 @@ enum _FLAG
   FLAG_IIT,
   FLAG_ILS,
   FLAG_INITIAL_STEP_SIZE,
+  FLAG_INIT_XML_CACHE,
   FLAG_INPUT_CSV,
   FLAG_INPUT_FILE,
   FLAG_INPUT_FILE_STATES,
@@ -83,6 +85,7 @@ enum _FLAG
   FLAG_LSS_MAX_DENSITY,
   FLAG_LSS_MIN_SIZE,
   FLAG_LV,
+  FLAG_LV_ASYNC,
   FLAG_MAX_BISECTION_ITERATIONS,
   FLAG_MAX_EVENT_ITERATIONS,
   FLAG_MAX_ORDER,
@@ -108,6 +111,10 @@ enum _FLAG
   FLAG_OUTPUT,
   FLAG_OVERRIDE,
   FLAG_OVERRIDE_FILE,
+  FLAG_PM_AFFINITY,
+  FLAG_PM_RECLUSTER,
+  FLAG_PM_SCHEDULER,
+  FLAG_PM_THREADS,
   FLAG_PORT,
   FLAG_R,
   FLAG_RT,
@@ -0,0 +1,184 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Microbenchmarks for the real_array_t kernels.
+ *
+ * Every kernel is checked against a naive reference implementation and
+ * then timed for a range of sizes. The result is printed as one line per
+ * kernel and size: name, n, seconds per call, and max. abs. error.
+ *
+ * usage: bench_real_array [maximum size (default 512)]
+ */
+
+#include "util/real_array.h"
+#include "gc/omc_gc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+static double max_abs_diff(const modelica_real *a, const modelica_real *b, size_t n)
+{
+  size_t i;
+  double res = 0;
+  for (i = 0; i < n; i++) {
+    double d = fabs(a[i] - b[i]);
+    res = d > res ? d : res;
+  }
+  return res;
+}
+
+static void fill(real_array_t *a)
+{
+  size_t i, n = base_array_nr_of_elements(*a);
+  for (i = 0; i < n; i++) {
+    ((modelica_real*)a->data)[i] = (double) rand() / RAND_MAX - 0.5;
+  }
+}
+
+/* repeats the call until at least 0.1 s have passed and returns the time per call */
+#define TIME_KERNEL(call, result) { \
+  long reps = 0; \
+  double elapsed; \
+  clock_t start = clock(); \
+  do { \
+    call; \
+    reps++; \
+    elapsed = (double) (clock() - start) / CLOCKS_PER_SEC; \
+  } while (elapsed < 0.1); \
+  result = elapsed / reps; \
+}
+
+static void bench_matrix_product(size_t n)
+{
+  real_array_t a, b, c;
+  modelica_real *ref = (modelica_real*) calloc(n*n, sizeof(modelica_real));
+  size_t i, j, k;
+  double t;
+
+  simple_alloc_2d_real_array(&a, n, n);
+  simple_alloc_2d_real_array(&b, n, n);
+  simple_alloc_2d_real_array(&c, n, n);
+  fill(&a);
+  fill(&b);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      for (k = 0; k < n; k++) {
+        ref[i*n+j] += real_get(a, i*n+k) * real_get(b, k*n+j);
+      }
+    }
+  }
+  TIME_KERNEL(mul_real_matrix_product(&a, &b, &c), t);
+  printf("mul_real_matrix_product  %6ld %12.4e %10.2e\n", (long) n, t, max_abs_diff((modelica_real*)c.data, ref, n*n));
+  free(ref);
+}
+
+static void bench_matrix_vector(size_t n)
+{
+  real_array_t a, x, y, z;
+  modelica_real *ref = (modelica_real*) calloc(n, sizeof(modelica_real));
+  modelica_real *ref2 = (modelica_real*) calloc(n, sizeof(modelica_real));
+  size_t i, j;
+  double t;
+
+  simple_alloc_2d_real_array(&a, n, n);
+  simple_alloc_1d_real_array(&x, n);
+  simple_alloc_1d_real_array(&y, n);
+  simple_alloc_1d_real_array(&z, n);
+  fill(&a);
+  fill(&x);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      ref[i] += real_get(a, i*n+j) * real_get(x, j);
+      ref2[j] += real_get(x, i) * real_get(a, i*n+j);
+    }
+  }
+  TIME_KERNEL(mul_real_matrix_vector(&a, &x, &y), t);
+  printf("mul_real_matrix_vector   %6ld %12.4e %10.2e\n", (long) n, t, max_abs_diff((modelica_real*)y.data, ref, n));
+  TIME_KERNEL(mul_real_vector_matrix(&x, &a, &z), t);
+  printf("mul_real_vector_matrix   %6ld %12.4e %10.2e\n", (long) n, t, max_abs_diff((modelica_real*)z.data, ref2, n));
+  free(ref);
+  free(ref2);
+}
+
+static void bench_transpose(size_t n)
+{
+  real_array_t a, b;
+  size_t i, j;
+  double t, err = 0;
+
+  simple_alloc_2d_real_array(&a, n, 2*n);
+  simple_alloc_2d_real_array(&b, 2*n, n);
+  fill(&a);
+  TIME_KERNEL(transpose_real_array(&a, &b), t);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < 2*n; j++) {
+      err += fabs(real_get(a, i*2*n+j) - real_get(b, j*n+i));
+    }
+  }
+  printf("transpose_real_array     %6ld %12.4e %10.2e\n", (long) n, t, err);
+}
+
+static void bench_cat(size_t n)
+{
+  real_array_t a, b, c;
+  size_t i, j;
+  double t, err = 0;
+
+  simple_alloc_2d_real_array(&a, n, n);
+  simple_alloc_2d_real_array(&b, n, n);
+  simple_alloc_2d_real_array(&c, n, 2*n);
+  fill(&a);
+  fill(&b);
+  TIME_KERNEL(cat_real_array(2, &c, 2, &a, &b), t);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      err += fabs(real_get(a, i*n+j) - real_get(c, i*2*n+j));
+      err += fabs(real_get(b, i*n+j) - real_get(c, i*2*n+n+j));
+    }
+  }
+  printf("cat_real_array (k=2)     %6ld %12.4e %10.2e\n", (long) n, t, err);
+}
+
+int main(int argc, char **argv)
+{
+  size_t n, nmax = argc > 1 ? atol(argv[1]) : 512;
+
+  omc_alloc_interface.init();
+  printf("%-24s %6s %12s %10s\n", "kernel", "n", "time [s]", "error");
+  for (n = 3; n <= nmax; n = n < 8 ? n+1 : 2*n) {
+    bench_matrix_product(n);
+    bench_matrix_vector(n);
+    bench_transpose(n);
+    bench_cat(n);
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Tests the column cache of the MAT-file reader.
+ *
+ * A small result file is written in both layouts (binTrans and binNormal).
+ * The cache is limited to the time column plus one other column, so reading
+ * the variables in turn releases and re-reads them. Every value read must
+ * match the written one.
+ *
+ * usage: test_read_matlab4 [scratch file (default test_read_matlab4.mat)]
+ */
+
+#include "util/read_matlab4.h"
+#include "util/write_matlab4.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define N_VARS 4
+#define N_ROWS 7
+#define NAME_LEN 5
+
+static const char *names[N_VARS] = {"time", "x", "y", "z"};
+
+/* the value of variable k (0 is time) at row i */
+static double value(int k, int i)
+{
+  return k == 0 ? 0.5*i : 10.0*k + i*i;
+}
+
+/* writes the strings in a char matrix; one string per column for binTrans,
+ * one string per row otherwise */
+static int write_strings(FILE *fout, const char *name, const char **strs, int n, int len, int binTrans)
+{
+  char buf[4*11];
+  int k, j;
+  memset(buf, ' ', sizeof(buf));
+  for (k = 0; k < n; k++) {
+    for (j = 0; strs[k][j]; j++) {
+      if (binTrans) {
+        buf[k*len + j] = strs[k][j];
+      } else {
+        buf[j*n + k] = strs[k][j];
+      }
+    }
+  }
+  return binTrans ? writeMatVer4Matrix(fout, name, len, n, buf, sizeof(int8_t))
+                  : writeMatVer4Matrix(fout, name, n, len, buf, sizeof(int8_t));
+}
+
+static int write_file(const char *fileName, int binTrans)
+{
+  const char *aclass[4] = {"Atrajectory", "1.1", "", binTrans ? "binTrans" : "binNormal"};
+  const char *descr[N_VARS] = {"", "", "", ""};
+  int32_t dataInfo[4*N_VARS];
+  double data_1[2] = {value(0, 0), value(0, N_ROWS-1)};
+  double data_2[N_VARS*N_ROWS];
+  int k, i, res;
+  FILE *fout = fopen(fileName, "wb");
+  if (!fout) {
+    return 1;
+  }
+  for (k = 0; k < N_VARS; k++) {
+    int32_t info[4] = {k ? 2 : 0, k+1, 0, -1};
+    for (i = 0; i < 4; i++) {
+      dataInfo[binTrans ? k*4+i : i*N_VARS+k] = info[i];
+    }
+    for (i = 0; i < N_ROWS; i++) {
+      data_2[binTrans ? i*N_VARS+k : k*N_ROWS+i] = value(k, i);
+    }
+  }
+  res = write_strings(fout, "Aclass", aclass, 4, 11, 0)
+     || write_strings(fout, "name", names, N_VARS, NAME_LEN, binTrans)
+     || write_strings(fout, "description", descr, N_VARS, NAME_LEN, binTrans)
+     || (binTrans ? writeMatVer4Matrix(fout, "dataInfo", 4, N_VARS, dataInfo, sizeof(int32_t))
+                  : writeMatVer4Matrix(fout, "dataInfo", N_VARS, 4, dataInfo, sizeof(int32_t)))
+     || (binTrans ? writeMatVer4Matrix(fout, "data_1", 1, 2, data_1, sizeof(double))
+                  : writeMatVer4Matrix(fout, "data_1", 2, 1, data_1, sizeof(double)))
+     || (binTrans ? writeMatVer4Matrix(fout, "data_2", N_VARS, N_ROWS, data_2, sizeof(double))
+                  : writeMatVer4Matrix(fout, "data_2", N_ROWS, N_VARS, data_2, sizeof(double)));
+  return fclose(fout) || res;
+}
+
+static int test_cache(const char *fileName, int binTrans)
+{
+  /* x, y and z are read twice; each read of a column releases the previous one */
+  const int order[] = {1, 2, 3, 1, 3, 2};
+  ModelicaMatReader reader;
+  int n, i, rc = 0;
+  if (write_file(fileName, binTrans)) return 1;
+  if (omc_new_matlab4_reader(fileName, &reader)) return 2;
+  omc_matlab4_set_cache_size(&reader, 2);
+  for (n = 0; !rc && n < sizeof(order)/sizeof(order[0]); n++) {
+    int k = order[n];
+    ModelicaMatVariable_t *var = omc_matlab4_find_var(&reader, names[k]);
+    double *vals, res;
+    if (!var || var->isParam) { rc = 3; break; }
+    vals = omc_matlab4_read_vals(&reader, var->index);
+    if (!vals) { rc = 4; break; }
+    for (i = 0; i < N_ROWS; i++) {
+      if (vals[i] != value(k, i)) { rc = 5; break; }
+    }
+    /* interpolates between rows 2 and 3 */
+    if (!rc && (omc_matlab4_val(&res, &reader, var, 0.5*(value(0, 2)+value(0, 3))) ||
+                res != 0.5*(value(k, 2)+value(k, 3)))) {
+      rc = 6;
+    }
+    if (!rc && binTrans && reader.nCachedVars > 2) rc = 7;
+  }
+  omc_free_matlab4_reader(&reader);
+  remove(fileName);
+  return rc;
+}
+
+/* main */
+int main(int argc, char **argv)
+{
+  const char *fileName = argc > 1 ? argv[1] : "test_read_matlab4.mat";
+  int rc;
+
+  if ((rc = test_cache(fileName, 1)) != 0) return 1000+rc;
+  if ((rc = test_cache(fileName, 0)) != 0) return 2000+rc;
+
+  /* everything is fine */
+  return 0;
+}
@@ -176,6 +176,22 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
     file.close();
 
   }
+
+  // start values given in the settings, e.g. of an ensemble member, replace the ones of the file
+  const StartValueOverrides& overrides = _globalSettings->getStartValueOverrides();
+  try
+  {
+    for (std::map<size_t, double>::const_iterator it = overrides.realValues.begin(); it != overrides.realValues.end(); it++)
+      system.setRealStartValue(const_cast<double&>(sim_vars->getRealVar(it->first)), it->second);
+    for (std::map<size_t, int>::const_iterator it = overrides.intValues.begin(); it != overrides.intValues.end(); it++)
+      system.setIntStartValue(const_cast<int&>(sim_vars->getIntVar(it->first)), it->second);
+    for (std::map<size_t, bool>::const_iterator it = overrides.boolValues.begin(); it != overrides.boolValues.end(); it++)
+      system.setBoolStartValue(const_cast<bool&>(sim_vars->getBoolVar(it->first)), it->second);
+  }
+  catch(std::runtime_error& ex)
+  {
+    throw ModelicaSimulationError(UTILITY, string("Could not override start values: ") + ex.what());
+  }
 }
 
 const output_int_vars_t&  XmlPropertyReader::getIntOutVars()
@@ -0,0 +1,147 @@
+/** @addtogroup dataexchange
+ *  @{
+ */
+
+/*
+ * Checks that the start values of ensemble members replace the ones of the
+ * init file. Two members of the same model read the init file with
+ * different overrides and have to end up with their own start values.
+ *
+ * usage: StartValueOverrides [scratch init file (default StartValueOverrides_init.xml)]
+ * Returns 0 on success.
+ */
+
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/System/FactoryExport.h>
+#include <Core/System/SimVars.h>
+#include <Core/SimulationSettings/GlobalSettings.h>
+#include <Core/DataExchange/XmlPropertyReader.h>
+
+#include <cstdio>
+#include <fstream>
+
+/// System that only stores start values, as the reader needs them
+class StartValueSystem : public IContinuous
+{
+public:
+    virtual int getDimBoolean() const { return 1; }
+    virtual int getDimContinuousStates() const { return 1; }
+    virtual int getDimAE() const { return 0; }
+    virtual int getDimInteger() const { return 1; }
+    virtual int getDimReal() const { return 2; }
+    virtual int getDimString() const { return 0; }
+    virtual int getDimRHS() const { return 1; }
+    virtual void getBoolean(bool* z) {}
+    virtual void getContinuousStates(double* z) {}
+    virtual void getNominalStates(double* z) {}
+    virtual void getInteger(int* z) {}
+    virtual void getReal(double* z) {}
+    virtual void getString(std::string* z) {}
+    virtual void getRHS(double* f) {}
+    virtual void setBoolean(const bool* z) {}
+    virtual void setContinuousStates(const double* z) {}
+    virtual void setInteger(const int* z) {}
+    virtual void setReal(const double* z) {}
+    virtual void setString(const std::string* z) {}
+    virtual void setStateDerivatives(const double* f) {}
+    virtual void restoreOldValues() {}
+    virtual void restoreNewValues() {}
+    virtual bool evaluateAll(const UPDATETYPE command) { return false; }
+    virtual void evaluateODE(const UPDATETYPE command) {}
+    virtual void evaluateZeroFuncs(const UPDATETYPE command) {}
+    virtual bool evaluateConditions(const UPDATETYPE command) { return false; }
+    virtual void evaluateDAE(const UPDATETYPE command) {}
+    virtual bool stepCompleted(double time) { return false; }
+    virtual bool stepStarted(double time) { return false; }
+    virtual double& getRealStartValue(double& var) { return var; }
+    virtual bool& getBoolStartValue(bool& var) { return var; }
+    virtual int& getIntStartValue(int& var) { return var; }
+    virtual string& getStringStartValue(string& var) { return var; }
+    virtual void setRealStartValue(double& var, double val) { var = val; }
+    virtual void setBoolStartValue(bool& var, bool val) { var = val; }
+    virtual void setIntStartValue(int& var, int val) { var = val; }
+    virtual void setStringStartValue(string& var, string val) { var = val; }
+    virtual void setNumPartitions(int numPartitions) {}
+    virtual int getNumPartitions() { return 0; }
+    virtual void setPartitionActivation(bool* partitions) {}
+    virtual void getPartitionActivation(bool* partitions) {}
+    virtual int getActivator(int state) { return 0; }
+};
+
+static void writeInitFile(const string& fileName)
+{
+    std::ofstream file(fileName.c_str());
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << "<ModelDescription modelName=\"Test\">\n"
+         << "  <ModelVariables>\n"
+         << "  <ScalarVariable name=\"x\" valueReference=\"0\" variability=\"continuous\" alias=\"noAlias\" hideResult=\"false\">\n"
+         << "    <Real start=\"1.0\" />\n"
+         << "  </ScalarVariable>\n"
+         << "  <ScalarVariable name=\"p\" valueReference=\"1\" variability=\"parameter\" alias=\"noAlias\" hideResult=\"false\">\n"
+         << "    <Real start=\"2.0\" />\n"
+         << "  </ScalarVariable>\n"
+         << "  <ScalarVariable name=\"n\" valueReference=\"0\" variability=\"parameter\" alias=\"noAlias\" hideResult=\"false\">\n"
+         << "    <Integer start=\"3\" />\n"
+         << "  </ScalarVariable>\n"
+         << "  <ScalarVariable name=\"b\" valueReference=\"0\" variability=\"parameter\" alias=\"noAlias\" hideResult=\"false\">\n"
+         << "    <Boolean start=\"false\" />\n"
+         << "  </ScalarVariable>\n"
+         << "  </ModelVariables>\n"
+         << "</ModelDescription>\n";
+}
+
+/// Reads the init file with the start values of a member, returns the variables
+static shared_ptr<ISimVars> readMember(const string& fileName, const StartValueOverrides& overrides)
+{
+    GlobalSettings settings;
+    settings.setStartValueOverrides(overrides);
+    shared_ptr<ISimVars> simVars(new SimVars(2, 1, 1, 0, 4, 1, 0));
+    StartValueSystem system;
+    XmlPropertyReader reader(&settings, fileName);
+    reader.readInitialValues(system, simVars);
+    return simVars;
+}
+
+int main(int argc, char* argv[])
+{
+    string fileName = argc > 1 ? argv[1] : "StartValueOverrides_init.xml";
+    writeInitFile(fileName);
+
+    StartValueOverrides member1, member2;
+    member1.realValues[1] = 5.0;
+    member2.realValues[1] = 7.0;
+    member2.intValues[0] = 4;
+    member2.boolValues[0] = true;
+
+    shared_ptr<ISimVars> defaults = readMember(fileName, StartValueOverrides());
+    shared_ptr<ISimVars> vars1 = readMember(fileName, member1);
+    shared_ptr<ISimVars> vars2 = readMember(fileName, member2);
+    std::remove(fileName.c_str());
+
+    // the values of the file
+    if (defaults->getRealVar(0) != 1.0 || defaults->getRealVar(1) != 2.0 || defaults->getIntVar(0) != 3 || defaults->getBoolVar(0))
+        return 1;
+    // the members only differ in the overridden values
+    if (vars1->getRealVar(0) != 1.0 || vars1->getRealVar(1) != 5.0 || vars1->getIntVar(0) != 3 || vars1->getBoolVar(0))
+        return 2;
+    if (vars2->getRealVar(0) != 1.0 || vars2->getRealVar(1) != 7.0 || vars2->getIntVar(0) != 4 || !vars2->getBoolVar(0))
+        return 3;
+
+    // an index outside of the variables is reported
+    StartValueOverrides invalid;
+    invalid.realValues[2] = 0.0;
+    try
+    {
+        writeInitFile(fileName);
+        readMember(fileName, invalid);
+        std::remove(fileName.c_str());
+        return 4;
+    }
+    catch (ModelicaSimulationError&)
+    {
+        std::remove(fileName.c_str());
+    }
+    return 0;
+}
+/** @} */ // end of dataexchange
@@ -8,9 +8,210 @@
 #include <Core/Math/ArraySlice.h>
 #include <sstream>
 #include <stdio.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+/**
+ * Kernels of the array operations on raw (column major) data.
+ * The generic version uses plain loops and STL algorithms. The version for
+ * double is specialized at compile time if the runtime is built for a CPU
+ * with AVX (e.g. with -DUSE_AVX2=ON); it processes four elements per
+ * instruction. Unaligned loads are used, they run at full speed on
+ * the ARRAY_ALIGNMENT aligned data of StatArray and DynArray.
+ */
+template <typename T>
+struct ArrayKernels
+{
+  /// r = op(a, b) element-wise
+  template <class Op>
+  static void apply(const T* a, const T* b, T* r, size_t n, Op op)
+  {
+    std::transform(a, a + n, b, r, op);
+  }
+
+  /// r = op(a, b) with scalar b
+  template <class Op>
+  static void apply(const T* a, T b, T* r, size_t n, Op op)
+  {
+    std::transform(a, a + n, r, std::bind2nd(op, b));
+  }
+
+  /// r = -a
+  static void negate(const T* a, T* r, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      r[i] = -a[i];
+  }
+
+  static T sum(const T* a, size_t n)
+  {
+    return std::accumulate(a, a + n, T());
+  }
+
+  static T dot(const T* a, const T* b, size_t n)
+  {
+    return std::inner_product(a, a + n, b, 0.0);
+  }
+
+  /// r += s * a
+  static void axpy(T s, const T* a, T* r, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      r[i] += s * a[i];
+  }
+};
+
+#if defined(__AVX__)
+static inline __m256d simd(std::plus<double>, __m256d a, __m256d b)
+{
+  return _mm256_add_pd(a, b);
+}
+
+static inline __m256d simd(std::minus<double>, __m256d a, __m256d b)
+{
+  return _mm256_sub_pd(a, b);
+}
+
+static inline __m256d simd(std::multiplies<double>, __m256d a, __m256d b)
+{
+  return _mm256_mul_pd(a, b);
+}
+
+static inline __m256d simd(std::divides<double>, __m256d a, __m256d b)
+{
+  return _mm256_div_pd(a, b);
+}
+
+/// c + a * b
+static inline __m256d simd_fma(__m256d a, __m256d b, __m256d c)
+{
+#if defined(__FMA__)
+  return _mm256_fmadd_pd(a, b, c);
+#else
+  return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+static inline double simd_hsum(__m256d v)
+{
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+template <>
+struct ArrayKernels<double>
+{
+  template <class Op>
+  static void apply(const double* a, const double* b, double* r, size_t n, Op op)
+  {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, simd(op, _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; i++)
+      r[i] = op(a[i], b[i]);
+  }
+
+  template <class Op>
+  static void apply(const double* a, double b, double* r, size_t n, Op op)
+  {
+    __m256d vb = _mm256_set1_pd(b);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, simd(op, _mm256_loadu_pd(a + i), vb));
+    for (; i < n; i++)
+      r[i] = op(a[i], b);
+  }
+
+  static void negate(const double* a, double* r, size_t n)
+  {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, _mm256_xor_pd(_mm256_loadu_pd(a + i), sign));
+    for (; i < n; i++)
+      r[i] = -a[i];
+  }
+
+  static double sum(const double* a, size_t n)
+  {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+      s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+    }
+    double res = simd_hsum(_mm256_add_pd(s0, s1));
+    for (; i < n; i++)
+      res += a[i];
+    return res;
+  }
+
+  static double dot(const double* a, const double* b, size_t n)
+  {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      s0 = simd_fma(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+      s1 = simd_fma(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+    }
+    double res = simd_hsum(_mm256_add_pd(s0, s1));
+    for (; i < n; i++)
+      res += a[i] * b[i];
+    return res;
+  }
+
+  static void axpy(double s, const double* a, double* r, size_t n)
+  {
+    __m256d vs = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, simd_fma(vs, _mm256_loadu_pd(a + i), _mm256_loadu_pd(r + i)));
+    for (; i < n; i++)
+      r[i] += s * a[i];
+  }
+};
+#endif
+
+/**
+ * Temporary storage for a result that is assigned to the result array at
+ * the end, because writable raw data is not available for all array types
+ * (e.g. slices). Small results stay on the stack.
+ */
+template <typename T>
+class ResultBuffer
+{
+public:
+  ResultBuffer(size_t n)
+    : _n(n)
+  {
+    _data = n > SMALL_SIZE ? alignedArrayAlloc<T>(n) : _small;
+    std::fill(_data, _data + n, T());
+  }
+
+  ~ResultBuffer()
+  {
+    if (_data != _small)
+      alignedArrayFree(_data, _n);
+  }
+
+  T* data()
+  {
+    return _data;
+  }
+
+private:
+  enum { SMALL_SIZE = 64 };
+  T _small[SMALL_SIZE];
+  T* _data;
+  size_t _n;
+
+  ResultBuffer(const ResultBuffer&);
+  ResultBuffer& operator=(const ResultBuffer&);
+};
+
 //void boost::assertion_failed(char const * expr, char const * function,
 //                             char const * file, long line)
 //{
@@ -244,12 +445,20 @@ void transpose_array(const BaseArray<T>& x, BaseArray<T>& a)
   vector<size_t> ex = x.getDims();
   std::swap(ex[0], ex[1]);
   a.setDims(ex);
-  vector<Slice> sx(ndims);
-  vector<Slice> sa(ndims);
-  for (int i = 1; i <= x.getDim(1); i++) {
-    sa[1] = sx[0] = Slice(i);
-    ArraySlice<T>(a, sa).assign(ArraySliceConst<T>(x, sx));
-  }
+  size_t nelems = x.getNumElems();
+  if (nelems == 0)
+    return;
+  // column major: x(i,j,r) is at i + n1*(j + n2*r), a(j,i,r) at j + n2*(i + n1*r)
+  size_t n1 = ex[1];
+  size_t n2 = ex[0];
+  const T* data = x.getData();
+  ResultBuffer<T> result(nelems);
+  T* aim = result.data();
+  for (size_t r = 0; r < nelems; r += n1 * n2)
+    for (size_t j = 0; j < n2; j++)
+      for (size_t i = 0; i < n1; i++)
+        aim[r + j + n2 * i] = data[r + i + n1 * j];
+  a.assign(aim);
 }
 
 template <typename T>
@@ -261,8 +470,7 @@ void multiply_array(const BaseArray<T>& inputArray, const T &b, BaseArray<T>& ou
 	outputArray.setDims(inputArray.getDims());
 	const T* data = inputArray.getData();
 	T* aim = outputArray.getData();
-	std::transform (data, data + inputArray.getNumElems(),
-                  aim, std::bind2nd(std::multiplies<T>(), b));
+	ArrayKernels<T>::apply(data, b, aim, dim, std::multiplies<T>());
   }
 };
 
@@ -272,39 +480,44 @@ void multiply_array(const BaseArray<T> &leftArray, const BaseArray<T> &rightArra
   size_t leftNumDims = leftArray.getNumDims();
   size_t rightNumDims = rightArray.getNumDims();
   size_t matchDim = rightArray.getDim(1);
-  resultArray.setDims(leftArray.getDims());
   if (leftArray.getDim(leftNumDims) != matchDim)
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Wrong sizes in multiply_array");
+  // all arrays are column major, columns of the left matrix are contiguous
+  const T* leftData = leftArray.getData();
+  const T* rightData = rightArray.getData();
   if (leftNumDims == 1 && rightNumDims == 2) {
     size_t rightDim = rightArray.getDim(2);
-    for (size_t j = 1; j <= rightDim; j++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(k) * rightArray(k, j);
-      resultArray(j) = val;
-    }
+    resultArray.setDims(vector<size_t>(1, rightDim));
+    ResultBuffer<T> result(rightDim);
+    T* aim = result.data();
+    for (size_t j = 0; j < rightDim; j++)
+      aim[j] = ArrayKernels<T>::dot(leftData, rightData + matchDim * j, matchDim);
+    resultArray.assign(aim);
   }
   else if (leftNumDims == 2 && rightNumDims == 1) {
     size_t leftDim = leftArray.getDim(1);
-    for (size_t i = 1; i <= leftDim; i++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(i, k) * rightArray(k);
-      resultArray(i) = val;
-    }
+    resultArray.setDims(vector<size_t>(1, leftDim));
+    ResultBuffer<T> result(leftDim);
+    T* aim = result.data();
+    for (size_t k = 0; k < matchDim; k++)
+      ArrayKernels<T>::axpy(rightData[k], leftData + leftDim * k, aim, leftDim);
+    resultArray.assign(aim);
   }
   else if (leftNumDims == 2 && rightNumDims == 2) {
     size_t leftDim = leftArray.getDim(1);
     size_t rightDim = rightArray.getDim(2);
-    for (size_t i = 1; i <= leftDim; i++) {
-      for (size_t j = 1; j <= rightDim; j++) {
-        T val = T();
-        for (size_t k = 1; k <= matchDim; k++)
-          val += leftArray(i, k) * rightArray(k, j);
-        resultArray(i, j) = val;
-      }
-    }
+    vector<size_t> dims(2);
+    dims[0] = leftDim;
+    dims[1] = rightDim;
+    resultArray.setDims(dims);
+    ResultBuffer<T> result(leftDim * rightDim);
+    T* aim = result.data();
+    for (size_t j = 0; j < rightDim; j++)
+      for (size_t k = 0; k < matchDim; k++)
+        ArrayKernels<T>::axpy(rightData[k + matchDim * j], leftData + leftDim * k,
+                              aim + leftDim * j, leftDim);
+    resultArray.assign(aim);
   }
   else
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
@@ -326,7 +539,7 @@ void multiply_array_elem_wise(const BaseArray<T> &leftArray, const BaseArray<T>
   const T* rightData = rightArray.getData();
   T* aim = resultArray.getData();
 
-  std::transform (leftData, leftData + leftArray.getNumElems(), rightData, aim, std::multiplies<T>());
+  ArrayKernels<T>::apply(leftData, rightData, aim, dimLeft, std::multiplies<T>());
 }
 
 template <typename T>
@@ -339,7 +552,7 @@ void divide_array(const BaseArray<T>& inputArray, const T &b, BaseArray<T>& outp
   }
   const T* data = inputArray.getData();
   T* aim = outputArray.getData();
-  std::transform(data, data + nelems, aim, std::bind2nd(std::divides<T>(), b));
+  ArrayKernels<T>::apply(data, b, aim, nelems, std::divides<T>());
 }
 
 template <typename T>
@@ -357,7 +570,7 @@ void divide_array_elem_wise(const BaseArray<T> &leftArray, const BaseArray<T> &r
   const T* rightData = rightArray.getData();
   T* result = resultArray.getData();
 
-  std::transform (leftData, leftData + leftArray.getNumElems(), rightData, result, std::divides<T>());
+  ArrayKernels<T>::apply(leftData, rightData, result, dimLeft, std::divides<T>());
 }
 
 template <typename T>
@@ -396,7 +609,7 @@ void subtract_array(const BaseArray<T>& leftArray, const BaseArray<T>& rightArra
   const T* data2 = rightArray.getData();
   T* aim = resultArray.getData();
 
-  std::transform (data1, data1 + dimLeft, data2, aim, std::minus<T>());
+  ArrayKernels<T>::apply(data1, data2, aim, dimLeft, std::minus<T>());
 }
 
 template <typename T>
@@ -408,8 +621,7 @@ void subtract_array_scalar(const BaseArray<T>& inputArray, T b, BaseArray<T>& ou
     outputArray.setDims(inputArray.getDims());
     const T* data = inputArray.getData();
     T* aim = outputArray.getData();
-    std::transform (data, data + inputArray.getNumElems(),
-                  aim, std::bind2nd(std::minus<T>(), b));
+    ArrayKernels<T>::apply(data, b, aim, dim, std::minus<T>());
   }
 }
 
@@ -428,7 +640,7 @@ void add_array(const BaseArray<T>& leftArray, const BaseArray<T>& rightArray, Ba
   const T* data2 = rightArray.getData();
   T* aim = resultArray.getData();
 
-  std::transform(data1, data1 + leftArray.getNumElems(), data2, aim, std::plus<T>());
+  ArrayKernels<T>::apply(data1, data2, aim, dimLeft, std::plus<T>());
 }
 
 template <typename T>
@@ -439,28 +651,29 @@ void add_array_scalar(const BaseArray<T>& inputArray, T b, BaseArray<T>& outputA
     outputArray.setDims(inputArray.getDims());
     const T* data = inputArray.getData();
     T* result = outputArray.getData();
-    std::transform (data, data + inputArray.getNumElems(),
-                    result, std::bind2nd(std::plus<T>(), b));
+    ArrayKernels<T>::apply(data, b, result, dim, std::plus<T>());
   }
 }
 
 template <typename T>
 void usub_array(const BaseArray<T>& a, BaseArray<T>& b)
 {
-  b.setDims(a.getDims());
-  size_t numEle =  a.getNumElems();
-  for (size_t i = 1; i <= numEle; i++)
-  {
-    b(i) = -a(i);
-  }
+  // slices can't be resized, but may be the result if they fit already
+  if (b.getDims() != a.getDims())
+    b.setDims(a.getDims());
+  size_t nelems = a.getNumElems();
+  if (nelems == 0)
+    return;
+  ResultBuffer<T> result(nelems);
+  T* aim = result.data();
+  ArrayKernels<T>::negate(a.getData(), aim, nelems);
+  b.assign(aim);
 }
 
 template <typename T>
 T sum_array (const BaseArray<T>& x)
 {
-  const T* data = x.getData();
-  T val = std::accumulate(data, data + x.getNumElems(), T());
-  return val;
+  return ArrayKernels<T>::sum(x.getData(), x.getNumElems());
 }
 
 /**
@@ -472,10 +685,7 @@ T dot_array(const BaseArray<T>& a, const BaseArray<T>& b)
   if(a.getNumDims() != 1  || b.getNumDims() != 1)
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,"error in dot array function. Wrong dimension");
 
-  const T* data1 = a.getData();
-  const T* data2 = b.getData();
-  T r = std::inner_product(data1, data1 + a.getNumElems(), data2, 0.0);
-  return r;
+  return ArrayKernels<T>::dot(a.getData(), b.getData(), a.getNumElems());
 }
 
 /**
@@ -0,0 +1,293 @@
+/** @addtogroup math
+ *  @{
+ */
+
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Math/Krylov.h>
+
+static double dot(int n, const double* x, const double* y)
+{
+  double res = 0.0;
+  for (int i = 0; i < n; i++)
+    res += x[i] * y[i];
+  return res;
+}
+
+static double norm2(int n, const double* x)
+{
+  return std::sqrt(dot(n, x, x));
+}
+
+int solveGMRES(IKrylovOperator& op, int n, const double* b, double* x,
+               double tol, int maxIter, int restart)
+{
+  restart = std::max(1, std::min(restart, n));
+
+  double bnorm = norm2(n, b);
+  if (bnorm == 0.0) {
+    std::fill(x, x + n, 0.0);
+    return 0;
+  }
+
+  // Krylov basis V (column k at V[k*n]) and Hessenberg matrix H (column major)
+  std::vector<double> V((restart + 1) * n), H((restart + 1) * restart);
+  std::vector<double> cs(restart), sn(restart), g(restart + 1), y(restart);
+  std::vector<double> r(n), w(n);
+  int ldh = restart + 1;
+  int iter = 0;
+
+  while (true) {
+    // residual of the current iterate
+    op.apply(x, &r[0]);
+    for (int i = 0; i < n; i++)
+      r[i] = b[i] - r[i];
+    double beta = norm2(n, &r[0]);
+    if (beta <= tol * bnorm)
+      return iter;
+    if (iter >= maxIter)
+      return -1;
+
+    for (int i = 0; i < n; i++)
+      V[i] = r[i] / beta;
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+
+    int k = 0;
+    while (k < restart && iter < maxIter) {
+      double* vk = &V[k * n];
+      double* vk1 = &V[(k + 1) * n];
+      double* hk = &H[k * ldh];
+
+      // w = A M^-1 v_k
+      std::copy(vk, vk + n, vk1);
+      op.precondition(vk1);
+      op.apply(vk1, &w[0]);
+
+      // modified Gram-Schmidt
+      for (int i = 0; i <= k; i++) {
+        hk[i] = dot(n, &w[0], &V[i * n]);
+        for (int l = 0; l < n; l++)
+          w[l] -= hk[i] * V[i * n + l];
+      }
+      hk[k + 1] = norm2(n, &w[0]);
+      bool breakdown = !(hk[k + 1] > 0.0);
+      if (!breakdown)
+        for (int l = 0; l < n; l++)
+          vk1[l] = w[l] / hk[k + 1];
+
+      // apply the previous Givens rotations and compute a new one
+      for (int i = 0; i < k; i++) {
+        double tmp = cs[i] * hk[i] + sn[i] * hk[i + 1];
+        hk[i + 1] = -sn[i] * hk[i] + cs[i] * hk[i + 1];
+        hk[i] = tmp;
+      }
+      double d = std::sqrt(hk[k] * hk[k] + hk[k + 1] * hk[k + 1]);
+      if (d > 0.0) {
+        cs[k] = hk[k] / d;
+        sn[k] = hk[k + 1] / d;
+      }
+      else {
+        cs[k] = 1.0;
+        sn[k] = 0.0;
+      }
+      hk[k] = d;
+      hk[k + 1] = 0.0;
+      g[k + 1] = -sn[k] * g[k];
+      g[k] = cs[k] * g[k];
+
+      k++;
+      iter++;
+      if (breakdown || std::abs(g[k]) <= tol * bnorm)
+        break;
+    }
+
+    // solve the upper triangular system H y = g and update x += M^-1 V y
+    for (int i = k - 1; i >= 0; i--) {
+      double s = g[i];
+      for (int j = i + 1; j < k; j++)
+        s -= H[j * ldh + i] * y[j];
+      y[i] = H[i * ldh + i] != 0.0 ? s / H[i * ldh + i] : 0.0;
+    }
+    std::fill(w.begin(), w.end(), 0.0);
+    for (int j = 0; j < k; j++)
+      for (int l = 0; l < n; l++)
+        w[l] += y[j] * V[j * n + l];
+    op.precondition(&w[0]);
+    for (int l = 0; l < n; l++)
+      x[l] += w[l];
+  }
+}
+
+int solveBiCGStab(IKrylovOperator& op, int n, const double* b, double* x,
+                  double tol, int maxIter)
+{
+  double bnorm = norm2(n, b);
+  if (bnorm == 0.0) {
+    std::fill(x, x + n, 0.0);
+    return 0;
+  }
+
+  std::vector<double> r(n), rhat(n), p(n, 0.0), v(n, 0.0), phat(n), s(n), shat(n), t(n);
+  op.apply(x, &r[0]);
+  for (int i = 0; i < n; i++)
+    r[i] = b[i] - r[i];
+  if (norm2(n, &r[0]) <= tol * bnorm)
+    return 0;
+  rhat = r;
+
+  double rho = 1.0, alpha = 1.0, omega = 1.0;
+  for (int iter = 1; iter <= maxIter; iter++) {
+    double rhoNew = dot(n, &rhat[0], &r[0]);
+    if (rhoNew == 0.0)
+      return -1;
+    double beta = (rhoNew / rho) * (alpha / omega);
+    for (int i = 0; i < n; i++)
+      p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+    phat = p;
+    op.precondition(&phat[0]);
+    op.apply(&phat[0], &v[0]);
+    double rv = dot(n, &rhat[0], &v[0]);
+    if (rv == 0.0)
+      return -1;
+    alpha = rhoNew / rv;
+    for (int i = 0; i < n; i++)
+      s[i] = r[i] - alpha * v[i];
+    if (norm2(n, &s[0]) <= tol * bnorm) {
+      for (int i = 0; i < n; i++)
+        x[i] += alpha * phat[i];
+      return iter;
+    }
+
+    shat = s;
+    op.precondition(&shat[0]);
+    op.apply(&shat[0], &t[0]);
+    double tt = dot(n, &t[0], &t[0]);
+    omega = tt > 0.0 ? dot(n, &t[0], &s[0]) / tt : 0.0;
+    for (int i = 0; i < n; i++) {
+      x[i] += alpha * phat[i] + omega * shat[i];
+      r[i] = s[i] - omega * t[i];
+    }
+    if (norm2(n, &r[0]) <= tol * bnorm)
+      return iter;
+    if (omega == 0.0)
+      return -1;
+    rho = rhoNew;
+  }
+  return -1;
+}
+
+IncompleteLU::IncompleteLU()
+  : _n(0)
+  , _factorized(false)
+{
+}
+
+void IncompleteLU::reset(int n)
+{
+  _n = n;
+  _factorized = false;
+  _colEntries.clear();
+  _rowEntries.clear();
+  _valEntries.clear();
+}
+
+void IncompleteLU::setColumn(int j, const double* column, double dropTol)
+{
+  double colMax = 0.0;
+  for (int i = 0; i < _n; i++)
+    colMax = std::max(colMax, std::abs(column[i]));
+  for (int i = 0; i < _n; i++) {
+    if (i == j || std::abs(column[i]) > dropTol * colMax) {
+      _rowEntries.push_back(i);
+      _colEntries.push_back(j);
+      _valEntries.push_back(column[i]);
+    }
+  }
+}
+
+void IncompleteLU::factorize()
+{
+  int nnz = _rowEntries.size();
+
+  // compressed rows, sorted by column
+  _rowPtr.assign(_n + 1, 0);
+  for (int k = 0; k < nnz; k++)
+    _rowPtr[_rowEntries[k] + 1]++;
+  for (int i = 0; i < _n; i++)
+    _rowPtr[i + 1] += _rowPtr[i];
+  _colIdx.resize(nnz);
+  _val.resize(nnz);
+  std::vector<int> next(_rowPtr.begin(), _rowPtr.end() - 1);
+  for (int k = 0; k < nnz; k++) {
+    int p = next[_rowEntries[k]]++;
+    _colIdx[p] = _colEntries[k];
+    _val[p] = _valEntries[k];
+  }
+  _diag.resize(_n);
+  for (int i = 0; i < _n; i++) {
+    for (int p = _rowPtr[i] + 1; p < _rowPtr[i + 1]; p++) {
+      int c = _colIdx[p];
+      double v = _val[p];
+      int q = p;
+      for (; q > _rowPtr[i] && _colIdx[q - 1] > c; q--) {
+        _colIdx[q] = _colIdx[q - 1];
+        _val[q] = _val[q - 1];
+      }
+      _colIdx[q] = c;
+      _val[q] = v;
+    }
+    for (int p = _rowPtr[i]; p < _rowPtr[i + 1]; p++)
+      if (_colIdx[p] == i)
+        _diag[i] = p;
+  }
+
+  // ILU(0), row by row (IKJ variant)
+  std::vector<int> pos(_n, -1);
+  for (int i = 0; i < _n; i++) {
+    double rowMax = 0.0;
+    for (int p = _rowPtr[i]; p < _rowPtr[i + 1]; p++) {
+      pos[_colIdx[p]] = p;
+      rowMax = std::max(rowMax, std::abs(_val[p]));
+    }
+    for (int p = _rowPtr[i]; p < _diag[i]; p++) {
+      int k = _colIdx[p];
+      _val[p] /= _val[_diag[k]];
+      for (int q = _diag[k] + 1; q < _rowPtr[k + 1]; q++) {
+        int r = pos[_colIdx[q]];
+        if (r >= 0)
+          _val[r] -= _val[p] * _val[q];
+      }
+    }
+    double tiny = rowMax > 0.0 ? 1e-12 * rowMax : 1.0;
+    if (std::abs(_val[_diag[i]]) < tiny)
+      _val[_diag[i]] = _val[_diag[i]] < 0.0 ? -tiny : tiny;
+    for (int p = _rowPtr[i]; p < _rowPtr[i + 1]; p++)
+      pos[_colIdx[p]] = -1;
+  }
+  _factorized = true;
+}
+
+void IncompleteLU::solve(double* x) const
+{
+  for (int i = 0; i < _n; i++)
+    for (int p = _rowPtr[i]; p < _diag[i]; p++)
+      x[i] -= _val[p] * x[_colIdx[p]];
+  for (int i = _n - 1; i >= 0; i--) {
+    for (int p = _diag[i] + 1; p < _rowPtr[i + 1]; p++)
+      x[i] -= _val[p] * x[_colIdx[p]];
+    x[i] /= _val[_diag[i]];
+  }
+}
+
+bool IncompleteLU::isFactorized() const
+{
+  return _factorized;
+}
+
+int IncompleteLU::nnz() const
+{
+  return _val.size();
+}
+/** @} */ // end of math
@@ -0,0 +1,177 @@
+/** @addtogroup math
+ *  @{
+ */
+
+/*
+ * Times the array operations of ArrayOperations.cpp and compares their results
+ * with plain loops over the element access operators.
+ *
+ * usage: ArrayBenchmark [n (default 200)] [repetitions (default 100)]
+ * Vectors have n*n elements, matrices are n x n. The small matrix case uses
+ * 3 x 3 static arrays as they appear in multibody models.
+ */
+
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Math/ArrayOperations.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+
+static double seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static double maxDiff(const BaseArray<double>& a, const BaseArray<double>& b)
+{
+    double err = 0.0;
+    const double* da = a.getData();
+    const double* db = b.getData();
+    for(size_t i=0; i<a.getNumElems(); ++i)
+        err = std::max(err, std::fabs(da[i] - db[i]) / (1.0 + std::fabs(db[i])));
+    return err;
+}
+
+static void report(const char* name, double t, int reps, double err)
+{
+    printf("%-16s %12.4e s per call   max. rel. err. %9.2e\n", name, t / reps, err);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? atoi(argv[1]) : 200;
+    int reps = argc > 2 ? atoi(argv[2]) : 100;
+    size_t nv = n * n;
+    double err, maxErr = 0.0;
+    clock_t start;
+
+    DynArrayDim1<double> x(nv), y(nv), z(nv), ref(nv);
+    DynArrayDim2<double> A(n, n), B(n, n), C(n, n), refC(n, n);
+    DynArrayDim1<double> v(n), w(n), refw(n);
+    for(size_t i=1; i<=nv; ++i) {
+        x(i) = std::sin((double)i);
+        y(i) = 2.0 + std::cos((double)i);
+    }
+    for(size_t i=1; i<=n; ++i) {
+        v(i) = 1.0 / i;
+        for(size_t j=1; j<=n; ++j) {
+            A(i, j) = std::sin((double)(i + 3 * j));
+            B(i, j) = std::cos((double)(2 * i + j));
+        }
+    }
+
+    /* element-wise operations */
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        add_array(x, y, z);
+    for(size_t i=1; i<=nv; ++i)
+        ref(i) = x(i) + y(i);
+    report("add_array", seconds(start), reps, err = maxDiff(z, ref));
+    maxErr = std::max(maxErr, err);
+
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        multiply_array_elem_wise(x, y, z);
+    for(size_t i=1; i<=nv; ++i)
+        ref(i) = x(i) * y(i);
+    report("multiply_elem", seconds(start), reps, err = maxDiff(z, ref));
+    maxErr = std::max(maxErr, err);
+
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        divide_array(x, 3.0, z);
+    for(size_t i=1; i<=nv; ++i)
+        ref(i) = x(i) / 3.0;
+    report("divide_scalar", seconds(start), reps, err = maxDiff(z, ref));
+    maxErr = std::max(maxErr, err);
+
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        usub_array(x, z);
+    for(size_t i=1; i<=nv; ++i)
+        ref(i) = -x(i);
+    report("usub_array", seconds(start), reps, err = maxDiff(z, ref));
+    maxErr = std::max(maxErr, err);
+
+    /* reductions */
+    double s = 0.0, refS = 0.0;
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        s += dot_array(x, y);
+    for(size_t i=1; i<=nv; ++i)
+        refS += x(i) * y(i);
+    report("dot_array", seconds(start), reps, err = std::fabs(s / reps - refS) / (1.0 + std::fabs(refS)));
+    maxErr = std::max(maxErr, err);
+
+    s = refS = 0.0;
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        s += sum_array(x);
+    for(size_t i=1; i<=nv; ++i)
+        refS += x(i);
+    report("sum_array", seconds(start), reps, err = std::fabs(s / reps - refS) / (1.0 + std::fabs(refS)));
+    maxErr = std::max(maxErr, err);
+
+    /* matrix operations */
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        multiply_array(A, v, w);
+    for(size_t i=1; i<=n; ++i) {
+        refw(i) = 0.0;
+        for(size_t k=1; k<=n; ++k)
+            refw(i) += A(i, k) * v(k);
+    }
+    report("matrix*vector", seconds(start), reps, err = maxDiff(w, refw));
+    maxErr = std::max(maxErr, err);
+
+    int matReps = std::max(1, reps / 10);
+    start = clock();
+    for(int r=0; r<matReps; ++r)
+        multiply_array(A, B, C);
+    for(size_t i=1; i<=n; ++i)
+        for(size_t j=1; j<=n; ++j) {
+            refC(i, j) = 0.0;
+            for(size_t k=1; k<=n; ++k)
+                refC(i, j) += A(i, k) * B(k, j);
+        }
+    report("matrix*matrix", seconds(start), matReps, err = maxDiff(C, refC));
+    maxErr = std::max(maxErr, err);
+
+    start = clock();
+    for(int r=0; r<reps; ++r)
+        transpose_array(A, C);
+    for(size_t i=1; i<=n; ++i)
+        for(size_t j=1; j<=n; ++j)
+            refC(j, i) = A(i, j);
+    report("transpose_array", seconds(start), reps, err = maxDiff(C, refC));
+    maxErr = std::max(maxErr, err);
+
+    /* small static matrices */
+    StatArrayDim2<double, 3, 3> R, R2, refR;
+    StatArrayDim1<double, 3> u, Ru;
+    for(size_t i=1; i<=3; ++i) {
+        u(i) = i;
+        for(size_t j=1; j<=3; ++j)
+            R(i, j) = std::cos((double)(i * j));
+    }
+    int smallReps = reps * 10000;
+    start = clock();
+    for(int r=0; r<smallReps; ++r) {
+        multiply_array(R, R, R2);
+        multiply_array(R2, u, Ru);
+    }
+    for(size_t i=1; i<=3; ++i)
+        for(size_t j=1; j<=3; ++j) {
+            refR(i, j) = 0.0;
+            for(size_t k=1; k<=3; ++k)
+                refR(i, j) += R(i, k) * R(k, j);
+        }
+    report("3x3 matrix", seconds(start), smallReps, err = maxDiff(R2, refR));
+    maxErr = std::max(maxErr, err);
+
+    return maxErr < 1e-12 ? 0 : 1;
+}
+/** @} */ // end of math
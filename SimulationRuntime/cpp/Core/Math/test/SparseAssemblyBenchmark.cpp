@@ -0,0 +1,110 @@
+/** @addtogroup math
+ *  @{
+ */
+
+/*
+ * Times the fill of a sparse Jacobian through the element access of
+ * sparsematrix_t, as the generated code did, and through sparse_assembly.
+ * Both have to give the same compressed matrix.
+ *
+ * usage: SparseAssemblyBenchmark [columns (default 5000)] [repetitions (default 100)]
+ * Each column has 10 nonzeros, i.e. 50k nonzeros by default.
+ */
+
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Math/SparseAssembly.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <set>
+
+static double seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static bool equal(const sparsematrix_t& A, const sparsematrix_t& B)
+{
+    if (A.nnz() != B.nnz() || A.size2() != B.size2())
+        return false;
+    for (size_t j = 0; j <= A.size2(); j++)
+        if (A.index1_data()[j] != B.index1_data()[j])
+            return false;
+    for (size_t k = 0; k < A.nnz(); k++)
+        if (A.index2_data()[k] != B.index2_data()[k] || A.value_data()[k] != B.value_data()[k])
+            return false;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 5000;
+    int reps = argc > 2 ? atoi(argv[2]) : 100;
+    const int perColumn = 10;
+
+    /* pattern in the order of the generated code: by columns, rows ascending */
+    std::vector<unsigned int> rows, cols;
+    srand(1);
+    for (int j = 0; j < n; j++) {
+        std::set<unsigned int> column;
+        column.insert(j);
+        while ((int)column.size() < std::min(perColumn, n))
+            column.insert(rand() % n);
+        for (std::set<unsigned int>::iterator it = column.begin(); it != column.end(); it++) {
+            rows.push_back(*it);
+            cols.push_back(j);
+        }
+    }
+    size_t nnz = rows.size();
+    std::vector<double> values(nnz);
+    for (size_t k = 0; k < nnz; k++)
+        values[k] = std::sin((double)k);
+
+    sparsematrix_t A(n, n, nnz), B(n, n, nnz);
+    clock_t start = clock();
+    for (int r = 0; r < reps; r++)
+        for (size_t k = 0; k < nnz; k++)
+            A(rows[k], cols[k]) = values[k] + r;
+    double tAccess = seconds(start);
+
+    sparse_assembly assembly;
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+        assembly.begin(B);
+        for (size_t k = 0; k < nnz; k++)
+            assembly(rows[k], cols[k], values[k] + r);
+        assembly.end();
+    }
+    double tAssembly = seconds(start);
+
+    printf("%d x %d, %d nonzeros\n", n, n, (int)nnz);
+    printf("%-16s %12.4e s per fill\n", "element access", tAccess / reps);
+    printf("%-16s %12.4e s per fill\n", "sparse_assembly", tAssembly / reps);
+    if (!equal(A, B) || assembly.size() != nnz)
+        return 1;
+
+    /* a different sequence is inserted and becomes the new pattern */
+    assembly.begin(B);
+    for (size_t k = nnz; k-- > 0;)
+        assembly(rows[k], cols[k], -1.0);
+    assembly(0, n - 1, 2.0);
+    assembly.end();
+    for (size_t k = 0; k < nnz; k++)
+        A(rows[k], cols[k]) = -1.0;
+    A(0, n - 1) = 2.0;
+    if (!equal(A, B))
+        return 2;
+    assembly.begin(B);
+    for (size_t k = nnz; k-- > 0;)
+        assembly(rows[k], cols[k], 3.0);
+    assembly(0, n - 1, 4.0);
+    assembly.end();
+    for (size_t k = 0; k < nnz; k++)
+        A(rows[k], cols[k]) = 3.0;
+    A(0, n - 1) = 4.0;
+    return equal(A, B) ? 0 : 3;
+}
+/** @} */ // end of math
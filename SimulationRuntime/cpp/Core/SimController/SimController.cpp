@@ -8,6 +8,8 @@
 #include <Core/SimController/SimController.h>
 #include <Core/SimController/Configuration.h>
 #include <Core/SimController/SimObjects.h>
+#include <fstream>
+#include <sstream>
 #if defined(OMC_BUILD) || defined(SIMSTER_BUILD)
 #include "LibrariesConfig.h"
 #endif
@@ -16,6 +18,7 @@
 SimController::SimController(PATH library_path, PATH modelicasystem_path)
     : SimControllerPolicy(library_path, modelicasystem_path, library_path)
     , _initialized(false)
+    , _nextEnsembleMember(0)
 {
     _config = shared_ptr<Configuration>(new Configuration(_library_path, _config_path, modelicasystem_path));
     _sim_objects = shared_ptr<ISimObjects>(new SimObjects(_library_path,modelicasystem_path,_config->getGlobalSettings().get()));
@@ -65,6 +68,7 @@ weak_ptr<IMixedSystem> SimController::LoadSystem(string modelLib,string modelKey
      //create system
     shared_ptr<IMixedSystem> system = createSystem(modelLib, modelKey, _config->getGlobalSettings().get(), _sim_objects);
     _systems[modelKey] = system;
+    _modelLibs[modelKey] = modelLib;
     return system;
 }
 
@@ -160,8 +164,42 @@ void SimController::calcOneStep()
     _simMgr->runSingleStep();
 }
 
+void SimController::setGlobalSettings(SimSettings& simsettings, IGlobalSettings* global_settings)
+{
+    global_settings->setStartTime(simsettings.start_time);
+    global_settings->setEndTime(simsettings.end_time);
+    global_settings->sethOutput(simsettings.step_size);
+    global_settings->setResultsFileName(simsettings.outputfile_name);
+    global_settings->setSelectedLinSolver(simsettings.linear_solver_name);
+    global_settings->setSelectedNonLinSolver(simsettings.nonlinear_solver_name);
+    global_settings->setSelectedSolver(simsettings.solver_name);
+    global_settings->setLogSettings(simsettings.logSettings);
+    global_settings->setAlarmTime(simsettings.timeOut);
+    global_settings->setOutputPointType(simsettings.outputPointType);
+    global_settings->setOutputFormat(simsettings.outputFormat);
+    global_settings->setEmitResults(simsettings.emitResults);
+    global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
+    global_settings->setNonLinearSolverKrylovMethod(simsettings.nonLinearSolverKrylovMethod);
+    global_settings->setNonLinearSolverPreconditioning(simsettings.nonLinearSolverPreconditioning);
+    global_settings->setSolverThreads(simsettings.solverThreads);
+}
+
+void SimController::setSolverSettings(SimSettings& simsettings, ISolverSettings* solver_settings)
+{
+    solver_settings->setLowerLimit(simsettings.lower_limit);
+    solver_settings->sethInit(simsettings.lower_limit);
+    solver_settings->setUpperLimit(simsettings.upper_limit);
+    solver_settings->setRTol(simsettings.tolerance);
+    solver_settings->setATol(simsettings.tolerance);
+}
+
 void SimController::Start(SimSettings simsettings, string modelKey)
 {
+    if(!simsettings.ensembleFile.empty())
+    {
+        StartEnsemble(readEnsembleFile(simsettings), modelKey, simsettings.ensembleThreads);
+        return;
+    }
     try
     {
         #ifdef RUNTIME_PROFILING
@@ -176,28 +214,9 @@ void SimController::Start(SimSettings simsettings, string modelKey)
 
         shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
 
-        global_settings->setStartTime(simsettings.start_time);
-        global_settings->setEndTime(simsettings.end_time);
-        global_settings->sethOutput(simsettings.step_size);
-        global_settings->setResultsFileName(simsettings.outputfile_name);
-        global_settings->setSelectedLinSolver(simsettings.linear_solver_name);
-        global_settings->setSelectedNonLinSolver(simsettings.nonlinear_solver_name);
-        global_settings->setSelectedSolver(simsettings.solver_name);
-        global_settings->setLogSettings(simsettings.logSettings);
-        global_settings->setAlarmTime(simsettings.timeOut);
-        global_settings->setOutputPointType(simsettings.outputPointType);
-        global_settings->setOutputFormat(simsettings.outputFormat);
-        global_settings->setEmitResults(simsettings.emitResults);
-        global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
-        global_settings->setSolverThreads(simsettings.solverThreads);
+        setGlobalSettings(simsettings, global_settings.get());
         /*shared_ptr<SimManager>*/ _simMgr = shared_ptr<SimManager>(new SimManager(mixedsystem, _config.get()));
-
-        ISolverSettings* solver_settings = _config->getSolverSettings();
-        solver_settings->setLowerLimit(simsettings.lower_limit);
-        solver_settings->sethInit(simsettings.lower_limit);
-        solver_settings->setUpperLimit(simsettings.upper_limit);
-        solver_settings->setRTol(simsettings.tolerance);
-        solver_settings->setATol(simsettings.tolerance);
+        setSolverSettings(simsettings, _config->getSolverSettings());
         #ifdef RUNTIME_PROFILING
         if(MeasureTime::getInstance() != NULL)
         {
@@ -255,9 +274,183 @@ void SimController::Start(SimSettings simsettings, string modelKey)
     }
 }
 
+/**
+ * Reads the members of an ensemble from simsettings.ensembleFile.
+ * Every line that is neither empty nor starts with # describes one member:
+ *   <results file> [start-time=<t>] [stop-time=<t>] [tolerance=<tol>] [solver=<name>]
+ *                  [real[<i>]=<value>] [int[<i>]=<value>] [bool[<i>]=<0|1>]
+ * The remaining settings are taken from simsettings, the start values are
+ * addressed by their index in the real, int and bool variables of the model.
+ */
+std::vector<EnsembleMember> SimController::readEnsembleFile(SimSettings& simsettings)
+{
+    std::ifstream file(simsettings.ensembleFile.c_str());
+    if(!file)
+        throw ModelicaSimulationError(SIMMANAGER, "Cannot open ensemble file " + simsettings.ensembleFile);
+
+    std::vector<EnsembleMember> members;
+    string line;
+    int lineNumber = 0;
+    while(std::getline(file, line))
+    {
+        lineNumber++;
+        std::istringstream is(line);
+        string token;
+        if(!(is >> token) || token[0] == '#')
+            continue;
+
+        EnsembleMember member;
+        member.simsettings = simsettings;
+        member.simsettings.ensembleFile = "";
+        member.simsettings.outputfile_name = token;
+        while(is >> token)
+        {
+            size_t sep = token.find('=');
+            string key = token.substr(0, sep);
+            std::istringstream value(sep == string::npos ? "" : token.substr(sep + 1));
+            unsigned long index;
+            bool known = sep != string::npos;
+            if(key == "start-time")
+                value >> member.simsettings.start_time;
+            else if(key == "stop-time")
+                value >> member.simsettings.end_time;
+            else if(key == "tolerance")
+                value >> member.simsettings.tolerance;
+            else if(key == "solver")
+                value >> member.simsettings.solver_name;
+            else if(sscanf(key.c_str(), "real[%lu]", &index) == 1)
+                value >> member.startValues.realValues[index];
+            else if(sscanf(key.c_str(), "int[%lu]", &index) == 1)
+                value >> member.startValues.intValues[index];
+            else if(sscanf(key.c_str(), "bool[%lu]", &index) == 1)
+                value >> member.startValues.boolValues[index];
+            else
+                known = false;
+            if(!known || !value)
+            {
+                std::ostringstream error;
+                error << "Invalid entry " << token << " in line " << lineNumber << " of ensemble file " << simsettings.ensembleFile;
+                throw ModelicaSimulationError(SIMMANAGER, error.str());
+            }
+        }
+        // the step size was computed from the number of intervals of the whole simulation
+        if(simsettings.end_time > simsettings.start_time)
+            member.simsettings.step_size = simsettings.step_size * (member.simsettings.end_time - member.simsettings.start_time) / (simsettings.end_time - simsettings.start_time);
+        members.push_back(member);
+    }
+    return members;
+}
+
+void SimController::StartEnsemble(std::vector<EnsembleMember> members, string modelKey, int threads)
+{
+    std::map<string, string>::iterator lib = _modelLibs.find(modelKey);
+    SimObjects* sim_objects = dynamic_cast<SimObjects*>(_sim_objects.get());
+    if(lib == _modelLibs.end() || !sim_objects)
+        throw ModelicaSimulationError(SIMMANAGER, "Ensemble simulation needs a system loaded with LoadSystem: " + modelKey);
+
+    // configurations are referenced by the SimManagers and have to outlive them
+    std::vector<shared_ptr<Configuration> > configs;
+    std::vector<string> errors(members.size());
+    try
+    {
+        // the instances are created one after another, because the factories
+        // loading the system and solver libraries are not thread-safe
+        _ensembleMgrs.clear();
+        for(size_t i = 0; i < members.size(); i++)
+        {
+            EnsembleMember& member = members[i];
+            shared_ptr<Configuration> config(new Configuration(_library_path, _config_path, _modelicasystem_path));
+            IGlobalSettings* global_settings = config->getGlobalSettings().get();
+            setGlobalSettings(member.simsettings, global_settings);
+
+            // own variables, algloop solvers and writer; the system library is already loaded
+            shared_ptr<ISimObjects> simObjects(new SimObjects(*sim_objects, global_settings));
+            shared_ptr<IMixedSystem> system = createSystem(lib->second, modelKey, global_settings, simObjects);
+
+            // the start values are replaced after the init file was read by the initialization of the system
+            const StartValueOverrides& overrides = member.startValues;
+            shared_ptr<ISimVars> simVars = simObjects->getSimVars(modelKey);
+            try
+            {
+                // the maps are sorted, checking the largest indices is enough
+                if(!overrides.realValues.empty())
+                    simVars->getRealVar(overrides.realValues.rbegin()->first);
+                if(!overrides.intValues.empty())
+                    simVars->getIntVar(overrides.intValues.rbegin()->first);
+                if(!overrides.boolValues.empty())
+                    simVars->getBoolVar(overrides.boolValues.rbegin()->first);
+            }
+            catch(std::runtime_error& ex)
+            {
+                throw ModelicaSimulationError(SIMMANAGER, string("Start value override failed for ") + member.simsettings.outputfile_name + ": " + ex.what());
+            }
+            global_settings->setStartValueOverrides(overrides);
+
+            shared_ptr<SimManager> simMgr(new SimManager(system, config.get()));
+            setSolverSettings(member.simsettings, config->getSolverSettings());
+            configs.push_back(config);
+            _ensembleMgrs.push_back(simMgr);
+        }
+
+        _nextEnsembleMember = 0;
+        #if defined(USE_THREAD)
+        if(threads <= 0)
+            threads = thread::hardware_concurrency();
+        threads = std::max(1, std::min(threads, (int)members.size()));
+        std::vector<shared_ptr<thread> > workers;
+        for(int i = 1; i < threads; i++)
+            workers.push_back(shared_ptr<thread>(new thread(&SimController::runEnsembleMembers, this, &members, &errors)));
+        runEnsembleMembers(&members, &errors);
+        for(size_t i = 0; i < workers.size(); i++)
+            workers[i]->join();
+        #else
+        runEnsembleMembers(&members, &errors);
+        #endif
+    }
+    catch(...)
+    {
+        _ensembleMgrs.clear();
+        throw;
+    }
+    _ensembleMgrs.clear();
+
+    string error;
+    for(size_t i = 0; i < errors.size(); i++)
+        if(!errors[i].empty())
+            error += errors[i] + "\n";
+    if(!error.empty())
+        throw ModelicaSimulationError(SIMMANAGER, error);
+}
+
+/**
+ * Simulates the ensemble members that are not yet taken by another worker.
+ * Errors are stored per member, so that the other members can be finished.
+ */
+void SimController::runEnsembleMembers(std::vector<EnsembleMember>* members, std::vector<string>* errors)
+{
+    for(int i = _nextEnsembleMember++; i < (int)_ensembleMgrs.size(); i = _nextEnsembleMember++)
+    {
+        try
+        {
+            _ensembleMgrs[i]->initialize();
+            _ensembleMgrs[i]->runSimulation();
+        }
+        catch(ModelicaSimulationError& ex)
+        {
+            (*errors)[i] = add_error_info(string("Simulation failed for ") + (*members)[i].simsettings.outputfile_name, ex.what(), ex.getErrorID());
+        }
+        catch(std::exception& ex)
+        {
+            (*errors)[i] = string("Simulation failed for ") + (*members)[i].simsettings.outputfile_name + ": " + ex.what();
+        }
+    }
+}
+
 void SimController::Stop()
 {
     if(_simMgr)
     _simMgr->stopSimulation();
+    for(size_t i = 0; i < _ensembleMgrs.size(); i++)
+        _ensembleMgrs[i]->stopSimulation();
 }
 /** @} */ // end of coreSimcontroller
@@ -29,6 +29,20 @@ SimObjects::SimObjects(SimObjects& instance) : SimObjectPolicy(instance)
     _write_output = instance.getWriter();
 }
 
+SimObjects::SimObjects(SimObjects& instance, IGlobalSettings* globalSettings)
+    : SimObjectPolicy(instance)
+    , _globalSettings(globalSettings)
+{
+    //clone sim_data and sim_vars, the writer is created by LoadWriter
+    for(std::map<string, shared_ptr<ISimData> >::iterator it = instance._sim_data.begin(); it != instance._sim_data.end(); it++)
+        _sim_data.insert(pair<string, shared_ptr<ISimData> >(it->first, shared_ptr<ISimData>(it->second->clone())));
+
+    for(std::map<string, shared_ptr<ISimVars> >::iterator it = instance._sim_vars.begin(); it != instance._sim_vars.end(); it++)
+        _sim_vars.insert(pair<string, shared_ptr<ISimVars> >(it->first, shared_ptr<ISimVars>(it->second->clone())));
+
+    _algloopsolverfactory = createAlgLoopSolverFactory(globalSettings);
+}
+
 SimObjects::~SimObjects()
 {
 
@@ -20,6 +20,8 @@ GlobalSettings::GlobalSettings()
   , _resultsfile_name("results.csv")
   , _endless_sim(false)
   , _nonLinSolverContinueOnError(false)
+  , _nonLinSolverPreconditioning(true)
+  , _nonLinSolverKrylovMethod(KRYLOV_NONE)
   , _outputPointType(OPT_ALL)
   , _alarm_time(0)
   , _outputFormat(MAT)
@@ -202,6 +204,26 @@ bool GlobalSettings::getNonLinearSolverContinueOnError()
   return _nonLinSolverContinueOnError;
 }
 
+void GlobalSettings::setNonLinearSolverKrylovMethod(KrylovMethod method)
+{
+  _nonLinSolverKrylovMethod = method;
+}
+
+KrylovMethod GlobalSettings::getNonLinearSolverKrylovMethod()
+{
+  return _nonLinSolverKrylovMethod;
+}
+
+void GlobalSettings::setNonLinearSolverPreconditioning(bool value)
+{
+  _nonLinSolverPreconditioning = value;
+}
+
+bool GlobalSettings::getNonLinearSolverPreconditioning()
+{
+  return _nonLinSolverPreconditioning;
+}
+
 void GlobalSettings::setSolverThreads(int val)
 {
   _solverThreads = val;
@@ -212,6 +234,16 @@ int GlobalSettings::getSolverThreads()
   return _solverThreads;
 }
 
+void GlobalSettings::setStartValueOverrides(const StartValueOverrides& overrides)
+{
+  _startValueOverrides = overrides;
+}
+
+const StartValueOverrides& GlobalSettings::getStartValueOverrides()
+{
+  return _startValueOverrides;
+}
+
  OutputFormat GlobalSettings::getOutputFormat()
  {
      return _outputFormat;
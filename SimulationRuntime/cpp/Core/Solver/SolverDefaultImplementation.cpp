@@ -11,6 +11,7 @@
 #include <Core/Math/Constants.h>
 #include <Core/System/FactoryExport.h>
 #include <Core/Utils/extension/logger.hpp>
+#include <Core/Utils/numeric/bindings/ublas/matrix_sparse.hpp>
 
 SolverDefaultImplementation::SolverDefaultImplementation(IMixedSystem* system, ISolverSettings* settings)
     : SimulationMonitor()
@@ -231,5 +232,91 @@ void SolverDefaultImplementation::updateEventState()
     _tLastSuccess = _tCurrent;         // Concurrently occured events are in the time tollerance
     setZeroState();                     // Upate status of events vector
   }
+}
+bool SolverDefaultImplementation::initializeSparsePattern(const string& solverName, int dim, int& nonzeros, int*& leadindex, int*& index,
+                                                          int& maxColors, int*& colorOfColumn)
+{
+  // the sparsity pattern is only provided by systems in sparse matrix format
+  sparsematrix_t* A;
+  try
+  {
+    A = &_system->getSparseJacobian();
+  }
+  catch (std::exception& ex)
+  {
+    LOGGER_WRITE(solverName + ": no sparsity pattern of the Jacobian available: " + ex.what(), LC_SOLVER, LL_DEBUG);
+    return false;
+  }
+  if ((long int)A->size1() != dim || (long int)A->size2() != dim)
+    return false;
+
+  nonzeros = A->nnz();
+  delete [] leadindex;
+  delete [] index;
+  leadindex = new int[dim + 1];
+  index = new int[std::max(nonzeros, 1)];
+
+  // trailing empty columns are not stored in the compressed matrix
+  int filled = std::min((long int)A->filled1(), (long int)dim + 1);
+  memcpy(leadindex, boost::numeric::bindings::begin_compressed_index_major(*A), filled * sizeof(int));
+  std::fill(leadindex + filled, leadindex + dim + 1, nonzeros);
+  memcpy(index, boost::numeric::bindings::begin_index_minor(*A), nonzeros * sizeof(int));
+
+  delete [] colorOfColumn;
+  colorOfColumn = new int[dim];
+  maxColors = _system->getAMaxColors();
+  if (maxColors > 0)
+    _system->getAColorOfColumn(colorOfColumn, dim);
+  else
+  {
+    // no coloring generated: one column per color
+    for (int k = 0; k < dim; k++)
+      colorOfColumn[k] = k + 1;
+    maxColors = dim;
+  }
+
+  LOGGER_WRITE(solverName + ": Jacobian with " + to_string(nonzeros) + " nonzeros and "
+               + to_string(maxColors) + " colors", LC_SOLVER, LL_DEBUG);
+  return true;
+}
+
+int SolverDefaultImplementation::insertDiagonal(int dim, int nonzeros, const int* leadindex, const int* index,
+                                                int*& iterLeadindex, int*& iterIndex, int*& pos, int*& diag)
+{
+  delete [] iterLeadindex;
+  delete [] iterIndex;
+  delete [] pos;
+  delete [] diag;
+  iterLeadindex = new int[dim + 1];
+  iterIndex = new int[nonzeros + dim];
+  pos = new int[std::max(nonzeros, 1)];
+  diag = new int[dim];
+
+  int n = 0;
+  for (int k = 0; k < dim; k++)
+  {
+    iterLeadindex[k] = n;
+    diag[k] = -1;
+    for (int j = leadindex[k]; j < leadindex[k+1]; j++)
+    {
+      int l = index[j];
+      if (diag[k] < 0 && l > k)
+      {
+        diag[k] = n;
+        iterIndex[n++] = k;
+      }
+      if (l == k)
+        diag[k] = n;
+      pos[j] = n;
+      iterIndex[n++] = l;
+    }
+    if (diag[k] < 0)
+    {
+      diag[k] = n;
+      iterIndex[n++] = k;
+    }
+  }
+  iterLeadindex[dim] = n;
+  return n;
 }
  /** @} */ // end of coreSolver
@@ -47,6 +47,8 @@ shared_ptr<IAlgLoopSolver> AlgLoopSolverFactory::createNonLinearAlgLoopSolver(IN
     string nonlinsolver_name = _global_settings->getSelectedNonLinSolver();
     shared_ptr<INonLinSolverSettings> algsolversetting= createNonLinSolverSettings(nonlinsolver_name);
     algsolversetting->setContinueOnError(_global_settings->getNonLinearSolverContinueOnError());
+    algsolversetting->setKrylovMethod(_global_settings->getNonLinearSolverKrylovMethod());
+    algsolversetting->setUsePreconditioner(_global_settings->getNonLinearSolverPreconditioning());
     _algsolversettings.push_back(algsolversetting);
 
     shared_ptr<IAlgLoopSolver> algsolver= createNonLinSolver(algLoop,nonlinsolver_name,algsolversetting);
@@ -12,6 +12,7 @@
 DiscreteEvents::DiscreteEvents(shared_ptr<ISimVars> sim_vars)
 : _sim_vars(sim_vars)
 {
+  initVarPointers();
 }
 
 DiscreteEvents::~DiscreteEvents(void)
@@ -27,22 +28,34 @@ void DiscreteEvents::initialize()
 {
 
   _sim_vars->initPreVariables();
+  initVarPointers();
   //_preVars->_pre_vars.resize((boost::extents[_preVars->_pre_real_vars_idx.size()+_preVars->_pre_int_vars_idx.size()+_preVars->_pre_bool_vars_idx.size()]));
 }
 
-/*
-void DiscreteEvents::savePreVars(double vars[], unsigned int n)
+void DiscreteEvents::initVarPointers()
 {
-  _preVars->_pre_vars.assign(vars,vars+n);
+  _real_vars = _sim_vars->getRealVarsVector();
+  _int_vars = _sim_vars->getIntVarsVector();
+  _bool_vars = _sim_vars->getBoolVarsVector();
+  _pre_real_vars = _sim_vars->getPreRealVarsVector();
+  _pre_int_vars = _sim_vars->getPreIntVarsVector();
+  _pre_bool_vars = _sim_vars->getPreBoolVarsVector();
 }
+
+/**
+Copies all real, int and bool variables to the pre variables
 */
+void DiscreteEvents::savePreVars()
+{
+  _sim_vars->savePreVariables();
+}
 
 /**
 Saves a variable in _sim_vars->_pre_real_vars vector
 */
 void DiscreteEvents::save(double& var)
 {
-  _sim_vars->getPreVar(var) = var;
+  pre(var) = var;
 }
 
 /**
@@ -50,7 +63,7 @@ Saves a variable in _sim_vars->_pre_int_vars vector
 */
 void DiscreteEvents::save(int& var)
 {
-  _sim_vars->getPreVar(var) = var;
+  pre(var) = var;
 }
 
 /**
@@ -58,103 +71,22 @@ Saves a variable in _sim_vars->_pre_bool_vars vector
 */
 void DiscreteEvents::save(bool& var)
 {
-  _sim_vars->getPreVar(var) = var;
-}
-
-/**
-Implementation of the Modelica pre  operator
-*/
-double& DiscreteEvents::pre(const double& var)
-{
-  return _sim_vars->getPreVar(var);
-}
-
-/**
-Implementation of the Modelica pre  operator
-*/
-int& DiscreteEvents::pre(const int& var)
-{
-  return _sim_vars->getPreVar(var);
-}
-
-/**
-Implementation of the Modelica pre  operator
-*/
-bool& DiscreteEvents::pre(const bool& var)
-{
-  return _sim_vars->getPreVar(var);
-}
-
-/**
-Implementation of the Modelica edge  operator
-Returns true for a variable when it  changes from false to true
-*/
-bool DiscreteEvents::edge(double& var)
-{
-  return var && !pre(var);
-}
-
-/**
-Implementation of the Modelica edge  operator
-Returns true for a variable when it  changes from false to true
-*/
-bool DiscreteEvents::edge(int& var)
-{
-  return var && !pre(var);
-}
-
-/**
-Implementation of the Modelica edge  operator
-Returns true for a variable when it  changes from false to true
-*/
-bool DiscreteEvents::edge(bool& var)
-{
-  return var && !pre(var);
-}
-
-/**
-Implementation of the Modelica change  operator
-Returns true for a variable when it change value
-*/
-bool DiscreteEvents::change(double& var)
-{
-  return var != pre(var);
-}
-
-/**
-Implementation of the Modelica change  operator
-Returns true for a variable when it change value
-*/
-bool DiscreteEvents::change(int& var)
-{
-  return var != pre(var);
-}
-
-/**
-Implementation of the Modelica change  operator
-Returns true for a variable when it change value
-*/
-bool DiscreteEvents::change(bool& var)
-{
-  return var != pre(var);
+  pre(var) = var;
 }
 
 bool DiscreteEvents::changeDiscreteVar(double& var)
 {
-  double& pre_var = _sim_vars->getPreVar(var);
-  return var != pre_var;
+  return var != pre(var);
 }
 
 bool DiscreteEvents::changeDiscreteVar(int& var)
 {
-  int& pre_var = _sim_vars->getPreVar(var);
-  return var != pre_var;
+  return var != pre(var);
 }
 
 bool DiscreteEvents::changeDiscreteVar(bool& var)
 {
-  bool& pre_var = _sim_vars->getPreVar(var);
-  return var != pre_var;
+  return var != pre(var);
 }
 
 /** @} */ // end of coreSystem
@@ -9,6 +9,7 @@
 #include <Core/System/SimVars.h>
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/lambda.hpp>
+#include <cstring>
 
 /**
 * Constructor for SimVars, stores all model variable in continuous block of memory
@@ -439,12 +440,13 @@ void SimVars::initStringAliasArray(std::vector<int> indices, string* ref_data[])
 */
 void SimVars::savePreVariables()
 {
+	//the blocks are contiguous and aligned, one memcpy per type
 	if(_dim_real>0)
-		std::copy(_real_vars, _real_vars + _dim_real, _pre_real_vars);
+		memcpy(_pre_real_vars, _real_vars, sizeof(double) * _dim_real);
 	if(_dim_int>0)
-		std::copy(_int_vars, _int_vars + _dim_int, _pre_int_vars);
+		memcpy(_pre_int_vars, _int_vars, sizeof(int) * _dim_int);
 	if (_dim_bool > 0)
-		std::copy(_bool_vars, _bool_vars + _dim_bool, _pre_bool_vars);
+		memcpy(_pre_bool_vars, _bool_vars, sizeof(bool) * _dim_bool);
 }
 /**
 *  \brief Initializes access to pre variables
@@ -473,6 +475,21 @@ bool& SimVars::getPreVar(const bool& var)
 	return _pre_bool_vars[i];
 }
 
+double* SimVars::getPreRealVarsVector() const
+{
+	return _pre_real_vars;
+}
+
+int* SimVars::getPreIntVarsVector() const
+{
+	return _pre_int_vars;
+}
+
+bool* SimVars::getPreBoolVarsVector() const
+{
+	return _pre_bool_vars;
+}
+
 /**\brief returns a pointer to a real simvar variable in simvar array
 *  \param [in] i index  of simvar in simvar array
 *  \return pointer to simvar
@@ -0,0 +1,277 @@
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Utils/extension/FactoryExport.h>
+#include <Core/Utils/extension/logger.hpp>
+#include <Core/Utils/extension/adaptive_scheduler.hpp>
+
+#ifdef USE_THREAD
+
+#if !defined(USE_CPP_03)
+  #define ADAPTIVE_SCHEDULER_YIELD() std::this_thread::yield()
+#else
+  #define ADAPTIVE_SCHEDULER_YIELD() boost::this_thread::yield()
+#endif
+
+// spins of an idle thread before it starts to yield
+#define ADAPTIVE_SCHEDULER_SPINS 4096
+
+AdaptiveTaskGraph::AdaptiveTaskGraph(const std::string& name, unsigned int numTasks, unsigned int numThreads, unsigned int warmupEvaluations)
+  : _name(name)
+  , _numTasks(numTasks)
+  , _numThreads(std::max(numThreads, 1u))
+  , _warmupEvaluations(warmupEvaluations)
+  , _evaluations(0)
+  , _generation(0)
+  , _measure(false)
+  , _funcs(numTasks)
+  , _estimatedCosts(numTasks, 1.0)
+  , _parents(numTasks)
+  , _children(numTasks)
+  , _threadTasks(_numThreads)
+  , _waitFor(numTasks)
+  , _states(new TaskState[numTasks])
+  , _failed(false)
+{
+  for (unsigned int i = 0; i < numTasks; i++)
+  {
+    _states[i].generation.store(0);
+    _states[i].ticks = 0;
+  }
+}
+
+AdaptiveTaskGraph::~AdaptiveTaskGraph()
+{
+  delete [] _states;
+}
+
+void AdaptiveTaskGraph::setTask(unsigned int taskIdx, function<void()> func, double estimatedCost)
+{
+  _funcs[taskIdx] = func;
+  _estimatedCosts[taskIdx] = estimatedCost;
+}
+
+void AdaptiveTaskGraph::addDependency(unsigned int parentIdx, unsigned int childIdx)
+{
+  _parents[childIdx].push_back(parentIdx);
+  _children[parentIdx].push_back(childIdx);
+}
+
+void AdaptiveTaskGraph::initialize()
+{
+  schedule(_estimatedCosts);
+}
+
+/**
+ * List scheduling with the bottom level (longest path to an exit task) as
+ * priority. Each task is assigned to the thread on which it can start first.
+ * Since every cost is positive, a parent always has a higher priority than its
+ * children, so the tasks of a thread are in topological order.
+ */
+void AdaptiveTaskGraph::schedule(const std::vector<double>& costs)
+{
+  std::vector<double> cost(_numTasks);
+  double minCost = 0.0;
+  for (unsigned int i = 0; i < _numTasks; i++)
+    if (costs[i] > 0.0 && (minCost == 0.0 || costs[i] < minCost))
+      minCost = costs[i];
+  for (unsigned int i = 0; i < _numTasks; i++)
+    cost[i] = costs[i] > 0.0 ? costs[i] : (minCost > 0.0 ? minCost : 1.0);
+
+  // bottom levels, computed in reverse topological order (Kahn on the reversed graph)
+  std::vector<double> bottomLevel(_numTasks, 0.0);
+  std::vector<unsigned int> numOpenChildren(_numTasks);
+  std::vector<unsigned int> stack;
+  for (unsigned int i = 0; i < _numTasks; i++)
+  {
+    numOpenChildren[i] = _children[i].size();
+    if (numOpenChildren[i] == 0)
+      stack.push_back(i);
+  }
+  while (!stack.empty())
+  {
+    unsigned int task = stack.back();
+    stack.pop_back();
+    double maxChild = 0.0;
+    for (size_t c = 0; c < _children[task].size(); c++)
+      maxChild = std::max(maxChild, bottomLevel[_children[task][c]]);
+    bottomLevel[task] = cost[task] + maxChild;
+    for (size_t p = 0; p < _parents[task].size(); p++)
+      if (--numOpenChildren[_parents[task][p]] == 0)
+        stack.push_back(_parents[task][p]);
+  }
+
+  std::vector<std::pair<double, unsigned int> > order(_numTasks);
+  for (unsigned int i = 0; i < _numTasks; i++)
+    order[i] = std::make_pair(-bottomLevel[i], i);
+  std::sort(order.begin(), order.end());
+
+  std::vector<double> threadReady(_numThreads, 0.0);
+  std::vector<double> finishTime(_numTasks, 0.0);
+  std::vector<unsigned int> assignment(_numTasks, 0);
+  for (unsigned int t = 0; t < _numThreads; t++)
+    _threadTasks[t].clear();
+
+  for (unsigned int i = 0; i < _numTasks; i++)
+  {
+    unsigned int task = order[i].second;
+    double dataReady = 0.0;
+    for (size_t p = 0; p < _parents[task].size(); p++)
+      dataReady = std::max(dataReady, finishTime[_parents[task][p]]);
+
+    unsigned int bestThread = 0;
+    double bestStart = std::max(threadReady[0], dataReady);
+    for (unsigned int t = 1; t < _numThreads; t++)
+    {
+      double start = std::max(threadReady[t], dataReady);
+      if (start < bestStart)
+      {
+        bestStart = start;
+        bestThread = t;
+      }
+    }
+    assignment[task] = bestThread;
+    finishTime[task] = bestStart + cost[task];
+    threadReady[bestThread] = finishTime[task];
+    _threadTasks[bestThread].push_back(task);
+  }
+
+  for (unsigned int i = 0; i < _numTasks; i++)
+  {
+    _waitFor[i].clear();
+    for (size_t p = 0; p < _parents[i].size(); p++)
+      if (assignment[_parents[i][p]] != assignment[i])
+        _waitFor[i].push_back(_parents[i][p]);
+  }
+
+  double criticalPath = 0.0, makespan = 0.0, sum = 0.0;
+  for (unsigned int i = 0; i < _numTasks; i++)
+  {
+    criticalPath = std::max(criticalPath, bottomLevel[i]);
+    sum += cost[i];
+  }
+  for (unsigned int t = 0; t < _numThreads; t++)
+    makespan = std::max(makespan, threadReady[t]);
+  LOGGER_WRITE("Adaptive scheduler: " + _name + " scheduled to " + boost::lexical_cast<std::string>(_numThreads) + " threads, estimated speedup "
+               + boost::lexical_cast<std::string>(makespan > 0.0 ? sum / makespan : 1.0) + " (critical path bound "
+               + boost::lexical_cast<std::string>(criticalPath > 0.0 ? sum / criticalPath : 1.0) + ")",
+               LC_OTHER, LL_INFO);
+}
+
+void AdaptiveTaskGraph::beginEvaluation()
+{
+  _generation++;
+  // the first evaluations are dominated by initialization and cold caches
+  _measure = _evaluations >= _warmupEvaluations / 5 && _evaluations < _warmupEvaluations;
+}
+
+void AdaptiveTaskGraph::executeThreadTasks(unsigned int threadIdx)
+{
+  const std::vector<unsigned int>& tasks = _threadTasks[threadIdx];
+  unsigned int generation = _generation;
+  for (size_t i = 0; i < tasks.size(); i++)
+  {
+    unsigned int task = tasks[i];
+    const std::vector<unsigned int>& waitFor = _waitFor[task];
+    for (size_t p = 0; p < waitFor.size(); p++)
+      while (_states[waitFor[p]].generation.load() != generation) {}
+
+    try
+    {
+      if (_measure)
+      {
+        unsigned long long start = MeasureTimeTrace::ticks();
+        _funcs[task]();
+        _states[task].ticks += MeasureTimeTrace::ticks() - start;
+      }
+      else
+        _funcs[task]();
+    }
+    catch (std::exception& ex)
+    {
+      // finish the evaluation to avoid a deadlock, the error is raised by the calling thread
+      _errorLock.lock();
+      if (!_failed)
+        _error = ex.what();
+      _failed = true;
+      _errorLock.unlock();
+    }
+    _states[task].generation.store(generation);
+  }
+}
+
+void AdaptiveTaskGraph::endEvaluation()
+{
+  if (_failed)
+  {
+    _failed = false;
+    throw ModelicaSimulationError(MODEL_EQ_SYSTEM, "Task of " + _name + " failed: " + _error);
+  }
+
+  if (++_evaluations == _warmupEvaluations && _numThreads > 1)
+  {
+    std::vector<double> costs(_numTasks);
+    for (unsigned int i = 0; i < _numTasks; i++)
+      costs[i] = (double)_states[i].ticks;
+    schedule(costs);
+  }
+}
+
+AdaptiveScheduler::AdaptiveScheduler(unsigned int numThreads)
+  : _numThreads(std::max(numThreads, 1u))
+  , _workers()
+  , _current(NULL)
+  , _terminate(false)
+{
+  _startCounter.store(0);
+  _numFinished.store(0);
+  for (unsigned int i = 1; i < _numThreads; i++)
+    _workers.push_back(new thread(bind(&AdaptiveScheduler::workerLoop, this, i)));
+}
+
+AdaptiveScheduler::~AdaptiveScheduler()
+{
+  _terminate = true;
+  _startCounter.fetch_add(1);
+  for (size_t i = 0; i < _workers.size(); i++)
+  {
+    _workers[i]->join();
+    delete _workers[i];
+  }
+}
+
+void AdaptiveScheduler::evaluate(AdaptiveTaskGraph& graph)
+{
+  graph.beginEvaluation();
+  _current = &graph;
+  _numFinished.store(0);
+  _startCounter.fetch_add(1);
+
+  graph.executeThreadTasks(0);
+
+  unsigned int spins = 0;
+  while (_numFinished.load() < _numThreads - 1)
+    if (++spins > ADAPTIVE_SCHEDULER_SPINS)
+      ADAPTIVE_SCHEDULER_YIELD();
+  graph.endEvaluation();
+}
+
+void AdaptiveScheduler::workerLoop(unsigned int threadIdx)
+{
+  unsigned int started = 0;
+  while (true)
+  {
+    unsigned int spins = 0;
+    unsigned int counter;
+    while ((counter = _startCounter.load()) == started)
+      if (++spins > ADAPTIVE_SCHEDULER_SPINS)
+        ADAPTIVE_SCHEDULER_YIELD();
+    started = counter;
+    if (_terminate)
+      break;
+
+    _current->executeThreadTasks(threadIdx);
+    _numFinished.fetch_add(1);
+  }
+}
+
+#endif //USE_THREAD
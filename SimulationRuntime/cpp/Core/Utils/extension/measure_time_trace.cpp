@@ -0,0 +1,116 @@
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Utils/extension/measure_time_trace.hpp>
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+MeasureTimeTrace::ThreadBuffer* MeasureTimeTrace::_buffers = NULL;
+MeasureTimeTrace::ThreadBuffer MeasureTimeTrace::_overflow = {NULL, 0, 0, 0, {0}};
+unsigned int MeasureTimeTrace::_numBuffers = 0;
+volatile long MeasureTimeTrace::_numRegistered = 0;
+volatile unsigned int MeasureTimeTrace::_generation = 0;
+unsigned long long MeasureTimeTrace::_startTicks = 0;
+unsigned long long MeasureTimeTrace::_startWallTime = 0;
+
+void MeasureTimeTrace::initialize(unsigned int numThreads, unsigned long eventsPerThread)
+{
+  deinitialize();
+  _numBuffers = numThreads;
+  _buffers = new ThreadBuffer[numThreads];
+  for (unsigned int i = 0; i < numThreads; i++)
+  {
+    ThreadBuffer& buffer = _buffers[i];
+    buffer.events = new Event[eventsPerThread];
+    buffer.size = 0;
+    buffer.capacity = eventsPerThread;
+    buffer.dropped = 0;
+  }
+  _numRegistered = 0;
+  _generation++;
+  _startWallTime = wallTime();
+  _startTicks = ticks();
+}
+
+void MeasureTimeTrace::deinitialize()
+{
+  for (unsigned int i = 0; i < _numBuffers; i++)
+    delete [] _buffers[i].events;
+  delete [] _buffers;
+  _buffers = NULL;
+  _numBuffers = 0;
+  _generation++;
+}
+
+MeasureTimeTrace::ThreadBuffer* MeasureTimeTrace::registerThread()
+{
+#if defined(_WIN32)
+  long idx = InterlockedIncrement(&_numRegistered) - 1;
+#else
+  long idx = __sync_fetch_and_add(&_numRegistered, 1);
+#endif
+  if (idx < (long)_numBuffers)
+    return &_buffers[idx];
+  return &_overflow;
+}
+
+unsigned long long MeasureTimeTrace::wallTime()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return (unsigned long long)(count.QuadPart * 1000000.0 / frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (unsigned long long)tv.tv_sec * 1000000ull + tv.tv_usec;
+#endif
+}
+
+void MeasureTimeTrace::writeToJson(const std::string& fileName)
+{
+  if (_buffers == NULL)
+    return;
+
+  // rdtsc ticks per microsecond over the whole run
+  double elapsed = (double)(wallTime() - _startWallTime);
+  double ticksPerUs = elapsed > 0.0 ? (ticks() - _startTicks) / elapsed : 1.0;
+  if (ticksPerUs <= 0.0)
+    ticksPerUs = 1.0;
+
+  std::ofstream os(fileName.c_str());
+  os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"simulation\"}}";
+
+  unsigned long dropped = _overflow.dropped;
+  unsigned int numThreads = std::min((unsigned int)_numRegistered, _numBuffers);
+  os.precision(15);
+  for (unsigned int t = 0; t < numThreads; t++)
+  {
+    const ThreadBuffer& buffer = _buffers[t];
+    dropped += buffer.dropped;
+    os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << t << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+    for (unsigned long i = 0; i < buffer.size; i++)
+    {
+      const Event& event = buffer.events[i];
+      double ts = (double)(event.start - _startTicks) / ticksPerUs;
+      double dur = (double)(event.end - event.start) / ticksPerUs;
+      os << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":0,\"tid\":" << t
+         << ",\"ts\":" << ts << ",\"dur\":" << dur;
+      if (event.task >= 0)
+        os << ",\"args\":{\"task\":" << event.task << "}";
+      os << "}";
+    }
+  }
+  os << "\n]}\n";
+  os.close();
+
+  std::cout << "Task trace written to " << fileName;
+  if (dropped > 0)
+    std::cout << " (" << dropped << " events dropped, buffers are full)";
+  std::cout << std::endl;
+}
@@ -23,6 +23,8 @@ using std::ios;
 */
 #include <Core/DataExchange/FactoryPolicy.h>
 
+/// size of the buffer for the rows of the "data_2" matrix, in doubles
+#define MAT_BLOCK_SIZE 32768
 
 class MatFileWriter : public ContainerManager
 {
@@ -33,6 +35,8 @@ class MatFileWriter : public ContainerManager
               _dataEofPos(),
               _curser_position(0),
               _uiValueCount(0),
+              _blockRows(0),
+              _blockRowsUsed(0),
               _output_path(output_path),
               _file_name(file_name),
               _doubleMatrixData1(NULL),
@@ -45,6 +49,9 @@ class MatFileWriter : public ContainerManager
     }
     ~MatFileWriter()
     {
+        if (_output_stream.is_open())
+            flushBlock();
+
         // free memory and initialize pointer
         delete[] _doubleMatrixData1;
         delete[] _doubleMatrixData2;
@@ -246,7 +253,10 @@ class MatFileWriter : public ContainerManager
         _output_path = output_path;
 
         if (_output_stream.is_open())
+        {
+            flushBlock();
             _output_stream.close();
+        }
 
         // building complete file path
         std::stringstream res_output_path;
@@ -262,16 +272,21 @@ class MatFileWriter : public ContainerManager
         _uiValueCount = 0;
         _dataHdrPos = 0;
         _dataEofPos = 0;
+        _blockRows = 0;
+        _blockRowsUsed = 0;
 
+        delete[] _doubleMatrixData1;
+        delete[] _doubleMatrixData2;
+        delete[] _stringMatrix;
+        delete[] _pacString;
+        delete[] _intMatrix;
         _doubleMatrixData1 = NULL;
         _doubleMatrixData2 = NULL;
         _stringMatrix = NULL;
         _pacString = NULL;
         _intMatrix = NULL;
 
-        // allocate temp buffer for simulation data:
-        // dim_1 (number of variables) + dim_2 (number of der. variables) + 1 (time)
-        _doubleMatrixData2 = new double[dim + 1];
+        // the block buffer for the simulation data is allocated with the first row
     }
 
     /*=={function}===================================================================================*/
@@ -711,55 +726,44 @@ class MatFileWriter : public ContainerManager
     /*========================================================================================{end}==*/
     virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
     {
-        unsigned int uiVarCount = get<0>(v_list).size() + get<1>(v_list).size() + get<2>(v_list).size() + 1;  // alle Variablen, alle abgeleiteten Variablen und die Zeit
-        double *doubleHelpMatrix = NULL;
-
-        _uiValueCount++;
-
-        // reset tempbuffer to zero
-        memset(_doubleMatrixData2, 0, sizeof(double) * uiVarCount);
-        doubleHelpMatrix = _doubleMatrixData2;
-
-        // first time ist written to "data_2" matrix...
-        *doubleHelpMatrix = get<3>(v_list);
-        doubleHelpMatrix++;
-
-        // ...followed by real variable values...
-        /*for (real_vars_t::const_iterator it = get<0>(v_list).begin(); it != get<0>(v_list).end(); ++it)
+        // the output variables are fixed during a simulation: the copy plan is
+        // built for the first row and the block buffer is allocated once
+        if (_blockRows == 0)
         {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }*/
-
-        std::transform(get<0>(v_list).begin(), get<0>(v_list).end(), get<0>(neg_v_list).begin(),
-            doubleHelpMatrix, WriteOutputVar<double>());
+            _rowPlan.build(v_list, neg_v_list);
+            _blockRows = std::max<size_t>(1, MAT_BLOCK_SIZE / _rowPlan.size());
+            delete[] _doubleMatrixData2;
+            _doubleMatrixData2 = new double[_blockRows * _rowPlan.size()];
+        }
 
+        // time, real, int and bool variables are copied directly into the next row of the block
+        _rowPlan.copy(get<3>(v_list), _doubleMatrixData2 + _blockRowsUsed * _rowPlan.size());
+        _blockRowsUsed++;
+        _uiValueCount++;
 
-        // ...followed by int variable values.
-        /*for (int_vars_t::const_iterator it = get<1>(v_list).begin(); it != get<1>(v_list).end(); ++it)
-        {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }*/
-            size_t nReal = get<0>(v_list).size();
-        std::transform(get<1>(v_list).begin(), get<1>(v_list).end(), get<1>(neg_v_list).begin(),
-            doubleHelpMatrix + nReal, WriteOutputVar<int>());
-        // ...followed by bool variable values.
-        /*for (bool_vars_t::const_iterator it = get<2>(v_list).begin(); it != get<2>(v_list).end(); ++it)
-        {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }
-        */
-             size_t nInt = get<1>(v_list).size();
-        std::transform(get<2>(v_list).begin(), get<2>(v_list).end(), get<2>(neg_v_list).begin(),
-            doubleHelpMatrix+nReal+nInt, WriteOutputVar<bool>());
+        if (_blockRowsUsed == _blockRows)
+            flushBlock();
+    }
 
-        // write matrix to file
-        writeMatVer4Matrix("data_2", uiVarCount, _uiValueCount, _doubleMatrixData2, sizeof(double));
+    /*=={function}===================================================================================*/
+    /*!
+     *  void flushBlock()
+     *
+     *  brief:
+     *  ------
+     *  function appends the buffered rows to the "data_2" matrix and updates its header
+     *
+     * \return
+     */
+    /*========================================================================================{end}==*/
+    void flushBlock()
+    {
+        if (_blockRowsUsed == 0)
+            return;
 
-        // initialize pointer
-        doubleHelpMatrix = NULL;
+        writeMatVer4MatrixHeader("data_2", _rowPlan.size(), _uiValueCount, sizeof(double));
+        _output_stream.write((const char*) _doubleMatrixData2, sizeof(double) * _rowPlan.size() * _blockRowsUsed);
+        _blockRowsUsed = 0;
     }
 
     /*=================================================================================*/
@@ -815,6 +819,9 @@ class MatFileWriter : public ContainerManager
     std::ofstream::pos_type _dataEofPos;
     unsigned int _curser_position;
     unsigned int _uiValueCount;
+    size_t _blockRows;                  ///< capacity of the block buffer _doubleMatrixData2 in rows
+    size_t _blockRowsUsed;              ///< rows in the block buffer that are not yet written
+    OutputRowPlan _rowPlan;
     std::string _output_path;
     std::string _file_name;
     double *_doubleMatrixData1;
@@ -47,6 +47,122 @@ struct WriteOutputVar<bool>
   }
 };
 
+/**
+* Precomputed copy plan for the output values of one time step.
+* The output variables point into the SimVars arrays and do not change during
+* a simulation. Real variables that are stored contiguously and are not negated
+* are copied as one block with memcpy, all other values are converted one by
+* one, with the negation of alias variables applied through a sign mask.
+*/
+class OutputRowPlan
+{
+public:
+  OutputRowPlan()
+    : _size(0)
+  {
+  }
+
+  /**
+  builds the plan for the given output variables
+  @param v_list output variables, their order defines the order in the row
+  @param neg_v_list negate flags of the output variables
+  */
+  void build(const all_vars_time_t& v_list, const neg_all_vars_t& neg_v_list)
+  {
+    const real_vars_t& realVars = get<0>(v_list);
+    const int_vars_t& intVars = get<1>(v_list);
+    const bool_vars_t& boolVars = get<2>(v_list);
+    const negate_values_t& negReal = get<0>(neg_v_list);
+    const negate_values_t& negInt = get<1>(neg_v_list);
+    const negate_values_t& negBool = get<2>(neg_v_list);
+
+    _runs.clear();
+    _reals.clear();
+    _ints.clear();
+    _bools.clear();
+    _size = realVars.size() + intVars.size() + boolVars.size() + 1;
+
+    // position 0 of a row is the simulation time
+    size_t pos = 1;
+    for (size_t i = 0; i < realVars.size(); )
+    {
+      size_t len = 1;
+      if (!negReal[i])
+        while (i + len < realVars.size() && !negReal[i + len] && realVars[i + len] == realVars[i] + len)
+          len++;
+      if (len > 1)
+      {
+        Run run = {realVars[i], pos, len};
+        _runs.push_back(run);
+      }
+      else
+      {
+        Value<double> value = {realVars[i], pos, negReal[i] ? -1.0 : 1.0};
+        _reals.push_back(value);
+      }
+      i += len;
+      pos += len;
+    }
+    for (size_t i = 0; i < intVars.size(); i++, pos++)
+    {
+      Value<int> value = {intVars[i], pos, negInt[i] ? -1 : 1};
+      _ints.push_back(value);
+    }
+    for (size_t i = 0; i < boolVars.size(); i++, pos++)
+    {
+      Value<bool> value = {boolVars[i], pos, negBool[i]};
+      _bools.push_back(value);
+    }
+  }
+
+  /**
+  copies time and the current values of the output variables to row
+  @param time simulation time
+  @param row destination of length size()
+  */
+  void copy(double time, double* row) const
+  {
+    row[0] = time;
+    for (size_t i = 0; i < _runs.size(); i++)
+      memcpy(row + _runs[i].pos, _runs[i].src, _runs[i].len * sizeof(double));
+    for (size_t i = 0; i < _reals.size(); i++)
+      row[_reals[i].pos] = _reals[i].sign * *_reals[i].src;
+    for (size_t i = 0; i < _ints.size(); i++)
+      row[_ints[i].pos] = _ints[i].sign * *_ints[i].src;
+    for (size_t i = 0; i < _bools.size(); i++)
+      row[_bools[i].pos] = *_bools[i].src != _bools[i].sign;
+  }
+
+  /// number of values of a row, including the time
+  size_t size() const
+  {
+    return _size;
+  }
+
+private:
+  struct Run
+  {
+    const double* src;
+    size_t pos;
+    size_t len;
+  };
+
+  /// single value, sign is -1 or 1; for booleans true means negation
+  template<typename T>
+  struct Value
+  {
+    const T* src;
+    size_t pos;
+    T sign;
+  };
+
+  std::vector<Run> _runs;
+  std::vector<Value<double> > _reals;
+  std::vector<Value<int> > _ints;
+  std::vector<Value<bool> > _bools;
+  size_t _size;
+};
+
 class Writer
 {
 public:
@@ -68,6 +68,41 @@ struct CopyRefArray2RefArray
   }
 };
 
+/**
+* Alignment of array data in bytes (one cache line, enough for AVX-512).
+* Array operations use SIMD kernels whose loads never split a cache line
+* if the data starts at this boundary.
+*/
+#define ARRAY_ALIGNMENT 64
+
+/**
+* Aligned allocation of array memory, elements of non-POD types are
+* default constructed and destroyed by alignedArrayFree
+*/
+template<typename T>
+T* alignedArrayAlloc(size_t nelems)
+{
+  size_t offset = ARRAY_ALIGNMENT - 1 + sizeof(void*);
+  void *p1 = malloc(nelems * sizeof(T) + offset);
+  if (p1 == NULL)
+    throw std::bad_alloc();
+  void **p2 = (void**)(((size_t)p1 + offset) & ~(size_t)(ARRAY_ALIGNMENT - 1));
+  p2[-1] = p1;
+  T *data = (T*)p2;
+  if (!boost::is_pod<T>::value)
+    std::uninitialized_fill(data, data + nelems, T());
+  return data;
+}
+
+template<typename T>
+void alignedArrayFree(T* data, size_t nelems)
+{
+  if (!boost::is_pod<T>::value)
+    for (size_t i = 0; i < nelems; i++)
+      data[i].~T();
+  free(((void**)data)[-1]);
+}
+
 /**
 * Base class for all dynamic and static arrays
 */
@@ -639,7 +674,7 @@ class StatArray : public BaseArray<T>
     if (external)
       _data = data;
     else {
-      _data = _array;
+      _data = alignedArray();
       if (nelems > 0)
         std::copy(data, data + nelems, _data);
     }
@@ -656,7 +691,7 @@ class StatArray : public BaseArray<T>
     if (external)
       _data = otherarray._data;
     else {
-      _data = _array;
+      _data = alignedArray();
       otherarray.getDataCopy(_data, nelems);
     }
   }
@@ -672,8 +707,8 @@ class StatArray : public BaseArray<T>
     if (external)
       _data = otherarray._data;
     else {
-      _data = _array;
-      _array = otherarray._array;
+      _data = alignedArray();
+      otherarray.getDataCopy(_data, nelems);
     }
   }
 
@@ -686,7 +721,7 @@ class StatArray : public BaseArray<T>
   {
     if (external)
       throw std::runtime_error("Unsupported copy constructor of static array with external storage!");
-    _data = _array;
+    _data = alignedArray();
     otherarray.getDataCopy(_data, nelems);
   }
 
@@ -699,7 +734,7 @@ class StatArray : public BaseArray<T>
     if (external)
       _data = NULL; // no data assigned yet
     else
-      _data = _array;
+      _data = alignedArray();
   }
 
   virtual ~StatArray() {}
@@ -832,7 +867,29 @@ class StatArray : public BaseArray<T>
   virtual void setDims(const std::vector<size_t>& v) {}
 
  protected:
-  T _array[external || nelems == 0? 1: nelems]; // static array
+  /**
+   * Internal storage of POD types that spans at least ARRAY_ALIGNMENT bytes
+   * gets padding elements, so that _data can start at an aligned address.
+   * An alignment attribute is not used because objects containing arrays
+   * are allocated with new, which guarantees less than ARRAY_ALIGNMENT.
+   */
+  enum
+  {
+    _pad = !external && boost::is_pod<T>::value
+           && ARRAY_ALIGNMENT % sizeof(T) == 0
+           && boost::alignment_of<T>::value == sizeof(T)
+           && nelems * sizeof(T) >= ARRAY_ALIGNMENT ?
+           ARRAY_ALIGNMENT / sizeof(T) - 1 : 0
+  };
+
+  T* alignedArray()
+  {
+    if (_pad == 0)
+      return _array;
+    return (T*)(((size_t)_array + ARRAY_ALIGNMENT - 1) & ~(size_t)(ARRAY_ALIGNMENT - 1));
+  }
+
+  T _array[external || nelems == 0? 1: nelems + _pad]; // static array
   T *_data; // array data
 };
 
@@ -1376,6 +1433,7 @@ class StatArrayDim3 : public StatArray<T, size1*size2*size3, external>
 
 /**
  * Dynamically allocated array, implements BaseArray interface methods
+ * The data is aligned to ARRAY_ALIGNMENT bytes.
  * @param T type of the array
  * @param ndims number of dimensions of array
  */
@@ -1421,7 +1479,7 @@ class DynArray : public BaseArray<T>
   virtual ~DynArray()
   {
     if (_array_data != NULL)
-      delete [] _array_data;
+      alignedArrayFree(_array_data, _nelems);
   }
 
   virtual void assign(const BaseArray<T>& b)
@@ -1447,9 +1505,9 @@ class DynArray : public BaseArray<T>
                                  1, std::multiplies<size_t>());
       if (nelems != _nelems) {
         if (_array_data != NULL)
-          delete [] _array_data;
+          alignedArrayFree(_array_data, _nelems);
         if (nelems > 0)
-          _array_data = new T[nelems];
+          _array_data = alignedArrayAlloc<T>(nelems);
         else
           _array_data = NULL;
         _nelems = nelems;
@@ -0,0 +1,93 @@
+#pragma once
+/** @addtogroup math
+ *   @{
+*/
+
+/*****************************************************************************/
+/**
+
+Krylov methods for Jacobian-free Newton-Krylov iterations of the nonlinear
+algebraic loop solvers.
+
+The system matrix is only accessed through products with vectors
+(IKrylovOperator::apply), e.g. directional derivatives of the residual
+function by finite differences. A preconditioner M ~ A is applied from the
+right: the methods solve (A M^-1) u = b and return x = M^-1 u.
+
+IncompleteLU provides such a preconditioner: an ILU(0) factorization of a
+sparse approximation of A that is assembled column by column.
+
+*/
+/*****************************************************************************
+Copyright (c) 2008, OSMC
+*****************************************************************************/
+
+/// Linear operator and preconditioner of a Krylov method
+class IKrylovOperator
+{
+public:
+  virtual ~IKrylovOperator() {};
+
+  /// Computes y = A*x
+  virtual void apply(const double* x, double* y) = 0;
+
+  /// Replaces x by M^-1 x
+  virtual void precondition(double* x) = 0;
+};
+
+/**
+ * Restarted GMRES(restart) with right preconditioning.
+ * x contains the initial guess and is overwritten by the solution.
+ * Returns the number of iterations, or -1 if the residual norm was not
+ * reduced below tol*|b| within maxIter iterations (x is the best iterate then).
+ */
+int BOOST_EXTENSION_EXPORT_DECL solveGMRES(IKrylovOperator& op, int n, const double* b, double* x,
+                                           double tol, int maxIter, int restart);
+
+/**
+ * BiCGStab with right preconditioning, arguments and result as for solveGMRES.
+ */
+int BOOST_EXTENSION_EXPORT_DECL solveBiCGStab(IKrylovOperator& op, int n, const double* b, double* x,
+                                              double tol, int maxIter);
+
+/**
+ * Incomplete LU factorization without fill-in, ILU(0).
+ * The matrix is assembled with setColumn, only entries with
+ * |a_ij| > dropTol * max_i |a_ij| are kept. The diagonal is always part
+ * of the pattern; zero pivots are replaced by a small value.
+ */
+class BOOST_EXTENSION_EXPORT_DECL IncompleteLU
+{
+public:
+  IncompleteLU();
+
+  /// Starts the assembly of a new n x n matrix
+  void reset(int n);
+
+  /// Sets column j (0-based) from a dense vector of length n
+  void setColumn(int j, const double* column, double dropTol);
+
+  /// Computes the factorization of the assembled matrix
+  void factorize();
+
+  /// Replaces x by U^-1 L^-1 x
+  void solve(double* x) const;
+
+  /// Returns true if factorize was called after the last reset
+  bool isFactorized() const;
+
+  /// Number of nonzero elements of the factors
+  int nnz() const;
+
+private:
+  int _n;
+  bool _factorized;
+  std::vector<int> _colEntries;   ///< column of the assembled entries
+  std::vector<int> _rowEntries;   ///< row of the assembled entries
+  std::vector<double> _valEntries;
+  std::vector<int> _rowPtr;       ///< compressed rows of L and U
+  std::vector<int> _colIdx;
+  std::vector<int> _diag;         ///< position of the diagonal in each row
+  std::vector<double> _val;
+};
+/** @} */ // end of math
@@ -0,0 +1,105 @@
+#pragma once
+/** @addtogroup math
+ *   @{
+*/
+
+/*****************************************************************************/
+/**
+
+Assembly of a sparsematrix_t whose sparsity pattern does not change between
+evaluations, e.g. the symbolic Jacobians of the generated code.
+
+Assigning an element of a compressed matrix searches its column, and inserts
+it if it is new. sparse_assembly records the sequence of elements of the
+first fill and the position of each in the value array of the matrix. While
+later fills write the same sequence, an element is one array write plus a
+check of its coordinates. A different sequence falls back to the element
+access of the matrix and records the new one. As with the element access,
+elements that are not written keep their last value.
+
+Usage:
+  assembly.begin(A);
+  assembly(i, j, value); ...
+  assembly.end();
+
+*/
+/*****************************************************************************
+Copyright (c) 2008, OSMC
+*****************************************************************************/
+
+class sparse_assembly
+{
+public:
+  sparse_assembly()
+    : _A(NULL)
+    , _next(0)
+    , _fixed(false)
+  {
+  }
+
+  /// Starts a fill of A
+  void begin(sparsematrix_t& A)
+  {
+    if (&A != _A || A.nnz() < _pos.size())
+      _fixed = false;
+    _A = &A;
+    _next = 0;
+  }
+
+  /// Sets the element (i,j) of the matrix to value
+  inline void operator()(unsigned int i, unsigned int j, double value)
+  {
+    if (_fixed && _next < _pos.size() && _rows[_next] == i && _cols[_next] == j)
+      _A->value_data()[_pos[_next++]] = value;
+    else
+      insert(i, j, value);
+  }
+
+  /// Finishes a fill, fixes the pattern if the sequence of elements was new
+  void end()
+  {
+    if (!_fixed)
+    {
+      _pos.resize(_rows.size());
+      const double* values = &_A->value_data()[0];
+      for (size_t k = 0; k < _rows.size(); k++)
+        _pos[k] = _A->find_element(_rows[k], _cols[k]) - values;
+      _fixed = true;
+    }
+  }
+
+  /// Number of elements written by a fill of the fixed pattern
+  size_t size() const
+  {
+    return _fixed ? _pos.size() : 0;
+  }
+
+private:
+  void insert(unsigned int i, unsigned int j, double value)
+  {
+    if (_fixed)
+    {
+      // the elements written so far match the old pattern, record the rest
+      _fixed = false;
+      _rows.resize(_next);
+      _cols.resize(_next);
+    }
+    else if (_next == 0)
+    {
+      _rows.clear();
+      _cols.clear();
+    }
+    (*_A)(i, j) = value;
+    _rows.push_back(i);
+    _cols.push_back(j);
+    _next++;
+  }
+
+  sparsematrix_t* _A;
+  std::vector<unsigned int> _rows;
+  std::vector<unsigned int> _cols;
+  std::vector<size_t> _pos;     ///< position of each element in the value array
+  size_t _next;                 ///< index of the next element of a fill
+  bool _fixed;                  ///< _pos is valid for _A
+};
+/** @} */ // end math
@@ -22,6 +22,8 @@
 #include <boost/numeric/ublas/storage.hpp>
 
 #include <boost/container/vector.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 
 /*Namespaces*/
 using std::abs;
@@ -23,6 +23,21 @@ struct SimSettings
   int solverThreads;
   OutputFormat outputFormat;
   EmitResults emitResults;
+  KrylovMethod nonLinearSolverKrylovMethod;
+  bool nonLinearSolverPreconditioning;
+  string ensembleFile;
+  int ensembleThreads;
+};
+
+/**
+ *  One instance of an ensemble (Monte Carlo or DoE study) of a model.
+ *  The start values are overridden by the index of the variable in the
+ *  real, int and bool vectors of the SimVars.
+ */
+struct EnsembleMember
+{
+  SimSettings simsettings;
+  StartValueOverrides startValues;
 };
 
 /**
@@ -38,6 +53,13 @@ public:
   virtual weak_ptr<IMixedSystem> LoadModelicaSystem(PATH modelica_path,string modelKey) = 0;
   virtual void Start(SimSettings simsettings, string modelKey)=0;
 
+  /**
+   *  Simulates one instance of the loaded system per member on up to
+   *  threads threads (0: number of cores). Every instance has its own
+   *  settings, variables and result writer, the system library is shared.
+   */
+  virtual void StartEnsemble(std::vector<EnsembleMember> members, string modelKey, int threads) = 0;
+
   virtual void StartVxWorks(SimSettings simsettings,string modelKey) = 0;
   virtual shared_ptr<IMixedSystem> getSystem(string modelname) = 0;
   virtual  shared_ptr<ISimObjects> getSimObjects() = 0;
@@ -18,6 +18,7 @@ public:
       /// Stops the simulation
     virtual void Stop();
     virtual void Start(SimSettings simsettings, string modelKey);
+    virtual void StartEnsemble(std::vector<EnsembleMember> members, string modelKey, int threads);
     virtual void StartVxWorks(SimSettings simsettings, string modelKey);
     virtual shared_ptr<IMixedSystem> getSystem(string modelname);
     virtual  shared_ptr<ISimObjects> getSimObjects();
@@ -25,9 +26,22 @@ public:
 
 private:
     void initialize(PATH library_path, PATH modelicasystem_path);
+    void setGlobalSettings(SimSettings& simsettings, IGlobalSettings* global_settings);
+    void setSolverSettings(SimSettings& simsettings, ISolverSettings* solver_settings);
+    std::vector<EnsembleMember> readEnsembleFile(SimSettings& simsettings);
+    void runEnsembleMembers(std::vector<EnsembleMember>* members, std::vector<string>* errors);
     bool _initialized;
     shared_ptr<Configuration> _config;
     std::map<string, shared_ptr<IMixedSystem> > _systems;
+    std::map<string, string> _modelLibs;
+
+    // instances of the running ensemble
+    std::vector<shared_ptr<SimManager> > _ensembleMgrs;
+    #if defined(USE_THREAD)
+    atomic<int> _nextEnsembleMember;
+    #else
+    int _nextEnsembleMember;
+    #endif
 
 
 
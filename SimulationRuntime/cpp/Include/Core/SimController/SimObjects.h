@@ -11,6 +11,8 @@ class SimObjects : public ISimObjects, public SimObjectPolicy
 public:
     SimObjects(PATH library_path, PATH modelicasystem_path,IGlobalSettings* globalSettings);
     SimObjects(SimObjects &instance);
+    /// Copy with own settings and algloop solvers, e.g. for an ensemble member
+    SimObjects(SimObjects &instance, IGlobalSettings* globalSettings);
     virtual ~SimObjects();
     virtual weak_ptr<ISimData> LoadSimData(string modelKey);
     virtual weak_ptr<ISimVars> LoadSimVars(string modelKey, size_t dim_real, size_t dim_int, size_t dim_bool, size_t dim_string, size_t dim_pre_vars, size_t dim_z, size_t z_i);
@@ -56,10 +56,17 @@ public:
 
   virtual void setNonLinearSolverContinueOnError(bool);
   virtual bool getNonLinearSolverContinueOnError();
+  virtual void setNonLinearSolverKrylovMethod(KrylovMethod);
+  virtual KrylovMethod getNonLinearSolverKrylovMethod();
+  virtual void setNonLinearSolverPreconditioning(bool);
+  virtual bool getNonLinearSolverPreconditioning();
 
   virtual void setSolverThreads(int);
   virtual int getSolverThreads();
 
+  virtual void setStartValueOverrides(const StartValueOverrides&);
+  virtual const StartValueOverrides& getStartValueOverrides();
+
 private:
   double
       _startTime,   ///< Start time of integration (default: 0.0)
@@ -70,7 +77,9 @@ private:
   bool
       _infoOutput,  ///< Write out statistical simulation infos, e.g. number of steps (at the end of simulation); [false,true]; default: true)
       _endless_sim,
-      _nonLinSolverContinueOnError;
+      _nonLinSolverContinueOnError,
+      _nonLinSolverPreconditioning;
+  KrylovMethod _nonLinSolverKrylovMethod;
   string
       _output_path,
       _selected_solver,
@@ -83,5 +92,6 @@ private:
   unsigned int _alarm_time;
   int _solverThreads;
   OutputFormat _outputFormat;
+  StartValueOverrides _startValueOverrides;
 };
 /** @} */ // end of coreSimulationSettings
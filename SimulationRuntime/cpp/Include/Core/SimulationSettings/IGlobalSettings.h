@@ -24,6 +24,7 @@ using std::string;
 */
 
 #include <vector>
+#include <map>
 
 enum LogCategory {LC_INIT = 0, LC_NLS = 1, LC_LS = 2, LC_SOLVER = 3, LC_OUTPUT = 4, LC_EVENTS = 5, LC_OTHER = 6, LC_MODEL = 7};
 enum LogLevel {LL_ERROR = 0, LL_WARNING = 1, LL_INFO = 2, LL_DEBUG = 3};
@@ -32,6 +33,7 @@ enum LogOMEdit {LOG_EVENTS = 0, LOG_INIT, LOG_LS, LOG_NLS, LOG_SOLVER, LOG_STATS
 enum OutputPointType {OPT_ALL, OPT_STEP, OPT_NONE};
 enum OutputFormat {CSV, MAT, BUFFER, EMPTY};
 enum EmitResults {EMIT_ALL, EMIT_PUBLIC, EMIT_NONE};
+enum KrylovMethod {KRYLOV_NONE, KRYLOV_GMRES, KRYLOV_BICGSTAB};
 
 struct LogSettings
 {
@@ -51,6 +53,14 @@ struct LogSettings
   }
 };
 
+/// Start values that replace the ones of the init file, by index of the real, integer and boolean variables
+struct StartValueOverrides
+{
+  std::map<size_t, double> realValues;
+  std::map<size_t, int> intValues;
+  std::map<size_t, bool> boolValues;
+};
+
 class IGlobalSettings
 {
 public:
@@ -96,8 +106,18 @@ public:
 
   virtual void setNonLinearSolverContinueOnError(bool) = 0;
   virtual bool getNonLinearSolverContinueOnError() = 0;
+  ///< Jacobian-free Krylov method of the nonlinear solvers (default: KRYLOV_NONE, i.e. dense Jacobian)
+  virtual void setNonLinearSolverKrylovMethod(KrylovMethod) = 0;
+  virtual KrylovMethod getNonLinearSolverKrylovMethod() = 0;
+  ///< Incomplete LU preconditioner for the Krylov method (default: true)
+  virtual void setNonLinearSolverPreconditioning(bool) = 0;
+  virtual bool getNonLinearSolverPreconditioning() = 0;
 
   virtual void setSolverThreads(int) = 0;
   virtual int getSolverThreads() = 0;
+
+  ///< Start values applied after the init file was read, e.g. of an ensemble member (default: none)
+  virtual void setStartValueOverrides(const StartValueOverrides&) = 0;
+  virtual const StartValueOverrides& getStartValueOverrides() = 0;
 };
 /** @} */ // end of coreSimulationSettings
@@ -27,5 +27,14 @@ public:
   virtual void load(string) = 0;
   virtual void setContinueOnError(bool) = 0;
   virtual bool getContinueOnError() = 0;
+  /// Jacobian-free Newton-Krylov method instead of a dense Jacobian (default: KRYLOV_NONE)
+  virtual KrylovMethod getKrylovMethod() = 0;
+  virtual void setKrylovMethod(KrylovMethod) = 0;
+  /// Incomplete LU factorization of a finite difference Jacobian as preconditioner for the Krylov method
+  virtual bool getUsePreconditioner() = 0;
+  virtual void setUsePreconditioner(bool) = 0;
+  /// Number of Newton iterations before the preconditioner is updated
+  virtual int getPreconditionerUpdate() = 0;
+  virtual void setPreconditionerUpdate(int) = 0;
 };
  /** @} */ // end of coreSolver
@@ -57,6 +57,16 @@ public:
   virtual bool stateSelection();
 
 protected:
+  /// Reads the sparsity pattern of the dim x dim Jacobian (compressed columns) and the coloring of its columns for
+  /// finite differences. Returns false if the system provides no sparse Jacobian. Arrays are (re-)allocated with new[]
+  bool initializeSparsePattern(const string& solverName, int dim, int& nonzeros, int*& leadindex, int*& index,
+                               int& maxColors, int*& colorOfColumn);
+
+  /// Pattern of an iteration matrix: the sparsity pattern with the diagonal inserted where it is structurally zero.
+  /// pos and diag are the positions of the nonzeros of the pattern and of the diagonal. Returns the number of nonzeros
+  static int insertDiagonal(int dim, int nonzeros, const int* leadindex, const int* index,
+                            int*& iterLeadindex, int*& iterIndex, int*& pos, int*& diag);
+
   // Member variables
   //---------------------------------------------------------------
   IMixedSystem
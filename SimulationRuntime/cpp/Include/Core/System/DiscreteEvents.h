@@ -21,21 +21,33 @@ public:
   void save(double& var);
   void save(int& var);
   void save(bool& var);
-  //void savePreVars(double vars [], unsigned int n);
 
 
   //Implementation of the Modelica pre  operator
-  double& pre(const double& var);
-  int& pre(const int& var);
-  bool& pre(const bool& var);
+  //the index of the variable follows from its address in the sim vars block, no virtual call
+  inline double& pre(const double& var) { return _pre_real_vars[&var - _real_vars]; }
+  inline int& pre(const int& var) { return _pre_int_vars[&var - _int_vars]; }
+  inline bool& pre(const bool& var) { return _pre_bool_vars[&var - _bool_vars]; }
   //Implementation of the Modelica edge  operator
-  bool edge(double& var);
-  bool edge(int& var);
-  bool edge(bool& var);
+  inline bool edge(double& var) { return var && !pre(var); }
+  inline bool edge(int& var) { return var && !pre(var); }
+  inline bool edge(bool& var) { return var && !pre(var); }
   //Implementation of the Modelica change  operator
-  bool change(int& var);
-  bool change(bool& var);
-  bool change(double& var);
+  inline bool change(int& var) { return var != pre(var); }
+  inline bool change(bool& var) { return var != pre(var); }
+  inline bool change(double& var) { return var != pre(var); }
+
+  //Access to pre variables by their index in the sim vars block, for generated code that knows the index
+  inline double& preReal(size_t i) { return _pre_real_vars[i]; }
+  inline int& preInt(size_t i) { return _pre_int_vars[i]; }
+  inline bool& preBool(size_t i) { return _pre_bool_vars[i]; }
+  inline bool edgeBool(size_t i) { return _bool_vars[i] && !_pre_bool_vars[i]; }
+  inline bool changeReal(size_t i) { return _real_vars[i] != _pre_real_vars[i]; }
+  inline bool changeInt(size_t i) { return _int_vars[i] != _pre_int_vars[i]; }
+  inline bool changeBool(size_t i) { return _bool_vars[i] != _pre_bool_vars[i]; }
+
+  //Copies all variables to the pre variables
+  void savePreVars();
 
 
   bool changeDiscreteVar(double& var);
@@ -44,7 +56,16 @@ public:
   //getCondition_type getCondition;
 
 private:
+   void initVarPointers();
+
    shared_ptr<ISimVars> _sim_vars;
+   //blocks of the sim vars, cached to avoid virtual calls
+   double* _real_vars;
+   int* _int_vars;
+   bool* _bool_vars;
+   double* _pre_real_vars;
+   int* _pre_int_vars;
+   bool* _pre_bool_vars;
 };
 
 /**
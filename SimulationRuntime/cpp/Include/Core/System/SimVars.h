@@ -110,6 +110,9 @@ class BOOST_EXTENSION_SIMVARS_DECL SimVars: public ISimVars
     virtual double& getPreVar(const double& var);
     virtual int& getPreVar(const int& var);
     virtual bool& getPreVar(const bool& var);
+    virtual double* getPreRealVarsVector() const;
+    virtual int* getPreIntVarsVector() const;
+    virtual bool* getPreBoolVarsVector() const;
 
   protected:
     void create(size_t dim_real, size_t dim_int, size_t dim_bool, size_t dim_string, size_t dim_pre_vars, size_t dim_state_vars, size_t state_index);
@@ -0,0 +1,102 @@
+#ifndef ADAPTIVE_SCHEDULER_HPP_
+#define ADAPTIVE_SCHEDULER_HPP_
+
+#ifdef USE_THREAD
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Utils/extension/measure_time_trace.hpp>
+
+/**
+ * Task graph of one HPCOM system (ODE, DAE or zero functions) that is
+ * scheduled at runtime. The graph starts with a list schedule computed from the
+ * estimated task costs of the compiler. During a warm-up window the real
+ * execution times of the tasks are measured, afterwards a new list schedule
+ * is computed from the measured times and used for the rest of the simulation.
+ */
+class BOOST_EXTENSION_EXPORT_DECL AdaptiveTaskGraph
+{
+ public:
+  /**
+   * @param name name of the graph, used in log messages
+   * @param numTasks number of tasks, the task indices are 0 .. numTasks-1
+   * @param numThreads number of threads the graph is scheduled to
+   * @param warmupEvaluations number of evaluations after which the graph is rescheduled
+   */
+  AdaptiveTaskGraph(const std::string& name, unsigned int numTasks, unsigned int numThreads, unsigned int warmupEvaluations = 100);
+  ~AdaptiveTaskGraph();
+
+  /// Sets the function of a task and its estimated cost (any unit)
+  void setTask(unsigned int taskIdx, function<void()> func, double estimatedCost);
+  /// Task childIdx can not start before task parentIdx is finished
+  void addDependency(unsigned int parentIdx, unsigned int childIdx);
+
+  /// Computes the initial schedule, must be called after all tasks and dependencies are added
+  void initialize();
+
+  /// Computes a list schedule from the given costs and uses it for the next evaluations
+  void schedule(const std::vector<double>& costs);
+
+ private:
+  friend class AdaptiveScheduler;
+
+  /// Task state, padded to a cache line because it is written by the executing thread
+  struct TaskState
+  {
+    atomic<unsigned int> generation; ///< generation of the last evaluation the task has finished
+    unsigned long long ticks;        ///< measured time of the task
+    char padding[64 - sizeof(atomic<unsigned int>) - sizeof(unsigned long long)];
+  };
+
+  void beginEvaluation();
+  void executeThreadTasks(unsigned int threadIdx);
+  void endEvaluation();
+
+  std::string _name;
+  unsigned int _numTasks;
+  unsigned int _numThreads;
+  unsigned int _warmupEvaluations;
+  unsigned int _evaluations;
+  unsigned int _generation;
+  bool _measure;
+
+  std::vector<function<void()> > _funcs;
+  std::vector<double> _estimatedCosts;
+  std::vector<std::vector<unsigned int> > _parents;
+  std::vector<std::vector<unsigned int> > _children;
+
+  std::vector<std::vector<unsigned int> > _threadTasks;  ///< tasks of each thread in execution order
+  std::vector<std::vector<unsigned int> > _waitFor;      ///< parents of each task that run on another thread
+  TaskState* _states;
+
+  mutex _errorLock;
+  std::string _error;
+  volatile bool _failed;
+};
+
+/**
+ * Pool of worker threads that evaluates AdaptiveTaskGraphs. The calling thread
+ * takes part in the evaluation as thread 0. Idle workers spin for a short time
+ * and yield afterwards.
+ */
+class BOOST_EXTENSION_EXPORT_DECL AdaptiveScheduler
+{
+ public:
+  AdaptiveScheduler(unsigned int numThreads);
+  ~AdaptiveScheduler();
+
+  /// Evaluates all tasks of the graph, returns when all tasks are finished
+  void evaluate(AdaptiveTaskGraph& graph);
+
+ private:
+  void workerLoop(unsigned int threadIdx);
+
+  unsigned int _numThreads;
+  std::vector<thread*> _workers;
+  AdaptiveTaskGraph* volatile _current;
+  atomic<unsigned int> _startCounter;
+  atomic<unsigned int> _numFinished;
+  volatile bool _terminate;
+};
+
+#endif //USE_THREAD
+#endif /* ADAPTIVE_SCHEDULER_HPP_ */
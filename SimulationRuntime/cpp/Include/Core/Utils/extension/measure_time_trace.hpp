@@ -0,0 +1,113 @@
+#ifndef MEASURE_TIME_TRACE_HPP_
+#define MEASURE_TIME_TRACE_HPP_
+
+#include <Core/Utils/extension/measure_time.hpp>
+
+#if defined(_MSC_VER)
+  #define MEASURETIME_TRACE_TLS __declspec(thread)
+#else
+  #define MEASURETIME_TRACE_TLS __thread
+#endif
+
+/**
+ * Timeline tracing of single tasks, e.g. the tasks of a HPCOM schedule.
+ * Every thread writes (task, start, end) into its own preallocated buffer, the
+ * timestamps are taken with rdtsc. No locks are used after the first event of a
+ * thread; events that do not fit into the buffer are counted and dropped.
+ * At the end the events are written in the trace event format of
+ * chrome://tracing and Perfetto.
+ */
+#ifdef MEASURETIME_TRACE
+  #define MEASURETIME_TRACE_START(varStart) unsigned long long varStart = MeasureTimeTrace::ticks()
+  #define MEASURETIME_TRACE_END(varStart, name, taskIdx) MeasureTimeTrace::addEvent(name, taskIdx, varStart)
+#else
+  #define MEASURETIME_TRACE_START(varStart)
+  #define MEASURETIME_TRACE_END(varStart, name, taskIdx)
+#endif
+
+class BOOST_EXTENSION_EXPORT_DECL MeasureTimeTrace
+{
+ public:
+  struct Event
+  {
+    const char* name;           ///< static string, e.g. "Task 12"
+    int task;                   ///< task index or -1
+    unsigned long long start;
+    unsigned long long end;
+  };
+
+  /// Events of one thread, padded to a cache line to avoid false sharing
+  struct ThreadBuffer
+  {
+    Event* events;
+    unsigned long size;
+    unsigned long capacity;
+    unsigned long dropped;
+    char padding[64 - sizeof(Event*) - 3 * sizeof(unsigned long)];
+  };
+
+  /**
+   * Allocates the buffers, must be called before the threads are started
+   * @param numThreads maximum number of threads that record events
+   * @param eventsPerThread capacity of each buffer
+   */
+  static void initialize(unsigned int numThreads, unsigned long eventsPerThread = 1ul << 18);
+  static void deinitialize();
+
+  /// Writes all recorded events to fileName (trace event JSON)
+  static void writeToJson(const std::string& fileName);
+
+  static inline unsigned long long ticks()
+  {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    unsigned hi, lo;
+    __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((unsigned long long) lo) | (((unsigned long long) hi) << 32);
+#else
+    return wallTime();
+#endif
+  }
+
+  /// Records a task of the calling thread that started at start and ends now
+  static inline void addEvent(const char* name, int task, unsigned long long start)
+  {
+    unsigned long long end = ticks();
+    // the buffer of the thread is valid until the next (de)initialize
+    static MEASURETIME_TRACE_TLS ThreadBuffer* buffer = NULL;
+    static MEASURETIME_TRACE_TLS unsigned int generation = 0;
+    if (buffer == NULL || generation != _generation)
+    {
+      buffer = registerThread();
+      generation = _generation;
+    }
+    if (buffer->size < buffer->capacity)
+    {
+      Event& event = buffer->events[buffer->size++];
+      event.name = name;
+      event.task = task;
+      event.start = start;
+      event.end = end;
+    }
+    else
+      buffer->dropped++;
+  }
+
+ private:
+  /// Assigns a buffer to the calling thread (once per thread)
+  static ThreadBuffer* registerThread();
+
+  /// Wall clock time in microseconds, used to convert ticks
+  static unsigned long long wallTime();
+
+  static ThreadBuffer* _buffers;
+  static ThreadBuffer _overflow;        ///< for threads without a buffer, records nothing
+  static unsigned int _numBuffers;
+  static volatile long _numRegistered;
+  static volatile unsigned int _generation; ///< incremented by initialize and deinitialize
+  static unsigned long long _startTicks;
+  static unsigned long long _startWallTime;
+};
+
+#endif /* MEASURE_TIME_TRACE_HPP_ */
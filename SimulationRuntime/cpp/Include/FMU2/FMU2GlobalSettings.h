@@ -85,8 +85,14 @@ class FMU2GlobalSettings : public IGlobalSettings
   virtual unsigned int    getAlarmTime() { return 0; }
   virtual void setNonLinearSolverContinueOnError(bool){};
   virtual bool getNonLinearSolverContinueOnError(){ return false; };
+  virtual void setNonLinearSolverKrylovMethod(KrylovMethod){};
+  virtual KrylovMethod getNonLinearSolverKrylovMethod(){ return KRYLOV_NONE; };
+  virtual void setNonLinearSolverPreconditioning(bool){};
+  virtual bool getNonLinearSolverPreconditioning(){ return true; };
   virtual void setSolverThreads(int){};
   virtual int getSolverThreads() { return 1; };
+  virtual void setStartValueOverrides(const StartValueOverrides&) {};
+  virtual const StartValueOverrides& getStartValueOverrides() { static StartValueOverrides none; return none; };
   virtual OutputFormat getOutputFormat() {return EMPTY;};
   virtual void setOutputFormat(OutputFormat) {};
 };
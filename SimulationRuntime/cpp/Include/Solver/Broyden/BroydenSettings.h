@@ -27,6 +27,12 @@ public:
 
     virtual void setContinueOnError(bool);
     virtual bool getContinueOnError();
+    virtual KrylovMethod getKrylovMethod();
+    virtual void setKrylovMethod(KrylovMethod);
+    virtual bool getUsePreconditioner();
+    virtual void setUsePreconditioner(bool);
+    virtual int getPreconditionerUpdate();
+    virtual void setPreconditionerUpdate(int);
 private:
     long int    _iNewt_max;                    ///< max. Anzahl an Broydenititerationen pro Schritt (default: 25)
 
@@ -34,5 +40,8 @@ private:
     double        _dAtol;                        ///< Absolute Toleranz für die Broydeniteration (default: 1e-6)
     double        _dDelta;                        ///< Dämpfungsfaktor (default: 0.9)
     bool _continueOnError;
+    KrylovMethod _krylovMethod;     ///< Jacobian-free Newton-Krylov method (default: KRYLOV_NONE)
+    bool _usePreconditioner;         ///< ILU preconditioner for the Krylov method (default: true)
+    int _preconditionerUpdate;       ///< Newton iterations between preconditioner updates (default: 10)
 };
 /** @} */ // end of solverBroyden
@@ -16,6 +16,23 @@
 #endif //USE_SUNDIALS_LAPACK
 #include <nvector/nvector_serial.h>
 #include <sundials/sundials_direct.h>
+#if defined(klu) && SUNDIALS_MAJOR_VERSION == 2 && SUNDIALS_MINOR_VERSION >= 6
+  #ifndef USE_SUNDIALS_KLU
+    #define USE_SUNDIALS_KLU
+  #endif
+  #include <cvode/cvode_klu.h>
+  #include <sundials/sundials_sparse.h>
+  // compressed column indices of a SlsMat (SUNDIALS 2.7 renamed the members)
+  #ifndef SLS_COLPTRS
+    #if SUNDIALS_MINOR_VERSION > 6
+      #define SLS_COLPTRS(A) ((A)->indexptrs)
+      #define SLS_ROWVALS(A) ((A)->indexvals)
+    #else
+      #define SLS_COLPTRS(A) ((A)->colptrs)
+      #define SLS_ROWVALS(A) ((A)->rowvals)
+    #endif
+  #endif
+#endif
 
 #ifdef RUNTIME_PROFILING
   #include <Core/Utils/extension/measure_time.hpp>
@@ -27,6 +44,8 @@
 // Cvode aus dem SUNDIALS-Package
 // BDF-Verfahren für steife und nicht-steife ODEs
 // Dokumentation siehe offizielle Cvode Doku
+// Stellt das System das Besetzungsmuster der Jacobimatrix A bereit (Matrixformat sparse),
+// wird der KLU-Löser verwendet und A analytisch oder mit gefärbten Differenzenquotienten berechnet
 
 /*****************************************************************************
 Copyright (c) 2004, Bosch Rexroth AG, All rights reserved
@@ -106,7 +125,16 @@ private:
   // Functions for Coloured Jacobian
   static int CV_JCallback(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
   int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
-  void initializeColoredJac();
+#ifdef USE_SUNDIALS_KLU
+  static int CV_SlsJCallback(realtype t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcSparseJacobian(double t, double* y, N_Vector fy, SlsMat Jac, N_Vector fHelp, N_Vector errorWeight);
+#endif
+  /// Reads sparsity pattern and coloring of the Jacobian A, returns false if the system does not provide them
+  bool initializeColoredJac();
+  /// Finite difference increments for the columns of the Jacobian
+  void calcJacobianIncrements(long int N, const double* y, N_Vector fy, N_Vector errorWeight);
+  /// Nonzeros of A by finite differences, one right hand side evaluation per color
+  void calcColoredJacobian(double t, double* y, const double* f, double* fHelp, double* jac, bool compressed);
 
 
 
@@ -169,8 +197,9 @@ double
   int  _maxColors;
   matrix_t _jacobianA;
   int _jacobianANonzeros;
-  int const* _jacobianAIndex;
-  int const* _jacobianALeadindex;
+  int* _jacobianAIndex;               ///< row indices of the nonzeros of A (compressed columns)
+  int* _jacobianALeadindex;           ///< start of the columns of A in _jacobianAIndex
+  bool _sparseLinearSolver;           ///< KLU with the sparsity pattern of A
 
 
 
@@ -16,8 +16,9 @@ of ordinary differantial equations of the form
 
 z' = f(t,z).
 
-Dense output may be used. Zero crossing are detected by bisection or linear
-interpolation.
+Dense output may be used. Zero crossings are localized by the Illinois
+method on the cubic Hermite interpolant of the last step, only the zero
+functions are evaluated during the search.
 
 \date     01.09.2008
 \author
@@ -111,13 +112,19 @@ private:
 
     // Hilfsfunktionen
     //------------------------------------------
-    // Interpolation der Lösung für Euler-Verfahren
+    /// Kubische Hermite-Interpolation der Lösung im letzten Schritt [_t0,_t1]
     void interp1(double time, double* value);
 
+    /// Speichert Zustand und rechte Seite am Intervallanfang für die Interpolation
+    void startStep();
+
     /// Kapselung der Nullstellensuche
     void doMyZeroSearch();
     void doZeroSearch();
 
+    /// Event handling after a step, continues without restart if no state was reinitialized
+    void handleZeroCrossing(const double& tNext);
+
     // gibt den Wert der Nullstellenfunktion für die Zeit t und den Zustand y wieder
     void giveZeroVal(const double &t,const double *y,double *zeroValue);
 
@@ -159,8 +166,8 @@ private:
         *_z1,                                        ///< Temp            - (New) state vector at right border of intervall (last step)
         *_zInit,                                    ///< Temp            - Initial state vector
         *_zWrite,                                    ///< Temp            - Zustand den das System rausschreibt
-        *_f0,
-        *_f1;
+        *_f0,                                        ///< Temp            - Right hand side at left border of intervall (last step)
+        *_f1;                                        ///< Temp            - Right hand side at right border of intervall (last step)
 
      double
          _hOut,                                        ///< Temp            - Ouput step size for dense output
@@ -179,6 +186,8 @@ private:
         _doubleZeroDistance,                        ///< Temp            - In case of two zeros in one intervall (doubleZero): distance between zeros
         _tZero,                                        ///< Temp            - Nullstelle
         _tLastWrite,                                ///< Temp            - Letzter Ausgabezeitpunkt
+        _t0,                                        ///< Temp            - Left border of intervall (last step)
+        _t1,                                        ///< Temp            - Right border of intervall (last step)
         _zeroTol;
 
 
@@ -25,6 +25,12 @@ public:
 
     virtual void setContinueOnError(bool);
     virtual bool getContinueOnError();
+    virtual KrylovMethod getKrylovMethod();
+    virtual void setKrylovMethod(KrylovMethod);
+    virtual bool getUsePreconditioner();
+    virtual void setUsePreconditioner(bool);
+    virtual int getPreconditionerUpdate();
+    virtual void setPreconditionerUpdate(int);
 private:
     long int    _iNewt_max;                    ///< max. Anzahl an Newtonititerationen pro Schritt (default: 25)
 
@@ -32,5 +38,8 @@ private:
     double        _dAtol;                        ///< Absolute Toleranz für die Newtoniteration (default: 1e-6)
     double        _dDelta;                        ///< Dämpfungsfaktor (default: 0.9)
     bool _continueOnError;
+    KrylovMethod _krylovMethod;     ///< Jacobian-free Newton-Krylov method (default: KRYLOV_NONE)
+    bool _usePreconditioner;         ///< ILU preconditioner for the Krylov method (default: true)
+    int _preconditionerUpdate;       ///< Newton iterations between preconditioner updates (default: 10)
 };
 /** @} */ // end of solverHybrj
@@ -8,6 +8,23 @@
 #include <nvector/nvector_serial.h>
 #include <sundials/sundials_direct.h>
 #include <idas/idas_dense.h>
+#if defined(klu) && SUNDIALS_MAJOR_VERSION == 2 && SUNDIALS_MINOR_VERSION >= 6
+  #ifndef USE_SUNDIALS_KLU
+    #define USE_SUNDIALS_KLU
+  #endif
+  #include <idas/idas_klu.h>
+  #include <sundials/sundials_sparse.h>
+  // compressed column indices of a SlsMat (SUNDIALS 2.7 renamed the members)
+  #ifndef SLS_COLPTRS
+    #if SUNDIALS_MINOR_VERSION > 6
+      #define SLS_COLPTRS(A) ((A)->indexptrs)
+      #define SLS_ROWVALS(A) ((A)->indexvals)
+    #else
+      #define SLS_COLPTRS(A) ((A)->colptrs)
+      #define SLS_ROWVALS(A) ((A)->rowvals)
+    #endif
+  #endif
+#endif
 
 
 #ifdef RUNTIME_PROFILING
@@ -20,6 +37,8 @@
 // IDA aus dem SUNDIALS-Package
 // BDF-Verfahren für steife und nicht-steife ODEs
 // Dokumentation siehe offizielle IDA Doku
+// Für ODEs mit Besetzungsmuster der Jacobimatrix A (Matrixformat sparse) wird der KLU-Löser verwendet,
+// die Iterationsmatrix A - c_j*I wird analytisch oder mit gefärbten Differenzenquotienten berechnet
 
 /*****************************************************************************
 Copyright (c) 2004, Bosch Rexroth AG, All rights reserved
@@ -97,8 +116,18 @@ private:
   static int zeroFunctionCB(double t, N_Vector y, N_Vector yp, double *zeroval, void *user_data);
 
   // Functions for Coloured Jacobian
-  static int jacobianFunctionCB(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
-  int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
+  static int jacobianFunctionCB(long int N, realtype t, realtype c_j, N_Vector y, N_Vector yp, N_Vector r, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcJacobian(double t, double c_j, long int N, N_Vector fHelp, N_Vector errorWeight, double* y, double* yp, N_Vector r, DlsMat Jac);
+#ifdef USE_SUNDIALS_KLU
+  static int sparseJacobianFunctionCB(realtype t, realtype c_j, N_Vector y, N_Vector yp, N_Vector r, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcSparseJacobian(double t, double c_j, double* y, double* yp, N_Vector r, SlsMat Jac, N_Vector fHelp, N_Vector errorWeight);
+#endif
+  /// Reads sparsity pattern and coloring of the Jacobian A, returns false if the system does not provide them
+  bool initializeColoredJac();
+  /// Finite difference increments for the columns of the Jacobian
+  void calcJacobianIncrements(long int N, const double* y, N_Vector r, N_Vector errorWeight);
+  /// Nonzeros of A by finite differences, one residual evaluation per color
+  void calcColoredJacobian(double t, double* y, double* yp, const double* r, double* rHelp, double* jac, bool compressed);
 
 
 
@@ -172,8 +201,15 @@ double
   int  _maxColors;
   matrix_t _jacobianA;
   int _jacobianANonzeros;
-  int const* _jacobianAIndex;
-  int const* _jacobianALeadindex;
+  int* _jacobianAIndex;               ///< row indices of the nonzeros of A (compressed columns)
+  int* _jacobianALeadindex;           ///< start of the columns of A in _jacobianAIndex
+  // Pattern of the iteration matrix A - c_j*I (A and the diagonal)
+  int _jacobianNonzeros;
+  int* _jacobianIndex;                ///< row indices (compressed columns)
+  int* _jacobianLeadindex;            ///< start of the columns in _jacobianIndex
+  int* _jacobianPos;                  ///< position of the nonzeros of A in _jacobianIndex
+  int* _jacobianDiag;                 ///< position of the diagonal elements in _jacobianIndex
+  bool _sparseLinearSolver;           ///< KLU with the pattern of the iteration matrix
 
 
   bool _ida_initialized;
@@ -3,6 +3,8 @@
  *
  *  @{
  */
+#include <Core/Math/Krylov.h>
+
 #if defined(__vxworks)
 //#include <klu.h>
 #else
@@ -27,6 +29,8 @@ public:
   virtual void restoreOldValues();
   virtual void restoreNewValues();
   int kin_f(N_Vector y, N_Vector fval, void *user_data);
+  int kin_PrecSetup(N_Vector u, N_Vector fu);
+  int kin_PrecSolve(N_Vector v);
 
  /*will be used with new sundials version
   int kin_JacSparse(N_Vector u, N_Vector fu,SlsMat J, void *user_data,N_Vector tmp1, N_Vector tmp2);
@@ -40,6 +44,8 @@ private:
   int check_flag(void *flagvalue, char *funcname, int opt);
 
   void solveNLS();
+  /// Selects an iterative linear solver, Jacobian-free with ILU preconditioner in Krylov mode
+  void initKrylov(KrylovMethod method);
   void check4EventRetry(double* y);
 
   // Member variables
@@ -100,6 +106,8 @@ private:
     _currentIterateNorm;
 
    int _counter;
+   IncompleteLU _ilu;      ///< Preconditioner of the Krylov methods
+   int _iluAge;            ///< Setup calls since the last update of _ilu
    //required for klu linear solver
    bool _sparse;
 /*
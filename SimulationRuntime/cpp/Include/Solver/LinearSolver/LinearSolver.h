@@ -29,6 +29,11 @@ public:
 
 
 private:
+#if defined(klu)
+  /// Symbolic analysis of a new sparsity pattern given in compressed columns
+  void analyzeSparsePattern(int nonzeros, int const* Ap, int const* Ai);
+#endif
+
   // Member variables
   //---------------------------------------------------------------
 
@@ -53,18 +58,21 @@ private:
       *_y_old,				//stores old solution
       *_y_new,				//stores new solution
 	  *_b,                  ///< right hand side
-	  *_A,				///coefficients of linear system
+	  *_A,				///coefficients of linear system, overwritten by its LU factors
+	  *_Acopy,			///coefficients from which the current LU factors were computed
 	  *_zeroVec,			///zero vector
 	  *_scale;				//scaling parameter to prevent overflow in singular systems
   bool _sparse;
+  bool _factorized;		///< LU factors in _A are valid for the coefficients in _Acopy
+  bool _fullPivot;		///< _A was factorized with complete pivoting (singular system)
 #if defined(klu)
-  int _dim;
   klu_symbolic* _kluSymbolic ;
   klu_numeric* _kluNumeric ;
   klu_common* _kluCommon ;
   int* _Ai;
   int* _Ap;
-  double* _Ax;
+  double* _Ax;			///< values of the system matrix, owned by the algebraic loop
+  double* _Axcopy;		///< values from which the current numeric factorization was computed
   int _nonzeros;
 #endif
 
@@ -10,6 +10,7 @@
 #include <Core/Solver/IAlgLoopSolver.h>        // Export function from dll
 #include <Core/Solver/INonLinSolverSettings.h>
 #include <Solver/Newton/NewtonSettings.h>
+#include <Core/Math/Krylov.h>
 
 
 /*****************************************************************************/
@@ -26,13 +27,16 @@
    by Lapack/DGESV, which computes the solution to a real system of linear equations
    A * y = B,                            (2)
    where A is an n-by-n matrix and y and B are n-by-n(right hand side) matrices.
+   Alternatively (INonLinSolverSettings::getKrylovMethod) the linear system is solved
+   Jacobian-free by GMRES or BiCGStab with directional derivatives of F, preconditioned
+   by an incomplete LU factorization that is updated every few Newton iterations.
    \date     2008, September, 16th
    \author
 */
 /*****************************************************************************
  * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
  *****************************************************************************/
-class Newton : public IAlgLoopSolver
+class Newton : public IAlgLoopSolver, private IKrylovOperator
 {
  public:
   Newton(INonLinearAlgLoop* algLoop,INonLinSolverSettings* settings);
@@ -57,6 +61,18 @@ class Newton : public IAlgLoopSolver
   /// Encapsulation of determination of Jacobian
   void calcJacobian(double *jac, double *fNominal);
 
+  /// Jacobian-free Newton-Krylov step, solves J*dy = f for the scaled residuals f
+  void calcKrylovStep(double *f, double phi);
+
+  /// Incomplete LU factorization of the Jacobian, also determines fNominal
+  void updatePreconditioner(double *fNominal);
+
+  /// Directional derivative of the scaled residuals (IKrylovOperator)
+  virtual void apply(const double* v, double* Jv);
+
+  /// Preconditioner of the Krylov method (IKrylovOperator)
+  virtual void precondition(double* v);
+
   // Member variables
   //---------------------------------------------------------------
   INonLinSolverSettings
@@ -87,8 +103,13 @@ class Newton : public IAlgLoopSolver
     *_fHelp,                    ///< Temp        - Auxillary variables
     *_yTest,                    ///< Temp        - Auxillary variables
     *_fTest,                    ///< Temp        - Auxillary variables
-    *_jac;                      ///< Temp        - Jacobian
+    *_jac,                      ///< Temp        - Jacobian
+    *_yKrylov,                  ///< Temp        - Perturbed variables of directional derivatives
+    *_fKrylov,                  ///< Temp        - Residuals of directional derivatives
+    *_dy;                       ///< Temp        - Newton step of Krylov method
   long int *_iHelp;
+  IncompleteLU _ilu;            ///< Preconditioner of Krylov method
+  int _iluAge;                  ///< Newton iterations since the last update of _ilu
   LogCategory _lc;              ///< LC_NLS or LC_LS
 
 };/** @} */ // end of solverNewton
@@ -5,12 +5,19 @@
 
 #include <Core/Solver/SolverDefaultImplementation.h>
 #include <Core/Utils/extension/measure_time.hpp>
+#include <Core/Utils/extension/logger.hpp>
+#if defined(klu)
+  #include <klu.h>
+#endif
 
 
 /*****************************************************************************/
 // Peer
 // BDF-Verfahren für steife und nicht-steife ODEs
 // Dokumentation siehe offizielle Peer Doku
+// Schrittweitensteuerung über die Differenz zwischen Prädiktor (Extrapolation der alten Stufen)
+// und den neuen Stufen, Stufen-Jacobimatrizen mit gefärbten Differenzenquotienten und KLU,
+// falls das System ein Besetzungsmuster liefert
 
 /*****************************************************************************
 Copyright (c) 2014, IWR TU Dresden, All rights reserved
@@ -81,6 +88,17 @@ private:
   void evalD(const double& t, const double* y, double* T, IContinuous *continuousSystem, ITime *timeSystem);
   void setcycletime(double cycletime);
   void ros2(double * y, double& tstart, double tend, IContinuous *continuousSystem, ITime *timeSystem);
+  /// Lagrange basis of the stage nodes _c evaluated at x
+  void lagrangeWeights(const double& x, double* w);
+  /// Extrapolation matrix _Theta for the step size ratio sigma = h_new/h_old
+  void setStepRatio(const double& sigma);
+  /// Reads sparsity pattern and coloring of the Jacobian, returns false if the system does not provide them
+  bool initializeSparsePattern();
+  /// Stage Jacobian by colored finite differences (dense or nonzeros of the pattern)
+  void evalJColored(const double& t, const double* y, double* J, IContinuous *continuousSystem, ITime *timeSystem);
+  /// Factorizes the iteration matrix I - h*G[rank]*J of a stage, returns false if it is singular
+  bool factorizeStage(int rank, const double& h);
+  void solveStage(int rank, double* b);
 
   ISolverSettings
     *_peersettings;              ///< Input      - Solver settings
@@ -110,8 +128,35 @@ private:
         *_Y2,
         *_Y3,
         *_T,
+        *_J,              ///< stage Jacobians (dense or nonzeros of the pattern)
+        *_Ysave,          ///< stages of the last accepted step
+        _hIter[5],        ///< step size of the factorized iteration matrices
         _h,
-        _hOut;
+        _hOut,
+        _tLastWrite;
+
+    // Sparsity pattern and coloring of the Jacobian
+    bool
+        _colored,
+        _sparse;          ///< iteration matrices factorized with KLU
+
+    int
+        _nonzeros,
+        _iterNonzeros,    ///< nonzeros of the iteration matrix (pattern and diagonal)
+        _maxColors,
+        *_Ap,
+        *_Ai,
+        *_Tp,             ///< compressed columns of the iteration matrix
+        *_Ti,
+        *_TPos,           ///< position of the nonzeros of the Jacobian in _Ti
+        *_TDiag,          ///< position of the diagonal in _Ti
+        *_colorOfColumn;
+
+#if defined(klu)
+    klu_symbolic* _kluSymbolic;
+    klu_numeric* _kluNumeric[5];
+    klu_common _kluCommon[5];
+#endif
 
 
 
@@ -16,8 +16,9 @@ of ordinary differantial equations of the form
 
 z' = f(t,z).
 
-Dense output may be used. Zero crossing are detected by bisection or linear
-interpolation.
+Dense output may be used. Zero crossings are localized by the Illinois
+method on the cubic Hermite interpolant of the last step, only the zero
+functions are evaluated during the search.
 
 \date     01.09.2008
 \author
@@ -79,9 +80,12 @@ private:
 
     // Hilfsfunktionen
     //------------------------------------------
-    // Interpolation der Lösung für RK12-Verfahren
+    /// Kubische Hermite-Interpolation der Lösung im letzten Schritt [_t0,_t1]
     void interp1(double time, double* value);
 
+    /// Speichert Zustand und rechte Seite am Intervallanfang für die Interpolation
+    void startStep();
+
     double toleranceOK(double z1, double z2, double relTol, double absTol);
 
     double relError(double z1, double z2);
@@ -90,6 +94,9 @@ private:
     void doMyZeroSearch();
     void doZeroSearch();
 
+    /// Event handling after a step, continues without restart if no state was reinitialized
+    void handleZeroCrossing(const double& tNext);
+
     // gibt den Wert der Nullstellenfunktion für die Zeit t und den Zustand y wieder
     void giveZeroVal(const double &t,const double *y,double *zeroValue);
 
@@ -127,8 +134,8 @@ private:
         *_zInit,                                    // Temp            - Initial state vector
         *_zWrite,                                   // Temp            - write to res
 
-        *_f0,
-        *_f1,
+        *_f0,                                       // Right hand side at left border of latent interval
+        *_f1,                                       // Right hand side at right border of latent interval
 
 		*_zDot0,									// state derivative for state
 		*_zDotPred;									// state derivative for predictor state
@@ -151,6 +158,8 @@ private:
         _doubleZeroDistance,                        ///< Temp            - In case of two zeros in one intervall (doubleZero): distance between zeros
         _tZero,                                        ///< Temp            - Nullstelle
         _tLastWrite,                                ///< Temp            - Letzter Ausgabezeitpunkt
+        _t0,                                        ///< Temp            - Left border of latent interval
+        _t1,                                        ///< Temp            - Right border of latent interval
         _zeroTol;
 
 
@@ -34,4 +34,9 @@ private:
            *_x_old,
            *_x_new;
     bool _firstuse;
+
+    void* _umfSymbolic;   ///< symbolic analysis of the sparsity pattern _Ap, _Ai
+    int* _Ap;
+    int* _Ai;
+    int _nonzeros;
 };
@@ -296,6 +296,9 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
      map<string, EmitResults> emitResultsMap = MAP_LIST_OF
        "all", EMIT_ALL MAP_LIST_SEP "public", EMIT_PUBLIC MAP_LIST_SEP
        "none", EMIT_NONE MAP_LIST_END;
+     map<string, KrylovMethod> krylovMethodMap = MAP_LIST_OF
+       "none", KRYLOV_NONE MAP_LIST_SEP "gmres", KRYLOV_GMRES MAP_LIST_SEP
+       "bicgstab", KRYLOV_BICGSTAB MAP_LIST_END;
      po::options_description desc("Allowed options");
 
      //program options that can be overwritten by OMEdit must be declared as vector
@@ -305,6 +308,8 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
      desc.add_options()
           ("help", "produce help message")
           ("nls-continue", po::bool_switch()->default_value(false), "non linear solver will continue if it can not reach the given precision")
+          ("nls-krylov", po::value< string >()->default_value("none"), "Jacobian-free Newton-Krylov method of the non linear solver: none (dense Jacobian), gmres, bicgstab")
+          ("nls-no-precond", po::bool_switch()->default_value(false), "do not precondition the Krylov method with an incomplete LU factorization")
           ("runtime-library,R", po::value<string>(), "path to cpp runtime libraries")
           ("modelica-system-library,M",  po::value<string>(), "path to Modelica library")
           ("results-file,F", po::value<vector<string> >(),"name of results file")
@@ -324,6 +329,8 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
           ("output-type,O", po::value< string >()->default_value("all"), "the points in time written to result file: all (output steps + events), step (just output points), none")
           ("output-format,P", po::value< string >()->default_value("mat"), "simulation results output format: csv, mat, buffer, empty")
           ("emit-results,U", po::value< string >()->default_value("public"), "emit results: all, public, none")
+          ("ensemble", po::value< string >(), "file with one line per instance of an ensemble simulation: results file and overrides, e.g. 'run1.mat stop-time=2 real[3]=0.5'")
+          ("ensemble-threads", po::value< int >()->default_value(0), "number of threads of an ensemble simulation (default 0 meaning number of cores)")
           ;
 
      // a group for all options that should not be visible if '--help' is set
@@ -447,13 +454,27 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
            "Unknown emit-results " + emitResults_str);
      }
 
+     KrylovMethod nlsKrylovMethod;
+     string nlsKrylov_str = vm["nls-krylov"].as<string>();
+     if (krylovMethodMap.find(nlsKrylov_str) != krylovMethodMap.end())
+       nlsKrylovMethod = krylovMethodMap[nlsKrylov_str];
+     else
+       throw ModelicaSimulationError(MODEL_FACTORY,
+         "Unknown nls-krylov " + nlsKrylov_str);
+     bool nlsPreconditioning = !vm["nls-no-precond"].as<bool>();
+
+     string ensembleFile;
+     if (vm.count("ensemble"))
+       ensembleFile = vm["ensemble"].as<string>();
+     int ensembleThreads = vm["ensemble-threads"].as<int>();
+
      fs::path libraries_path = fs::path( runtime_lib_path) ;
      fs::path modelica_path = fs::path( modelica_lib_path) ;
 
      libraries_path.make_preferred();
      modelica_path.make_preferred();
 
-     SimSettings settings = {solver,linSolver,nonLinSolver,starttime,stoptime,stepsize,1e-24,0.01,tolerance,resultsfilename,timeOut,outputPointType,logSettings,nlsContinueOnError,solverThreads,outputFormat,emitResults};
+     SimSettings settings = {solver,linSolver,nonLinSolver,starttime,stoptime,stepsize,1e-24,0.01,tolerance,resultsfilename,timeOut,outputPointType,logSettings,nlsContinueOnError,solverThreads,outputFormat,emitResults,nlsKrylovMethod,nlsPreconditioning,ensembleFile,ensembleThreads};
 
      _library_path = libraries_path.string();
      _modelicasystem_path = modelica_path.string();
@@ -14,6 +14,9 @@ BroydenSettings::BroydenSettings()
 , _dAtol                        (1e-6)
 , _dDelta                    (1)
 , _continueOnError(false)
+, _krylovMethod(KRYLOV_NONE)
+, _usePreconditioner(true)
+, _preconditionerUpdate(10)
 {
 };
 
@@ -72,4 +75,34 @@ bool BroydenSettings::getContinueOnError()
 {
   return _continueOnError;
 }
+
+KrylovMethod BroydenSettings::getKrylovMethod()
+{
+  return _krylovMethod;
+}
+
+void BroydenSettings::setKrylovMethod(KrylovMethod method)
+{
+  _krylovMethod = method;
+}
+
+bool BroydenSettings::getUsePreconditioner()
+{
+  return _usePreconditioner;
+}
+
+void BroydenSettings::setUsePreconditioner(bool value)
+{
+  _usePreconditioner = value;
+}
+
+int BroydenSettings::getPreconditionerUpdate()
+{
+  return _preconditionerUpdate;
+}
+
+void BroydenSettings::setPreconditionerUpdate(int iterations)
+{
+  _preconditionerUpdate = iterations;
+}
 /** @} */ // end of solverBroyden
@@ -49,7 +49,8 @@ Cvode::Cvode(IMixedSystem* system, ISolverSettings* settings)
       _CV_y(),
       _CV_yWrite(),
       _maxColors(0),
-      _jacobianANonzeros(0)
+      _jacobianANonzeros(0),
+      _sparseLinearSolver(false)
 {
   _data = ((void*) this);
 
@@ -116,6 +117,10 @@ Cvode::~Cvode()
     delete [] _deltaInv;
   if(_ysave)
     delete [] _ysave;
+  if(_jacobianAIndex)
+    delete [] _jacobianAIndex;
+  if(_jacobianALeadindex)
+    delete [] _jacobianALeadindex;
 
   #ifdef RUNTIME_PROFILING
   if(measuredFunctionStartValues)
@@ -283,25 +288,39 @@ void Cvode::initialize()
     if (_idid < 0)
       throw ModelicaSimulationError(SOLVER,/*_idid,_tCurrent,*/"Cvode::initialize()");
 
+    // Use own jacobian matrix if the system provides its sparsity pattern
+    bool coloredJac = _continuous_system->getDimContinuousStates() > 0 && initializeColoredJac();
+
     // Initialize linear solver
-    #ifdef USE_SUNDIALS_LAPACK
-      _idid = CVLapackDense(_cvodeMem, _dimSys);
-    #else
-      _idid = CVDense(_cvodeMem, _dimSys);
+    #ifdef USE_SUNDIALS_KLU
+    // sparse LU factorization, memory and cost depend on the nonzeros of the Jacobian
+    _sparseLinearSolver = coloredJac;
+    if (_sparseLinearSolver)
+    {
+      #if SUNDIALS_MINOR_VERSION > 6
+        _idid = CVKLU(_cvodeMem, _dimSys, _jacobianANonzeros, CSC_MAT);
+      #else
+        _idid = CVKLU(_cvodeMem, _dimSys, _jacobianANonzeros);
+      #endif
+      if (_idid < 0)
+        throw ModelicaSimulationError(SOLVER,"Cvode::initialize(): CVKLU failed");
+      _idid = CVSlsSetSparseJacFn(_cvodeMem, &CV_SlsJCallback);
+    }
+    else
     #endif
-    if (_idid < 0)
-      throw ModelicaSimulationError(SOLVER,"Cvode::initialize()");
-
-  // Use own jacobian matrix
-  // Check if Colored Jacobians are worth to use
-   #if SUNDIALS_MAJOR_VERSION >= 2 || (SUNDIALS_MAJOR_VERSION == 2 && SUNDIALS_MINOR_VERSION >= 4)
-    _maxColors = _system->getAMaxColors();
-    if(_maxColors < _dimSys && _continuous_system->getDimContinuousStates() > 0)
     {
-   // _idid = CVDlsSetDenseJacFn(_cvodeMem, &CV_JCallback);
-   // initializeColoredJac();
-  }
-  #endif
+      #ifdef USE_SUNDIALS_LAPACK
+        _idid = CVLapackDense(_cvodeMem, _dimSys);
+      #else
+        _idid = CVDense(_cvodeMem, _dimSys);
+      #endif
+      if (_idid < 0)
+        throw ModelicaSimulationError(SOLVER,"Cvode::initialize()");
+
+      // Colored Jacobians are worth to use if there are less colors than states
+      if (coloredJac && _maxColors < _dimSys)
+        _idid = CVDlsSetDenseJacFn(_cvodeMem, &CV_JCallback);
+    }
 
   if (_idid < 0)
       throw ModelicaSimulationError(SOLVER,"CVode::initialize()");
@@ -787,26 +806,78 @@ int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeig
 {
   try
   {
-  int l,g;
-  double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur, delta_inv;
+    calcJacobianIncrements(N, y, fy, errorWeight);
+    calcColoredJacobian(t, y, NV_DATA_S(fy), NV_DATA_S(fHelp), Jac->data, false);
+  }
+  //workaround until exception can be catch from c- libraries
+  catch (std::exception & ex )
+  {
 
-  f_data = NV_DATA_S(fy);
-  errorWeight_data = NV_DATA_S(errorWeight);
-  fHelp_data = NV_DATA_S(fHelp);
+    cerr << "CVode integration error: " <<  ex.what();
+    return 1;
+  }
+
+
+  return 0;
+}
+
+#ifdef USE_SUNDIALS_KLU
+int Cvode::CV_SlsJCallback(double t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  return ((Cvode*) user_data)->calcSparseJacobian(t, NV_DATA_S(y), fy, Jac, tmp1, tmp2);
+}
+
+int Cvode::calcSparseJacobian(double t, double* y, N_Vector fy, SlsMat Jac, N_Vector fHelp, N_Vector errorWeight)
+{
+  try
+  {
+    memcpy(SLS_COLPTRS(Jac), _jacobianALeadindex, (_dimSys + 1) * sizeof(int));
+    memcpy(SLS_ROWVALS(Jac), _jacobianAIndex, _jacobianANonzeros * sizeof(int));
+
+    if (_mixed_system->isAnalyticJacobianGenerated())
+    {
+      // symbolic Jacobian, evaluated at (t,y)
+      calcFunction(t, y, NV_DATA_S(fHelp));
+      sparsematrix_t& A = _mixed_system->getSparseJacobian();
+      if ((int)A.nnz() != _jacobianANonzeros)
+        throw ModelicaSimulationError(SOLVER, "Cvode::calcSparseJacobian(): sparsity pattern of the Jacobian changed");
+      memcpy(Jac->data, boost::numeric::bindings::begin_value(A), _jacobianANonzeros * sizeof(double));
+    }
+    else
+    {
+      calcJacobianIncrements(_dimSys, y, fy, errorWeight);
+      calcColoredJacobian(t, y, NV_DATA_S(fy), NV_DATA_S(fHelp), Jac->data, true);
+    }
+  }
+  //workaround until exception can be catch from c- libraries
+  catch (std::exception & ex )
+  {
+    cerr << "CVode integration error: " <<  ex.what();
+    return 1;
+  }
 
+  return 0;
+}
+#endif
+
+void Cvode::calcJacobianIncrements(long int N, const double* y, N_Vector fy, N_Vector errorWeight)
+{
+  double fnorm, minInc, *errorWeight_data, h, srur;
+
+  errorWeight_data = NV_DATA_S(errorWeight);
 
   //Get relevant info
   _idid = CVodeGetErrWeights(_cvodeMem, errorWeight);
   if (_idid < 0)
-    {
-      _idid = -5;
-      throw ModelicaSimulationError(SOLVER,"Cvode::calcJacobian()");
+  {
+    _idid = -5;
+    throw ModelicaSimulationError(SOLVER,"Cvode::calcJacobian()");
   }
   _idid = CVodeGetCurrentStep(_cvodeMem, &h);
   if (_idid < 0)
-    {
-      _idid = -5;
-      throw ModelicaSimulationError(SOLVER,"Cvode::calcJacobian()");
+  {
+    _idid = -5;
+    throw ModelicaSimulationError(SOLVER,"Cvode::calcJacobian()");
   }
 
   srur = sqrt(UROUND);
@@ -818,110 +889,47 @@ int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeig
   for(int j=0;j<N;j++)
   {
     _delta[j] = max(srur*abs(y[j]), minInc/errorWeight_data[j]);
-  }
-
-  for(int j=0;j<N;j++)
-  {
     _deltaInv[j] = 1/_delta[j];
   }
+}
 
- if (_jacobianANonzeros != 0)
- {
+void Cvode::calcColoredJacobian(double t, double* y, const double* f, double* fHelp, double* jac, bool compressed)
+{
   for(int color=1; color <= _maxColors; color++)
   {
-      for(int k=0; k < _dimSys; k++)
+    // perturb all columns of this color at once, they have no common nonzero row
+    for(int k=0; k < _dimSys; k++)
     {
-      if((_colorOfColumn[k] ) == color)
+      if(_colorOfColumn[k] == color)
       {
         _ysave[k] = y[k];
         y[k]+= _delta[k];
       }
     }
 
-    calcFunction(t, y, fHelp_data);
-
-  for (int k = 0; k < _dimSys; k++)
-   {
-       if((_colorOfColumn[k]) == color)
-     {
-        y[k] = _ysave[k];
+    calcFunction(t, y, fHelp);
 
-    int startOfColumn = k * _dimSys;
-    for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k+1];j++)
+    for (int k = 0; k < _dimSys; k++)
+    {
+      if(_colorOfColumn[k] == color)
       {
-        l = _jacobianAIndex[j];
-        g = l + startOfColumn;
-        Jac->data[g] = (fHelp_data[l] - f_data[l]) * _deltaInv[k];
-      }
-    }
-  }
-  }
- }
-
-
-
-
-
-  }
-
-
-
-
-
-
-  /*
-  //Calculation of J without colouring
-   for (j = 0; j < N; j++)
-   {
-
-
-    //N_VSetArrayPointer(DENSE_COL(Jac,j), jthCol);
-
-     _ysave[j] = y[j];
-
-    y[j] += _delta[j];
-
-    calcFunction(t, y, fHelp_data);
-
-    y[j] = _ysave[j];
-
-    delta_inv = 1.0/_delta[j];
-    N_VLinearSum(delta_inv, fHelp, -delta_inv, fy, jthCol);
+        y[k] = _ysave[k];
 
-    for(int i=0; i<_dimSys; ++i)
+        // dense column major or compressed columns with the pattern of A
+        for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k+1];j++)
         {
-            Jac->data[i+j*_dimSys] = NV_Ith_S(jthCol,i);
+          int l = _jacobianAIndex[j];
+          jac[compressed ? j : l + k * _dimSys] = (fHelp[l] - f[l]) * _deltaInv[k];
         }
-
-    //DENSE_COL(Jac,j) = N_VGetArrayPointer(jthCol);
-  }
-  */
-
-    //workaround until exception can be catch from c- libraries
-  catch (std::exception & ex )
-  {
-
-    cerr << "CVode integration error: " <<  ex.what();
-    return 1;
+      }
+    }
   }
-
-
-  return 0;
 }
 
-void Cvode::initializeColoredJac()
+bool Cvode::initializeColoredJac()
 {
-
-  if(_colorOfColumn)
-	  delete [] _colorOfColumn;
-  _colorOfColumn = new int[_dimSys];
-  _system->getAColorOfColumn( _colorOfColumn, _dimSys);
-
- // _system->getJacobian(_jacobianA);
-  //_jacobianANonzeros  = boost::numeric::bindings::traits::spmatrix_num_nonzeros (_jacobianA);
- // _jacobianAIndex     = bindings::begin_index_minor(_jacobianA);
-  //_jacobianALeadindex = bindings::begin_index_major(_jacobianA);
-
+  return SolverDefaultImplementation::initializeSparsePattern("Cvode", _dimSys, _jacobianANonzeros, _jacobianALeadindex,
+                                                              _jacobianAIndex, _maxColors, _colorOfColumn);
 }
 
 int Cvode::reportErrorMessage(ostream& messageStream)
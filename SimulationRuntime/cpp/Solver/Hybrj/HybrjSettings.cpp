@@ -14,6 +14,9 @@ HybrjSettings::HybrjSettings()
 , _dAtol                        (1.0)
 , _dDelta                    (0.9)
 , _continueOnError(false)
+, _krylovMethod(KRYLOV_NONE)
+, _usePreconditioner(true)
+, _preconditionerUpdate(10)
 {
 };
 /*max. Anzahl an Newtonititerationen pro Schritt (default: 25)*/
@@ -66,4 +69,34 @@ bool HybrjSettings::getContinueOnError()
 {
   return _continueOnError;
 }
+
+KrylovMethod HybrjSettings::getKrylovMethod()
+{
+  return _krylovMethod;
+}
+
+void HybrjSettings::setKrylovMethod(KrylovMethod method)
+{
+  _krylovMethod = method;
+}
+
+bool HybrjSettings::getUsePreconditioner()
+{
+  return _usePreconditioner;
+}
+
+void HybrjSettings::setUsePreconditioner(bool value)
+{
+  _usePreconditioner = value;
+}
+
+int HybrjSettings::getPreconditionerUpdate()
+{
+  return _preconditionerUpdate;
+}
+
+void HybrjSettings::setPreconditionerUpdate(int iterations)
+{
+  _preconditionerUpdate = iterations;
+}
 /** @} */ // end of solverHybrj
@@ -2,6 +2,7 @@
 #include <Core/Modelica.h>
 #include <Solver/IDA/IDA.h>
 #include <Core/Math/Functions.h>
+#include <Core/Utils/numeric/bindings/ublas/matrix_sparse.hpp>
 
 //#include <Core/Utils/numeric/bindings/traits/ublas_vector.hpp>
 //#include <Core/Utils/numeric/bindings/traits/ublas_sparse.hpp>
@@ -56,7 +57,13 @@ Ida::Ida(IMixedSystem* system, ISolverSettings* settings)
       _zeroFound(false),
       _maxColors(0),
       _tLastWrite(-1.0),
-      _jacobianANonzeros(0)
+      _jacobianANonzeros(0),
+      _jacobianNonzeros(0),
+      _jacobianIndex(NULL),
+      _jacobianLeadindex(NULL),
+      _jacobianPos(NULL),
+      _jacobianDiag(NULL),
+      _sparseLinearSolver(false)
 {
   _data = ((void*) this);
   #ifdef RUNTIME_PROFILING
@@ -131,6 +138,18 @@ Ida::~Ida()
 
   if (_colorOfColumn)
     delete [] _colorOfColumn;
+  if (_jacobianAIndex)
+    delete [] _jacobianAIndex;
+  if (_jacobianALeadindex)
+    delete [] _jacobianALeadindex;
+  if (_jacobianIndex)
+    delete [] _jacobianIndex;
+  if (_jacobianLeadindex)
+    delete [] _jacobianLeadindex;
+  if (_jacobianPos)
+    delete [] _jacobianPos;
+  if (_jacobianDiag)
+    delete [] _jacobianDiag;
   if(_delta)
     delete [] _delta;
   if(_deltaInv)
@@ -329,9 +348,38 @@ void Ida::initialize()
       throw std::invalid_argument(/*_idid,_tCurrent,*/"IDA::initialize()");
 
     // Initialize linear solver
-    _idid = IDADense(_idaMem, _dimSys);
-    if (_idid < 0)
-      throw std::invalid_argument("IDA::initialize()");
+    // the pattern of A is only known for the ODE formulation F = f(y) - y'
+    bool coloredJac = _dimAE == 0 && initializeColoredJac();
+    _sparseLinearSolver = false;
+#ifdef USE_SUNDIALS_KLU
+    if (coloredJac)
+    {
+  #if SUNDIALS_MINOR_VERSION > 6
+      _idid = IDAKLU(_idaMem, _dimSys, _jacobianNonzeros, CSC_MAT);
+  #else
+      _idid = IDAKLU(_idaMem, _dimSys, _jacobianNonzeros);
+  #endif
+      if (_idid < 0)
+        throw std::invalid_argument("IDA::initialize()");
+      _idid = IDASlsSetSparseJacFn(_idaMem, &sparseJacobianFunctionCB);
+      if (_idid < 0)
+        throw std::invalid_argument("IDA::initialize()");
+      _sparseLinearSolver = true;
+    }
+#endif
+    if (!_sparseLinearSolver)
+    {
+      _idid = IDADense(_idaMem, _dimSys);
+      if (_idid < 0)
+        throw std::invalid_argument("IDA::initialize()");
+      // Use own jacobian matrix if the coloring saves residual evaluations
+      if (coloredJac && _maxColors < _dimSys)
+      {
+        _idid = IDADlsSetDenseJacFn(_idaMem, &jacobianFunctionCB);
+        if (_idid < 0)
+          throw std::invalid_argument("IDA::initialize()");
+      }
+    }
     if(_dimAE>0)
 	{
 	    _idid = IDASetSuppressAlg(_idaMem, TRUE);
@@ -344,11 +392,6 @@ void Ida::initialize()
          throw std::invalid_argument("IDA::initialize()");
 	}
 
-  // Use own jacobian matrix
-  //_idid = CVDlsSetDenseJacFn(_idaMem, &jacobianFunctionCB);
-  //if (_idid < 0)
-  //    throw std::invalid_argument("IDA::initialize()");
-
     if (_dimZeroFunc)
     {
       _idid = IDARootInit(_idaMem, _dimZeroFunc, &zeroFunctionCB);
@@ -910,130 +953,154 @@ int Ida::zeroFunctionCB(double t, N_Vector y, N_Vector yp, double *zeroval, void
   return (0);
 }
 
-int Ida::jacobianFunctionCB(long int N, double t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+int Ida::jacobianFunctionCB(long int N, realtype t, realtype c_j, N_Vector y, N_Vector yp, N_Vector r, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
 {
-  return ((Ida*) user_data)->calcJacobian(t,N, tmp1, tmp2, tmp3,  NV_DATA_S(y), fy, Jac);
+  return ((Ida*) user_data)->calcJacobian(t, c_j, N, tmp1, tmp2, NV_DATA_S(y), NV_DATA_S(yp), r, Jac);
+}
 
+int Ida::calcJacobian(double t, double c_j, long int N, N_Vector fHelp, N_Vector errorWeight, double* y, double* yp, N_Vector r, DlsMat Jac)
+{
+  try
+  {
+    // dF/dy + c_j*dF/dy' = A - c_j*I, Jac is zero on entry
+    calcJacobianIncrements(N, y, r, errorWeight);
+    calcColoredJacobian(t, y, yp, NV_DATA_S(r), NV_DATA_S(fHelp), Jac->data, false);
+    for (int k = 0; k < _dimSys; k++)
+      Jac->data[k + k * _dimSys] -= c_j;
+  }
+  //workaround until exception can be catch from c- libraries
+  catch (std::exception& ex)
+  {
+    std::string error = ex.what();
+    cerr << "IDA integration error: " << error;
+    return 1;
+  }
+
+  return 0;
 }
 
+#ifdef USE_SUNDIALS_KLU
+int Ida::sparseJacobianFunctionCB(realtype t, realtype c_j, N_Vector y, N_Vector yp, N_Vector r, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  return ((Ida*) user_data)->calcSparseJacobian(t, c_j, NV_DATA_S(y), NV_DATA_S(yp), r, Jac, tmp1, tmp2);
+}
 
-int Ida::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthCol, double* y, N_Vector fy, DlsMat Jac)
+int Ida::calcSparseJacobian(double t, double c_j, double* y, double* yp, N_Vector r, SlsMat Jac, N_Vector fHelp, N_Vector errorWeight)
 {
   try
   {
-  int l,g;
-  double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur, delta_inv;
+    memcpy(SLS_COLPTRS(Jac), _jacobianLeadindex, (_dimSys + 1) * sizeof(int));
+    memcpy(SLS_ROWVALS(Jac), _jacobianIndex, _jacobianNonzeros * sizeof(int));
+    memset(Jac->data, 0, _jacobianNonzeros * sizeof(double));
 
-  f_data = NV_DATA_S(fy);
-  errorWeight_data = NV_DATA_S(errorWeight);
-  fHelp_data = NV_DATA_S(fHelp);
+    if (_mixed_system->isAnalyticJacobianGenerated())
+    {
+      // symbolic Jacobian, evaluated at (t,y)
+      calcFunction(t, y, yp, NV_DATA_S(fHelp));
+      sparsematrix_t& A = _mixed_system->getSparseJacobian();
+      if ((int)A.nnz() != _jacobianANonzeros)
+        throw std::invalid_argument("IDA::calcSparseJacobian(): sparsity pattern of the Jacobian changed");
+      const double* values = boost::numeric::bindings::begin_value(A);
+      for (int j = 0; j < _jacobianANonzeros; j++)
+        Jac->data[_jacobianPos[j]] = values[j];
+    }
+    else
+    {
+      calcJacobianIncrements(_dimSys, y, r, errorWeight);
+      calcColoredJacobian(t, y, yp, NV_DATA_S(r), NV_DATA_S(fHelp), Jac->data, true);
+    }
+    for (int k = 0; k < _dimSys; k++)
+      Jac->data[_jacobianDiag[k]] -= c_j;
+  }
+  //workaround until exception can be catch from c- libraries
+  catch (std::exception& ex)
+  {
+    std::string error = ex.what();
+    cerr << "IDA integration error: " << error;
+    return 1;
+  }
 
+  return 0;
+}
+#endif
+
+void Ida::calcJacobianIncrements(long int N, const double* y, N_Vector r, N_Vector errorWeight)
+{
+  double fnorm, minInc, *errorWeight_data, h, srur;
+
+  errorWeight_data = NV_DATA_S(errorWeight);
 
   //Get relevant info
   _idid = IDAGetErrWeights(_idaMem, errorWeight);
   if (_idid < 0)
-    {
-      _idid = -5;
-      throw std::invalid_argument("IDA::calcJacobian()");
+  {
+    _idid = -5;
+    throw std::invalid_argument("IDA::calcJacobian()");
   }
   _idid = IDAGetCurrentStep(_idaMem, &h);
   if (_idid < 0)
-    {
-      _idid = -5;
-      throw std::invalid_argument("IDA::calcJacobian()");
+  {
+    _idid = -5;
+    throw std::invalid_argument("IDA::calcJacobian()");
   }
 
   srur = sqrt(UROUND);
 
-  fnorm = N_VWrmsNorm(fy, errorWeight);
+  fnorm = N_VWrmsNorm(r, errorWeight);
   minInc = (fnorm != 0.0) ?
            (1000.0 * abs(h) * UROUND * N * fnorm) : 1.0;
 
   for(int j=0;j<N;j++)
   {
     _delta[j] = max(srur*abs(y[j]), minInc/errorWeight_data[j]);
-  }
-    for(int j=0;j<N;j++)
-  {
     _deltaInv[j] = 1/_delta[j];
   }
+}
 
-  // Calculation of the jacobian
-
- if (_jacobianANonzeros != 0)
- {
+void Ida::calcColoredJacobian(double t, double* y, double* yp, const double* r, double* rHelp, double* jac, bool compressed)
+{
   for(int color=1; color <= _maxColors; color++)
   {
-      for(int k=0; k < _dimSys; k++)
+    // perturb all columns of this color at once, they have no common nonzero row
+    for(int k=0; k < _dimSys; k++)
     {
-      if((_colorOfColumn[k] ) == color)
+      if(_colorOfColumn[k] == color)
       {
         _ysave[k] = y[k];
         y[k]+= _delta[k];
       }
     }
 
-    calcFunction(t, y, fHelp_data,fHelp_data);
+    calcFunction(t, y, yp, rHelp);
 
-  for (int k = 0; k < _dimSys; k++)
-   {
-       if((_colorOfColumn[k]) == color)
-     {
-        y[k] = _ysave[k];
-
-    int startOfColumn = k * _dimSys;
-    for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k+1];j++)
+    for (int k = 0; k < _dimSys; k++)
+    {
+      if(_colorOfColumn[k] == color)
       {
-        l = _jacobianAIndex[j];
-        g = l + startOfColumn;
-        Jac->data[g] = (fHelp_data[l] - f_data[l]) * _deltaInv[k];
-      }
-    }
-  }
-  }
- }
-
-  /*
-  //Calculation of J without colouring
-   for (j = 0; j < N; j++)
-   {
-
-
-    //N_VSetArrayPointer(DENSE_COL(Jac,j), jthCol);
-
-     _ysave[j] = y[j];
-
-    y[j] += _delta[j];
-
-    calcFunction(t, y, fHelp_data);
-
-    y[j] = _ysave[j];
-
-    delta_inv = 1.0/_delta[j];
-    N_VLinearSum(delta_inv, fHelp, -delta_inv, fy, jthCol);
+        y[k] = _ysave[k];
 
-    for(int i=0; i<_dimSys; ++i)
+        // dense column major or compressed columns with the pattern of A - c_j*I
+        for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k+1];j++)
         {
-            Jac->data[i+j*_dimSys] = NV_Ith_S(jthCol,i);
+          int l = _jacobianAIndex[j];
+          jac[compressed ? _jacobianPos[j] : l + k * _dimSys] = (rHelp[l] - r[l]) * _deltaInv[k];
         }
-
-    //DENSE_COL(Jac,j) = N_VGetArrayPointer(jthCol);
-  }
-  */
-
- }      //workaround until exception can be catch from c- libraries
-  catch (std::exception& ex)
-  {
-    std::string error = ex.what();
-    cerr << "IDA integration error: " << error;
-    return 1;
+      }
+    }
   }
-
-
-  return 0;
 }
 
-
+bool Ida::initializeColoredJac()
+{
+  if (!SolverDefaultImplementation::initializeSparsePattern("IDA", _dimSys, _jacobianANonzeros, _jacobianALeadindex,
+                                                            _jacobianAIndex, _maxColors, _colorOfColumn))
+    return false;
+
+  // pattern of the iteration matrix dG/dy + c_j*dG/dy'
+  _jacobianNonzeros = insertDiagonal(_dimSys, _jacobianANonzeros, _jacobianALeadindex, _jacobianAIndex,
+                                     _jacobianLeadindex, _jacobianIndex, _jacobianPos, _jacobianDiag);
+  return true;
+}
 
 int Ida::reportErrorMessage(ostream& messageStream)
 {
@@ -14,6 +14,7 @@
 //#include<wvLib.h>
 
 #include<Core/Math/ILapack.h>
+#include <Core/Math/Constants.h>
 #include <Solver/Kinsol/FactoryExport.h>
 
 #include <nvector/nvector_serial.h>
@@ -53,6 +54,8 @@
 Forward declarations for used external C functions
 */
 int kin_fCallback(N_Vector y, N_Vector fval, void *user_data);
+int kin_PrecSetupCallback(N_Vector u, N_Vector uscale, N_Vector fu, N_Vector fscale, void *user_data, N_Vector tmp1, N_Vector tmp2);
+int kin_PrecSolveCallback(N_Vector u, N_Vector uscale, N_Vector fu, N_Vector fscale, N_Vector v, void *user_data, N_Vector tmp);
 /*will be used with new sundials version
 int kin_SlsSparseJacFn(N_Vector u, N_Vector fu,SlsMat J, void *user_data,N_Vector tmp1, N_Vector tmp2);
 int kin_DlsDenseJacFn(long int N, N_Vector u, N_Vector fu,DlsMat J, void *user_data,N_Vector tmp1, N_Vector tmp2);
@@ -70,6 +73,25 @@ int kin_fCallback(N_Vector y,N_Vector fval, void *user_data)
 	Kinsol* myKinsol =  (Kinsol*)(user_data);
 	return  myKinsol->kin_f(y,fval,user_data);
 }
+/**\Callback functions for the preconditioner of the Krylov methods, call internal Kinsol member functions
+ *  \param [in] u variables vector
+ *  \param [in] fu right hand side vector
+ *  \param [in,out] v right hand side of the preconditioner system, overwritten by its solution
+ *  \param [in] user_data user data pointer is used to access Kinsol instance
+ *  \return status value
+ */
+int kin_PrecSetupCallback(N_Vector u, N_Vector uscale, N_Vector fu, N_Vector fscale, void *user_data, N_Vector tmp1, N_Vector tmp2)
+{
+	Kinsol* myKinsol =  (Kinsol*)(user_data);
+	return  myKinsol->kin_PrecSetup(u,fu);
+}
+
+int kin_PrecSolveCallback(N_Vector u, N_Vector uscale, N_Vector fu, N_Vector fscale, N_Vector v, void *user_data, N_Vector tmp)
+{
+	Kinsol* myKinsol =  (Kinsol*)(user_data);
+	return  myKinsol->kin_PrecSolve(v);
+}
+
  /**\Callback function for Kinsol to calculate sparse jacobian matrix, calls internal Kinsol member function
  *  \param [in] u Parameter_Description
  *  \param [in] fu Parameter_Description
@@ -131,6 +153,7 @@ Kinsol::Kinsol(INonLinearAlgLoop* algLoop, INonLinSolverSettings* settings)
 	, _Kin_yScale         (NULL)
 	, _Kin_fScale         (NULL)
 	, _kinMem             (NULL)
+	, _iluAge             (0)
 	/*
 	, _kluSymbolic 			(NULL)
     , _kluNumeric			(NULL)
@@ -241,7 +264,8 @@ void Kinsol::initialize()
 			_currentIterate   = new double[_dimSys];
             _y_old            = new double[_dimSys];
             _y_new            = new double[_dimSys];
-			_jac              = new double[_dimSys*_dimSys];
+			// no dense matrix of size _dimSys^2 in Krylov mode
+			_jac              = _kinsolSettings->getKrylovMethod() == KRYLOV_NONE ? new double[_dimSys*_dimSys] : NULL;
 			_yHelp            = new double[_dimSys];
 			_fHelp            = new double[_dimSys];
 
@@ -253,7 +277,8 @@ void Kinsol::initialize()
 			memset(_helpArray, 0, _dimSys*sizeof(double));
 			memset(_yHelp, 0, _dimSys*sizeof(double));
 			memset(_fHelp, 0, _dimSys*sizeof(double));
-			memset(_jac, 0, _dimSys*_dimSys*sizeof(double));
+			if(_jac)
+				memset(_jac, 0, _dimSys*_dimSys*sizeof(double));
 			memset(_currentIterate, 0, _dimSys*sizeof(double));
 
 			_algLoop->getNominalReal(_yScale);
@@ -311,7 +336,11 @@ void Kinsol::initialize()
 			if (check_flag(&idid, (char *)"KINSetUserData", 1))
 				throw ModelicaSimulationError(ALGLOOP_SOLVER,"Kinsol::initialize()");
 
-			KINDense(_kinMem, _dimSys);
+			if(_kinsolSettings->getKrylovMethod() == KRYLOV_NONE)
+				KINDense(_kinMem, _dimSys);
+			else
+				initKrylov(_kinsolSettings->getKrylovMethod());
+			_ilu.reset(_dimSys);
 
 			/*will be used with new sundials version
 			if(_algLoop->isLinearTearing())
@@ -371,53 +400,60 @@ void Kinsol::solve()
 	_iterationStatus = CONTINUE;
 
 
+	// Jacobian-free Newton-Krylov: the dense Jacobian is never formed,
+	// the iterative solvers are tried directly
+	KrylovMethod krylov = _kinsolSettings->getKrylovMethod();
+
 	// Try Dense first
 	////////////////////////////
-	if(_usedCompletePivoting || _usedIterativeSolver)
+	if(krylov == KRYLOV_NONE)
 	{
-		KINDense(_kinMem, _dimSys);
-		_usedCompletePivoting = false;
-		_usedIterativeSolver = false;
-	}
+		if(_usedCompletePivoting || _usedIterativeSolver)
+		{
+			KINDense(_kinMem, _dimSys);
+			_usedCompletePivoting = false;
+			_usedIterativeSolver = false;
+		}
 
-	for(int i=0;i<_dimSys;i++) // Reset Scaling
-		_fScale[i] = 1.0;
+		for(int i=0;i<_dimSys;i++) // Reset Scaling
+			_fScale[i] = 1.0;
 
-	solveNLS();
-	if(_iterationStatus == DONE)
-	{
-		_algLoop->setReal(_y);
-		_algLoop->evaluate();
+		solveNLS();
+		if(_iterationStatus == DONE)
+		{
+			_algLoop->setReal(_y);
+			_algLoop->evaluate();
 
-		return;
-	}
-	else  // Try Scaling
-	{
-		_iterationStatus = CONTINUE;
-		_algLoop->setReal(_y0);
-		_algLoop->evaluate();
-		_algLoop->getRHS(_fScale);
-		for(int i=0;i<_dimSys;i++)
+			return;
+		}
+		else  // Try Scaling
 		{
+			_iterationStatus = CONTINUE;
+			_algLoop->setReal(_y0);
+			_algLoop->evaluate();
+			_algLoop->getRHS(_fScale);
+			for(int i=0;i<_dimSys;i++)
+			{
 
-			if(abs(_fScale[i]) >1.0)
-			_fScale[i] = abs(1/_fScale[i]);
-			else
-			_fScale[i] = 1;
+				if(abs(_fScale[i]) >1.0)
+				_fScale[i] = abs(1/_fScale[i]);
+				else
+				_fScale[i] = 1;
 
-		}
+			}
 
-		_iterationStatus = CONTINUE;
+			_iterationStatus = CONTINUE;
 
-		solveNLS();
-	}
+			solveNLS();
+		}
 
-	if(_iterationStatus == DONE)
-	{
-		_algLoop->setReal(_y);
-		_algLoop->evaluate();
+		if(_iterationStatus == DONE)
+		{
+			_algLoop->setReal(_y);
+			_algLoop->evaluate();
 
-		return;
+			return;
+		}
 	}
 
 	// Try complete pivoting
@@ -464,7 +500,7 @@ void Kinsol::solve()
 	for(int i=0;i<_dimSys;i++) // Reset Scaling
 		_fScale[i] = 1.0;
 
-	KINSpgmr(_kinMem,_dimSys);
+	initKrylov(krylov == KRYLOV_BICGSTAB ? KRYLOV_BICGSTAB : KRYLOV_GMRES);
 
 	_iterationStatus = CONTINUE;
 	solveNLS();
@@ -503,7 +539,7 @@ void Kinsol::solve()
 	for(int i=0;i<_dimSys;i++) // Reset Scaling
 		_fScale[i] = 1.0;
 
-	KINSpbcg(_kinMem,_dimSys);
+	initKrylov(krylov == KRYLOV_BICGSTAB ? KRYLOV_GMRES : KRYLOV_BICGSTAB);
 	_iterationStatus = CONTINUE;
 	solveNLS();
 	if(_iterationStatus == DONE)
@@ -649,6 +685,67 @@ int Kinsol::kin_JacDense(long int N, N_Vector u, N_Vector fu,DlsMat J, void *use
 	return 0;
 }
 */
+void Kinsol::initKrylov(KrylovMethod method)
+{
+	// without Krylov mode the iterative solvers are the fallback of the dense solver
+	bool krylov = _kinsolSettings->getKrylovMethod() != KRYLOV_NONE;
+	int maxl = krylov ? std::min(_dimSys, 30L) : _dimSys;
+
+	if(method == KRYLOV_BICGSTAB)
+		KINSpbcg(_kinMem, maxl);
+	else
+	{
+		KINSpgmr(_kinMem, maxl);
+		if(krylov)
+			KINSpilsSetMaxRestarts(_kinMem, 5);
+	}
+
+	if(krylov && _kinsolSettings->getUsePreconditioner())
+	{
+		int idid = KINSpilsSetPreconditioner(_kinMem, kin_PrecSetupCallback, kin_PrecSolveCallback);
+		if (check_flag(&idid, (char *)"KINSpilsSetPreconditioner", 1))
+			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Kinsol::initKrylov()");
+		// every Newton iteration asks for a setup, kin_PrecSetup decides about the update
+		KINSetMaxSetupCalls(_kinMem, 1);
+	}
+}
+
+/**\brief Incomplete LU factorization of the finite difference Jacobian as preconditioner
+ *  \details The factorization is only renewed every getPreconditionerUpdate() Newton iterations
+ */
+int Kinsol::kin_PrecSetup(N_Vector u, N_Vector fu)
+{
+	if(_ilu.isFactorized() && ++_iluAge < _kinsolSettings->getPreconditionerUpdate())
+		return 0;
+
+	double* uData = NV_DATA_S(u);
+	double* fData = NV_DATA_S(fu);
+	double* yScale = NV_DATA_S(_Kin_yScale);
+	_ilu.reset(_dimSys);
+	for(int j=0;j<_dimSys;j++)
+	{
+		memcpy(_yHelp, uData, _dimSys*sizeof(double));
+		double stepsize = sqrt(UROUND)*std::max(std::abs(uData[j]), 1.0/yScale[j]);
+		_yHelp[j] += stepsize;
+		calcFunction(_yHelp, _fHelp);
+		if(!_fValid)
+			return 1; // setup failure, the next strategy of solve() is tried
+		for(int i=0;i<_dimSys;i++)
+			_fHelp[i] = (_fHelp[i] - fData[i])/stepsize;
+		_ilu.setColumn(j, _fHelp, 1e-12);
+	}
+	_ilu.factorize();
+	_iluAge = 0;
+	LOGGER_WRITE("Kinsol: preconditioner updated (" + to_string(_ilu.nnz()) + " nonzeros)",LC_NLS,LL_DEBUG);
+	return 0;
+}
+
+int Kinsol::kin_PrecSolve(N_Vector v)
+{
+	_ilu.solve(NV_DATA_S(v));
+	return 0;
+}
+
 void Kinsol::stepCompleted(double time)
 {
 	memcpy(_y0,_y,_dimSys*sizeof(double));
@@ -13,6 +13,9 @@ KinsolSettings::KinsolSettings()
 , _dAtol           (1.0)
 , _dDelta          (0.9)
 , _continueOnError(false)
+, _krylovMethod(KRYLOV_NONE)
+, _usePreconditioner(true)
+, _preconditionerUpdate(10)
 {
 };
 /*max. Anzahl an Newtonititerationen pro Schritt (default: 25)*/
@@ -65,4 +68,34 @@ bool KinsolSettings::getContinueOnError()
 {
   return _continueOnError;
 }
+
+KrylovMethod KinsolSettings::getKrylovMethod()
+{
+  return _krylovMethod;
+}
+
+void KinsolSettings::setKrylovMethod(KrylovMethod method)
+{
+  _krylovMethod = method;
+}
+
+bool KinsolSettings::getUsePreconditioner()
+{
+  return _usePreconditioner;
+}
+
+void KinsolSettings::setUsePreconditioner(bool value)
+{
+  _usePreconditioner = value;
+}
+
+int KinsolSettings::getPreconditionerUpdate()
+{
+  return _preconditionerUpdate;
+}
+
+void KinsolSettings::setPreconditionerUpdate(int iterations)
+{
+  _preconditionerUpdate = iterations;
+}
 /** @} */ // end of solverKinsol
@@ -22,7 +22,11 @@
 
 LinearSolver::LinearSolver(ILinearAlgLoop* algLoop, ILinSolverSettings* settings)
 	: _algLoop            (algLoop)
+	, _iterationStatus    (CONTINUE)
 	, _dimSys             (0)
+	, _firstCall          (true)
+	, _ihelpArray         (NULL)
+	, _jhelpArray		  (NULL)
 
 	, _y                  (NULL)
 	, _y0                  (NULL)
@@ -30,9 +34,11 @@ LinearSolver::LinearSolver(ILinearAlgLoop* algLoop, ILinSolverSettings* settings
     , _y_new(NULL)
 	, _b                  (NULL)
 	, _A                (NULL)
-	, _ihelpArray         (NULL)
-	, _jhelpArray		  (NULL)
+	, _Acopy            (NULL)
 	, _zeroVec            (NULL)
+	, _scale			  (NULL)
+	, _factorized         (false)
+	, _fullPivot          (false)
 
 	#if defined(klu)
 		, _kluSymbolic 			(NULL)
@@ -41,11 +47,9 @@ LinearSolver::LinearSolver(ILinearAlgLoop* algLoop, ILinSolverSettings* settings
 		, _Ai					(NULL)
 		, _Ap					(NULL)
 		, _Ax					(NULL)
+		, _Axcopy				(NULL)
+		, _nonzeros				(-1)
 	#endif
-
-	, _iterationStatus    (CONTINUE)
-	, _firstCall          (true)
-	, _scale			  (NULL)
 {
 	_sparse = _algLoop->getUseSparseFormat();
 }
@@ -58,6 +62,7 @@ LinearSolver::~LinearSolver()
     if(_y_new)            delete [] _y_new;
 	if(_b)                delete []  _b;
 	if(_A)              delete []  _A;
+	if(_Acopy)            delete []  _Acopy;
 	if(_ihelpArray)       delete []  _ihelpArray;
 	if (_jhelpArray)       delete[]  _jhelpArray;
 	if(_zeroVec)          delete []  _zeroVec;
@@ -78,6 +83,8 @@ LinearSolver::~LinearSolver()
 				delete [] _Ap;
 			if(_Ai)
 				delete [] _Ai;
+			if(_Axcopy)
+				delete [] _Axcopy;
 		}
 	#endif
 }
@@ -89,7 +96,9 @@ void LinearSolver::initialize()
 	_algLoop->initialize();
 
 	int dimDouble=_algLoop->getDimReal();
-	int ok=0;
+
+	//the system matrix may have changed, e.g. at an event
+	_factorized = false;
 
 	if (dimDouble!=_dimSys)
 	{
@@ -104,6 +113,7 @@ void LinearSolver::initialize()
 			if(_y_new)           delete [] _y_new;
 			if(_b)               delete []  _b;
 			if(_A)             delete []  _A;
+			if(_Acopy)           delete []  _Acopy;
 			if(_ihelpArray)      delete []  _ihelpArray;
 			if (_jhelpArray)       delete[]  _jhelpArray;
 			if(_zeroVec)         delete []  _zeroVec;
@@ -115,6 +125,7 @@ void LinearSolver::initialize()
 			_y_new            = new double[_dimSys];
 			_b                = new double[_dimSys];
 			_A              = new double[_dimSys*_dimSys];
+			_Acopy            = new double[_dimSys*_dimSys];
 			_ihelpArray       = new long int[_dimSys];
 			_jhelpArray		  = new long int[_dimSys];
 			_zeroVec          = new double[_dimSys];
@@ -134,39 +145,16 @@ void LinearSolver::initialize()
 			#if defined(klu)
 				if(_sparse == true)
 				{
-					_kluCommon = new klu_common;
-					ok=klu_defaults (_kluCommon);
-					if (ok!=1) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error initializing Sparse Solver KLU");
-
-					sparsematrix_t& A = _algLoop->getSystemSparseMatrix();
-
-					 _nonzeros = A.nnz();
-
+					if(!_kluCommon)
+					{
+						_kluCommon = new klu_common;
+						if (klu_defaults (_kluCommon)!=1) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error initializing Sparse Solver KLU");
+					}
+					if(_Ap)
+						delete [] _Ap;
 					_Ap = new int[(_dimSys + 1)];
-					_Ai = new int[_nonzeros];
-					_Ax = new double[_nonzeros];
-
-					int const* Ti= boost::numeric::bindings::begin_compressed_index_major (A);
-					int const* Tj= boost::numeric::bindings::begin_index_minor (A);
-
-					_Ax= boost::numeric::bindings::begin_value (A);
-
-					//testing, whether Ax is modified
-					double *Ax=0;
-					Ax = new double[_nonzeros];
-					for(int i=0;i<_nonzeros;i++) Ax[i]=_Ax[i];
-
-					memcpy(_Ap,Ti,sizeof(int)* (_dimSys + 1) );
-					memcpy(_Ai,Tj,sizeof(int)* (_nonzeros) );
-
-					_kluSymbolic = klu_analyze (_dimSys, _Ap, _Ai, _kluCommon);
-					_kluNumeric = klu_factor (_Ap, _Ai, _Ax, _kluSymbolic, _kluCommon);
-					if (_kluNumeric==NULL) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error during numerical factorization with Sparse Solver KLU");
-
-					//testing, whether Ax is modified
-					for(int i=0;i<_nonzeros;i++) if(Ax[i]!=_Ax[i]) std::cout << "Ax was modified" << std::endl;
-					if(Ax)
-					delete [] Ax;
+					//the pattern is analyzed with the first system matrix in solve
+					_nonzeros = -1;
 				}
 			#endif
 		}
@@ -200,176 +188,77 @@ void LinearSolver::solve()
 		const matrix_t& A = _algLoop->getSystemMatrix();
 		const double* Atemp = A.data().begin();
 
-		memcpy(_A, Atemp, _dimSys*_dimSys*sizeof(double));
+		//the factorization is only renewed if the coefficients have changed since the last call
+		if (!_factorized || memcmp(_Acopy, Atemp, _dimSys*_dimSys*sizeof(double)) != 0)
+		{
+			memcpy(_Acopy, Atemp, _dimSys*_dimSys*sizeof(double));
+			memcpy(_A, Atemp, _dimSys*_dimSys*sizeof(double));
+
+			dgetrf_(&_dimSys, &_dimSys, _A, &_dimSys, _ihelpArray, &irtrn);
 
-		/*
-		//output routine
-		std::cout << std::endl;
-		std::cout << "We solve a linear system with coefficient matrix" << std::endl;
-		for (int i=0;i<_dimSys;i++){
-			for (int j=0;j<_dimSys;j++){
-				std::cout << Atemp[i+j*_dimSys] << " ";
+			if (irtrn != 0)
+			{
+				//LU factorization with complete pivoting, singular values are perturbed
+				memcpy(_A, Atemp, _dimSys*_dimSys*sizeof(double));
+				dgetc2_(&_dimSys, _A, &_dimSys, _ihelpArray, _jhelpArray, &irtrn);
+				_fullPivot = true;
+				LOGGER_WRITE("LinearSolver: Linear system singular, using perturbed system matrix.", LC_NLS, LL_DEBUG);
 			}
-			std::cout << std::endl;
+			else
+				_fullPivot = false;
+			_factorized = true;
 		}
-		std::cout << "and right hand side" << std::endl;
-		for (int i=0;i<_dimSys;i++){
-			std::cout << _b[i] << " ";
-		}
-		std::cout << std::endl;
-		*/
-
 
-		dgesv_(&_dimSys,&dimRHS,_A,&_dimSys,_ihelpArray,_b,&_dimSys,&irtrn);
-
-		if  (irtrn != 0)
-		{
-			dgetc2_(&_dimSys, _A, &_dimSys, _ihelpArray, _jhelpArray, &irtrn);
+		if (_fullPivot)
 			dgesc2_(&_dimSys, _A, &_dimSys, _b, _ihelpArray, _jhelpArray, _scale);
-			LOGGER_WRITE("LinearSolver: Linear system singular, using perturbed system matrix.", LC_NLS, LL_DEBUG);
-			_iterationStatus = DONE;
-		}
 		else
-			_iterationStatus = DONE;
+		{
+			char trans = 'N';
+			dgetrs_(&trans, &_dimSys, &dimRHS, _A, &_dimSys, _ihelpArray, _b, &_dimSys, &irtrn);
+		}
+		_iterationStatus = DONE;
 	}else{
 
 		#if defined(klu)
-
-
-			//testing sparse with dense
-			/*this version is a test. it extracts the dense format out of the sparse format and uses the dense lapack solver to sove the dense problem.
-
-			//writing entries of A
 			sparsematrix_t& A = _algLoop->getSystemSparseMatrix();
-			_Ax= boost::numeric::bindings::begin_value (A);
-
-
-			double** a = new double*[_dimSys];
-			double* asdf = new double[_dimSys*_dimSys];
-			for(int i=0;i<_dimSys;i++){
-				a[i]=new double[_dimSys];
-			}
-
-			for(int i=0;i<_dimSys;i++){
-				for(int j=0;j<_dimSys;j++){
-					a[i][j]=0;
-					for(int k=_Ap[j];k<_Ap[j+1];k++)
-						if(i==_Ai[k])
-							a[i][j]=_Ax[k];
-				}
-			}
-
-			for(int i=0;i<_dimSys;i++){
-				for(int j=0;j<_dimSys;j++){
-					asdf[i+j*_dimSys]=a[i][j];
-				}
-			}
-
-			//output routine
-			std::cout << std::endl;
-			std::cout << "We solve a linear system with coefficient matrix" << std::endl;
-			for (int i=0;i<_dimSys;i++){
-				for (int j=0;j<_dimSys;j++){
-					std::cout << asdf[i+j*_dimSys] << " ";
-				}
-				std::cout << std::endl;
-			}
-			std::cout << "and right hand side" << std::endl;
-			for (int i=0;i<_dimSys;i++){
-				std::cout << _b[i] << " ";
+			int nonzeros = A.nnz();
+			int const* Ti = boost::numeric::bindings::begin_compressed_index_major (A);
+			int const* Tj = boost::numeric::bindings::begin_index_minor (A);
+			_Ax = boost::numeric::bindings::begin_value (A);
+
+			//the symbolic analysis is only repeated if the sparsity pattern has changed
+			if (nonzeros != _nonzeros
+				|| memcmp(_Ap, Ti, sizeof(int)*(_dimSys + 1)) != 0
+				|| memcmp(_Ai, Tj, sizeof(int)*nonzeros) != 0)
+			{
+				analyzeSparsePattern(nonzeros, Ti, Tj);
 			}
-			std::cout << std::endl;
-
-
 
-
-
-			dgesv_(&_dimSys,&dimRHS,asdf,&_dimSys,_ihelpArray,_b,&_dimSys,&irtrn);
-			_iterationStatus = DONE;
-			for(int i=0;i<_dimSys;i++){
-				delete [] a[i];
+			int ok;
+			if (_kluNumeric == NULL)
+			{
+				_kluNumeric = klu_factor (_Ap, _Ai, _Ax, _kluSymbolic, _kluCommon);
+				if (_kluNumeric==NULL) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error during numerical factorization with Sparse Solver KLU");
 			}
-			delete [] a;
-			delete [] asdf;
-
-			/*test for ccs-dense-conversion
-			// testSparse2.cpp : Defines the entry point for the console application.
-			//
-
-			#include "stdafx.h"
-
-
-			int _tmain(int argc, _TCHAR* argv[])
+			else if (memcmp(_Axcopy, _Ax, sizeof(double)*_nonzeros) != 0)
 			{
-				int _dimSys = 3;
-				int _Ap[4] = {0,3,5,6};
-				int _Ai[6] = { 0, 1, 2, 1, 2, 2 };
-				int _Ax[6] = { 5, 4, 3, 2, 1, 8 };
-
-				double** a = new double*[_dimSys];
-				for (int i = 0; i<_dimSys; i++){
-					a[i] = new double[_dimSys];
-				}
-
-				for (int i = 0; i<_dimSys; i++){
-					for (int j = 0; j<_dimSys; j++){
-						a[i][j] = 0;
-						for (int k = _Ap[j]; k<_Ap[j + 1]; k++)
-							if (i == _Ai[k])
-								a[i][j] += _Ax[k];
-					}
-				}
-
-				for (int i = 0; i < _dimSys; i++){
-					for (int j = 0; j < _dimSys; j++){
-						printf("a(%i,%i)=%e\n", i, j, a[i][j]);
-					}
-				}
+				//same pattern, new values: refactor with the pivoting of the last factorization
+				ok = klu_refactor (_Ap, _Ai, _Ax, _kluSymbolic, _kluNumeric, _kluCommon);
 
-				for (int i = 0; i<_dimSys; i++){
-					delete[] a[i];
+				//checking for accuracy of refactorization
+				if (ok == 1)
+					ok = klu_rgrowth(_Ap, _Ai, _Ax, _kluSymbolic, _kluNumeric, _kluCommon);
+				if (ok != 1 || _kluCommon->rgrowth < 1e-3){
+					klu_free_numeric(&_kluNumeric, _kluCommon);
+					_kluNumeric = klu_factor (_Ap, _Ai, _Ax, _kluSymbolic, _kluCommon);
+					if (_kluNumeric==NULL) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error during numerical factorization with Sparse Solver KLU");
 				}
-				delete[] a;
-				return 0;
-			}
-			*/
-
-
-			//version with klu
-
-			/*
-			//testing, whether Ax is modified
-			double *Ax=NULL;
-			Ax = new double[_nonzeros];
-			for(int i=0;i<_nonzeros;i++) Ax[i]=_Ax[i];
-			*/
-
-
-			//writing entries of A
-			sparsematrix_t& A = _algLoop->getSystemSparseMatrix();
-			_Ax= boost::numeric::bindings::begin_value (A);
-
-			int ok = klu_refactor (_Ap, _Ai, _Ax, _kluSymbolic, _kluNumeric, _kluCommon) ;
-
-			//checking for accuracy of refactorization
-			ok = klu_rgrowth(_Ap, _Ai, _Ax, _kluSymbolic, _kluNumeric, _kluCommon);
-			if (ok!=1) throw ModelicaSimulationError(ALGLOOP_SOLVER,"Sparse Solver KLU: error checking accuracy of refactorization by computing reciprocal pivot growth");
-			if (_kluCommon->rgrowth < 1e-3){
-				klu_free_numeric(&_kluNumeric, _kluCommon);
-				_kluNumeric = klu_factor (_Ap, _Ai, _Ax, _kluSymbolic, _kluCommon);
-				if (_kluNumeric==NULL) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error during numerical factorization with Sparse Solver KLU");
 			}
+			memcpy(_Axcopy, _Ax, sizeof(double)*_nonzeros);
 
 			ok=klu_solve (_kluSymbolic, _kluNumeric, _dimSys, 1, _b, _kluCommon) ;
 			if (ok!=1) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error solving Sparse Solver KLU");
-
-			/*
-			//testing, whether Ax is modified
-			for(int i=0;i<_nonzeros;i++) if(Ax[i]!=_Ax[i]) std::cout << "Ax was modified" << std::endl;
-			if(Ax)
-			delete [] Ax;
-			*/
-
+			_iterationStatus = DONE;
 		#else
 			throw ModelicaSimulationError(ALGLOOP_SOLVER,"error solving linear system with klu not implemented");
 		#endif
@@ -397,6 +286,37 @@ void LinearSolver::solve()
 	if(_algLoop->isLinearTearing())		_algLoop->evaluate();//warum nur in diesem Fall??
 }
 
+#if defined(klu)
+/**
+ *  \brief Symbolic analysis of a new sparsity pattern
+ *  \details Copies the compressed column pattern and discards the factorizations of the old pattern
+ */
+void LinearSolver::analyzeSparsePattern(int nonzeros, int const* Ap, int const* Ai)
+{
+	if(_kluNumeric)
+		klu_free_numeric(&_kluNumeric, _kluCommon);
+	if(_kluSymbolic)
+		klu_free_symbolic(&_kluSymbolic, _kluCommon);
+
+	if(nonzeros != _nonzeros)
+	{
+		if(_Ai)
+			delete [] _Ai;
+		if(_Axcopy)
+			delete [] _Axcopy;
+		_Ai = new int[nonzeros];
+		_Axcopy = new double[nonzeros];
+	}
+	_nonzeros = nonzeros;
+	memcpy(_Ap, Ap, sizeof(int)*(_dimSys + 1));
+	memcpy(_Ai, Ai, sizeof(int)*_nonzeros);
+
+	_kluSymbolic = klu_analyze (_dimSys, _Ap, _Ai, _kluCommon);
+	if (_kluSymbolic==NULL) throw ModelicaSimulationError(ALGLOOP_SOLVER,"error during symbolic analysis with Sparse Solver KLU");
+	LOGGER_WRITE("LinearSolver: new sparsity pattern analyzed",LC_NLS,LL_DEBUG);
+}
+#endif
+
 IAlgLoopSolver::ITERATIONSTATUS LinearSolver::getIterationStatus()
 {
 	return _iterationStatus;
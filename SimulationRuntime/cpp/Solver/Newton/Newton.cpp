@@ -15,24 +15,28 @@
 #include <Core/Math/Constants.h>   // definitializeion of constants like uround
 
 Newton::Newton(INonLinearAlgLoop* algLoop, INonLinSolverSettings* settings)
-  : _algLoop          (algLoop)
-  , _newtonSettings   ((INonLinSolverSettings*)settings)
+  : _newtonSettings   ((INonLinSolverSettings*)settings)
+  , _algLoop          (algLoop)
+  , _iterationStatus  (CONTINUE)
+  , _dimSys           (0)
+  , _firstCall        (true)
   , _yNames           (NULL)
   , _yNominal         (NULL)
   , _yMin             (NULL)
   , _yMax             (NULL)
   , _y                (NULL)
-  , _yHelp            (NULL)
-  , _yTest            (NULL)
   , _fNominal         (NULL)
   , _f                (NULL)
+  , _yHelp            (NULL)
   , _fHelp            (NULL)
+  , _yTest            (NULL)
   , _fTest            (NULL)
-  , _iHelp            (NULL)
   , _jac              (NULL)
-  , _dimSys           (0)
-  , _firstCall        (true)
-  , _iterationStatus  (CONTINUE)
+  , _yKrylov          (NULL)
+  , _fKrylov          (NULL)
+  , _dy               (NULL)
+  , _iHelp            (NULL)
+  , _iluAge           (0)
   , _lc               (LC_NLS)
 {
 }
@@ -52,6 +56,9 @@ Newton::~Newton()
   if (_fTest)    delete []    _fTest;
   if (_iHelp)    delete []    _iHelp;
   if (_jac)      delete []    _jac;
+  if (_yKrylov)  delete []    _yKrylov;
+  if (_fKrylov)  delete []    _fKrylov;
+  if (_dy)       delete []    _dy;
 }
 
 void Newton::initialize()
@@ -86,6 +93,9 @@ void Newton::initialize()
       if (_fTest)    delete []    _fTest;
       if (_iHelp)    delete []    _iHelp;
       if (_jac)      delete []    _jac;
+      if (_yKrylov)  delete []    _yKrylov;
+      if (_fKrylov)  delete []    _fKrylov;
+      if (_dy)       delete []    _dy;
 
       _yNames       = new const char* [_dimSys];
       _yNominal     = new double[_dimSys];
@@ -99,12 +109,18 @@ void Newton::initialize()
       _fHelp        = new double[_dimSys];
       _fTest        = new double[_dimSys];
       _iHelp        = new long int[_dimSys];
-      _jac          = new double[_dimSys*_dimSys];
+      _yKrylov      = new double[_dimSys];
+      _fKrylov      = new double[_dimSys];
+      _dy           = new double[_dimSys];
+      // the dense Jacobian is not needed by the Krylov methods
+      _jac          = _newtonSettings->getKrylovMethod() == KRYLOV_NONE ?
+                      new double[_dimSys*_dimSys] : NULL;
 
       _algLoop->getNamesReal(_yNames);
       _algLoop->getNominalReal(_yNominal);
       _algLoop->getMinReal(_yMin);
       _algLoop->getMaxReal(_yMax);
+      _ilu.reset(_dimSys);
     }
     else {
       _iterationStatus = SOLVERERROR;
@@ -153,7 +169,20 @@ void Newton::solve()
       LOGGER_WRITE_VECTOR("y" + to_string(totSteps), _y, _dimSys, _lc, LL_DEBUG);
       LOGGER_WRITE_VECTOR("f" + to_string(totSteps), _f, _dimSys, _lc, LL_DEBUG);
 
-      calcJacobian(_jac, _fNominal);
+      bool krylov = _newtonSettings->getKrylovMethod() != KRYLOV_NONE;
+      if (krylov) {
+        if (_newtonSettings->getUsePreconditioner()) {
+          if (!_ilu.isFactorized() || _iluAge >= _newtonSettings->getPreconditionerUpdate())
+            updatePreconditioner(_fNominal);
+          _iluAge++;
+        }
+        else if (totSteps == 0) {
+          for (int i = 0; i < _dimSys; i++)
+            _fNominal[i] = std::max(std::abs(_f[i]), 1e2 * atol);
+        }
+      }
+      else
+        calcJacobian(_jac, _fNominal);
 
       // Initialize line search function
       double phi = 0.0;
@@ -163,12 +192,16 @@ void Newton::solve()
       }
 
       // Solve linear system
-      dgesv_(&_dimSys, &dimRHS, _jac, &_dimSys, _iHelp, _f, &_dimSys, &info);
-
-      if (info != 0)
-        throw ModelicaSimulationError(ALGLOOP_SOLVER,
-          "error solving nonlinear system (iteration: " + to_string(totSteps)
-          + ", dgesv info: " + to_string(info) + ")");
+      if (krylov)
+        calcKrylovStep(_f, phi);
+      else {
+        dgesv_(&_dimSys, &dimRHS, _jac, &_dimSys, _iHelp, _f, &_dimSys, &info);
+
+        if (info != 0)
+          throw ModelicaSimulationError(ALGLOOP_SOLVER,
+            "error solving nonlinear system (iteration: " + to_string(totSteps)
+            + ", dgesv info: " + to_string(info) + ")");
+      }
 
       // Increase counter
       ++ totSteps;
@@ -349,6 +382,104 @@ void Newton::calcJacobian(double *jac, double *fNominal)
       jac[idx] /= fNominal[i];
 }
 
+void Newton::calcKrylovStep(double *f, double phi)
+{
+  // inexact Newton: the accuracy of the linear solution follows the residual
+  double eta = std::max(_newtonSettings->getRtol(), std::min(0.1, std::sqrt(phi)));
+  int maxIter = std::max(20, (int)std::min(_dimSys, 500L));
+  int iter;
+
+  std::fill(_dy, _dy + _dimSys, 0.0);
+  if (_newtonSettings->getKrylovMethod() == KRYLOV_BICGSTAB)
+    iter = solveBiCGStab(*this, _dimSys, f, _dy, eta, maxIter);
+  else
+    iter = solveGMRES(*this, _dimSys, f, _dy, eta, maxIter, 30);
+
+  if (iter < 0) {
+    LOGGER_WRITE("Krylov method did not converge for eq" +
+                 to_string(_algLoop->getEquationIndex()) +
+                 ", continuing with inexact Newton step", _lc, LL_DEBUG);
+  }
+  else {
+    LOGGER_WRITE("Krylov iterations: " + to_string(iter), _lc, LL_DEBUG);
+  }
+
+  std::copy(_dy, _dy + _dimSys, f);
+}
+
+void Newton::apply(const double* v, double* Jv)
+{
+  // finite difference in direction v, _f holds the scaled residuals at _y
+  double vnorm = 0.0, ynorm = 0.0;
+  for (int i = 0; i < _dimSys; i++) {
+    vnorm += v[i] * v[i];
+    ynorm += _y[i] * _y[i];
+  }
+  if (vnorm == 0.0) {
+    std::fill(Jv, Jv + _dimSys, 0.0);
+    return;
+  }
+  double eps = std::sqrt(UROUND) * std::max(1.0, std::sqrt(ynorm)) / std::sqrt(vnorm);
+
+  for (int i = 0; i < _dimSys; i++)
+    _yKrylov[i] = _y[i] + eps * v[i];
+  calcFunction(_yKrylov, _fKrylov);
+  for (int i = 0; i < _dimSys; i++)
+    Jv[i] = (_fKrylov[i] / _fNominal[i] - _f[i]) / eps;
+}
+
+void Newton::precondition(double* v)
+{
+  // the Krylov methods see the scaled Jacobian diag(fNominal)^-1 * J
+  if (_ilu.isFactorized()) {
+    for (int i = 0; i < _dimSys; i++)
+      v[i] *= _fNominal[i];
+    _ilu.solve(v);
+  }
+}
+
+void Newton::updatePreconditioner(double *fNominal)
+{
+  const double *Adata = NULL;
+  std::fill(fNominal, fNominal + _dimSys, 1e2 * _newtonSettings->getAtol());
+
+  // Use analytic Jacobian if available
+  try {
+    const matrix_t& A = _algLoop->getSystemMatrix();
+    if (A.size1() == _dimSys && A.size2() == _dimSys)
+      Adata = A.data().begin();
+  }
+  catch (ModelicaSimulationError& ex) {
+    LOGGER_WRITE("Analytic Jacobian failed for eq" +
+                 to_string(_algLoop->getEquationIndex()) + " at time " +
+                 to_string(_algLoop->getSimTime()) + ": " + ex.what(),
+                 _lc, LL_WARNING);
+  }
+
+  // Assemble the Jacobian column by column, only its nonzeros are kept
+  _ilu.reset(_dimSys);
+  for (int j = 0; j < _dimSys; j++) {
+    if (Adata != NULL)
+      std::copy(Adata + j * _dimSys, Adata + (j + 1) * _dimSys, _fHelp);
+    else {
+      std::copy(_y, _y + _dimSys, _yHelp);
+      double stepsize = 1e2 * _newtonSettings->getRtol() * _yNominal[j];
+      _yHelp[j] += stepsize;
+      calcFunction(_yHelp, _fHelp);
+      for (int i = 0; i < _dimSys; i++)
+        _fHelp[i] = (_fHelp[i] - _f[i]) / stepsize;
+    }
+    for (int i = 0; i < _dimSys; i++)
+      fNominal[i] = std::max(std::abs(_fHelp[i]), fNominal[i]);
+    _ilu.setColumn(j, _fHelp, 1e-12);
+  }
+  _ilu.factorize();
+  _iluAge = 0;
+
+  LOGGER_WRITE("Newton: preconditioner of eq" + to_string(_algLoop->getEquationIndex()) +
+               " updated (" + to_string(_ilu.nnz()) + " nonzeros)", _lc, LL_DEBUG);
+}
+
 void Newton::restoreOldValues()
 {
 }
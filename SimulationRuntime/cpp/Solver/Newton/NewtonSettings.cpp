@@ -14,6 +14,9 @@ NewtonSettings::NewtonSettings()
   , _dAtol                     (1e-8)
   , _dDelta                    (1)
   , _continueOnError           (false)
+  , _krylovMethod              (KRYLOV_NONE)
+  , _usePreconditioner         (true)
+  , _preconditionerUpdate      (10)
 {
 }
 
@@ -79,4 +82,34 @@ bool NewtonSettings::getContinueOnError()
   return _continueOnError;
 }
 
+KrylovMethod NewtonSettings::getKrylovMethod()
+{
+  return _krylovMethod;
+}
+
+void NewtonSettings::setKrylovMethod(KrylovMethod method)
+{
+  _krylovMethod = method;
+}
+
+bool NewtonSettings::getUsePreconditioner()
+{
+  return _usePreconditioner;
+}
+
+void NewtonSettings::setUsePreconditioner(bool value)
+{
+  _usePreconditioner = value;
+}
+
+int NewtonSettings::getPreconditionerUpdate()
+{
+  return _preconditionerUpdate;
+}
+
+void NewtonSettings::setPreconditionerUpdate(int iterations)
+{
+  _preconditionerUpdate = iterations;
+}
+
 /** @} */ // end of solverNewton
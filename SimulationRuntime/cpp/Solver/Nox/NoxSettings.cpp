@@ -15,6 +15,9 @@ NoxSettings::NoxSettings()
 , _dAtol           (1.0)
 , _dDelta          (0.9)
 , _continueOnError(false)
+, _krylovMethod(KRYLOV_NONE)
+, _usePreconditioner(true)
+, _preconditionerUpdate(10)
 {
 };
 /*max. Anzahl an Newtonititerationen pro Schritt (default: 25)*/
@@ -67,4 +70,34 @@ bool NoxSettings::getContinueOnError()
 {
   return _continueOnError;
 }
+
+KrylovMethod NoxSettings::getKrylovMethod()
+{
+  return _krylovMethod;
+}
+
+void NoxSettings::setKrylovMethod(KrylovMethod method)
+{
+  _krylovMethod = method;
+}
+
+bool NoxSettings::getUsePreconditioner()
+{
+  return _usePreconditioner;
+}
+
+void NoxSettings::setUsePreconditioner(bool value)
+{
+  _usePreconditioner = value;
+}
+
+int NoxSettings::getPreconditionerUpdate()
+{
+  return _preconditionerUpdate;
+}
+
+void NoxSettings::setPreconditionerUpdate(int iterations)
+{
+  _preconditionerUpdate = iterations;
+}
 /** @} */ // end of solverNox
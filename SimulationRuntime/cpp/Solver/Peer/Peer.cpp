@@ -4,6 +4,7 @@
 #include <Core/Math/Functions.h>
 #include <Core/Math/ILapack.h>
 #include <Solver/Peer/Peer.h>
+#include <limits>
 
 #if defined(USE_MPI) || defined(USE_OPENMP)
 
@@ -20,7 +21,25 @@ Peer::Peer(IMixedSystem* system, ISolverSettings* settings)
       _continuous_system(),
       _time_system(),
       _hOut(0.0),
-      _reuseJacobi(5000)
+      _reuseJacobi(5000),
+      _J(NULL),
+      _Ysave(NULL),
+      _tLastWrite(0.0),
+      _colored(false),
+      _sparse(false),
+      _nonzeros(0),
+      _iterNonzeros(0),
+      _maxColors(0),
+      _Ap(NULL),
+      _Ai(NULL),
+      _Tp(NULL),
+      _Ti(NULL),
+      _TPos(NULL),
+      _TDiag(NULL),
+      _colorOfColumn(NULL)
+#if defined(klu)
+      ,_kluSymbolic(NULL)
+#endif
 /*      _cvodeMem(NULL),
       _z(NULL),
       _zInit(NULL),
@@ -47,6 +66,10 @@ Peer::Peer(IMixedSystem* system, ISolverSettings* settings)
     _ysave(NULL) */
 {
   //_data = ((void*) this);
+#if defined(klu)
+  for(int i = 0; i < 5; i++)
+    _kluNumeric[i] = NULL;
+#endif
 }
 
 Peer::~Peer()
@@ -73,6 +96,31 @@ Peer::~Peer()
     delete [] _P;
   if (_y)
     delete [] _y;
+  if (_J)
+    delete [] _J;
+  if (_Ysave)
+    delete [] _Ysave;
+  if (_Ap)
+    delete [] _Ap;
+  if (_Ai)
+    delete [] _Ai;
+  if (_Tp)
+    delete [] _Tp;
+  if (_Ti)
+    delete [] _Ti;
+  if (_TPos)
+    delete [] _TPos;
+  if (_TDiag)
+    delete [] _TDiag;
+  if (_colorOfColumn)
+    delete [] _colorOfColumn;
+#if defined(klu)
+  for(int i = 0; i < 5; i++)
+    if (_kluNumeric[i])
+      klu_free_numeric(&_kluNumeric[i], &_kluCommon[i]);
+  if (_kluSymbolic)
+    klu_free_symbolic(&_kluSymbolic, &_kluCommon[0]);
+#endif
 
 #ifndef MPIPEER
   for(int i = 1; i < 5; i++)
@@ -119,6 +167,7 @@ void Peer::initialize()
 #endif //MPIPEER
     SolverDefaultImplementation::initialize();
     _dimSys = _continuous_system[0]->getDimContinuousStates();
+    _tLastWrite = _tCurrent;
     _rstages = 5;
 
     _G=new double[5];
@@ -155,33 +204,6 @@ void Peer::initialize()
     _E[23]=-6.85410196624968e+00;
     _E[24]=4.73606797749979e+00;
 
-    _Theta=new double[25];
-    _Theta[0]=0.;
-    _Theta[1]=0.;
-    _Theta[2]=1.;
-    _Theta[3]=0.;
-    _Theta[4]=0.;
-    _Theta[5]=0.045084971874737;
-    _Theta[6]=-0.163118960624632;
-    _Theta[7]=0.527864045000421;
-    _Theta[8]=0.690983005625053;
-    _Theta[9]=-0.100813061875578;
-    _Theta[10]=0.;
-    _Theta[11]=0.;
-    _Theta[12]=0.;
-    _Theta[13]=0.;
-    _Theta[14]=1.;
-    _Theta[15]=1.809016994374949;
-    _Theta[16]=-5.545084971874742;
-    _Theta[17]=9.472135954999576;
-    _Theta[18]=-12.399186938124409;
-    _Theta[19]=7.663118960624626;
-    _Theta[20]=5.854101966249686;
-    _Theta[21]=-17.562305898749063;
-    _Theta[22]=28.416407864998732;
-    _Theta[23]=-33.270509831248397;
-    _Theta[24]=17.562305898749038;
-
     _c=new double[5];
     _c[0]=-1.;
     _c[1]=-6.18033988749895e-01;
@@ -189,6 +211,10 @@ void Peer::initialize()
     _c[3]=6.18033988749895e-01;
     _c[4]=1.;
 
+    // extrapolation of the stages of the last step, constant step size
+    _Theta=new double[25];
+    setStepRatio(1.);
+
     _h = std::max(std::min(_h, _peersettings->getUpperLimit()), _peersettings->getLowerLimit());
     _y = new double[_dimSys];
 
@@ -206,12 +232,23 @@ void Peer::initialize()
         _Y3=new double[_dimSys];
     }
 #else
+    _colored = initializeSparsePattern();
+#if defined(klu)
+    _sparse = _colored;
+#endif
     _F=new double[_dimSys*5];
-    _T=new double[_dimSys*_dimSys*5];
+    if(_sparse) {
+        _J=new double[_nonzeros*5];
+        _T=new double[_iterNonzeros*5];
+    } else {
+        _J=new double[_dimSys*_dimSys*5];
+        _T=new double[_dimSys*_dimSys*5];
+    }
     _P=new long int[_dimSys*5];
     _Y1=new double[_dimSys*_rstages];
     _Y2=new double[_dimSys*_rstages];
     _Y3=new double[_dimSys*_rstages];
+    _Ysave=new double[_dimSys*_rstages];
 #endif
 
     _continuous_system[0]->evaluateAll(IContinuous::ALL);
@@ -269,6 +306,121 @@ void Peer::evalF(const double& t, const double* z, double* f, IContinuous *conti
     continuousSystem->getRHS(f);
 }
 
+void Peer::lagrangeWeights(const double& x, double* w)
+{
+    for(int k=0; k<_rstages; ++k) {
+        w[k]=1.;
+        for(int j=0; j<_rstages; ++j) {
+            if(j!=k) w[k]*=(x-_c[j])/(_c[k]-_c[j]);
+        }
+    }
+}
+
+void Peer::setStepRatio(const double& sigma)
+{
+    // the new stages t+h_old+c_i*h_new are at 1+sigma*c_i in the nodes of the old step
+    for(int i=0; i<_rstages; ++i) {
+        lagrangeWeights(1.+sigma*_c[i], &_Theta[i*_rstages]);
+    }
+}
+
+bool Peer::initializeSparsePattern()
+{
+    if(!SolverDefaultImplementation::initializeSparsePattern("Peer", _dimSys, _nonzeros, _Ap, _Ai, _maxColors, _colorOfColumn))
+        return false;
+    // iteration matrix I - h*gamma*J
+    _iterNonzeros=insertDiagonal(_dimSys, _nonzeros, _Ap, _Ai, _Tp, _Ti, _TPos, _TDiag);
+
+#if defined(klu)
+    for(int i=0; i<5; ++i) {
+        if (klu_defaults(&_kluCommon[i])!=1) throw ModelicaSimulationError(SOLVER,"Peer: error initializing Sparse Solver KLU");
+    }
+    _kluSymbolic = klu_analyze(_dimSys, _Tp, _Ti, &_kluCommon[0]);
+    if (_kluSymbolic==NULL) throw ModelicaSimulationError(SOLVER,"Peer: error during symbolic analysis with Sparse Solver KLU");
+#endif
+    return true;
+}
+
+void Peer::evalJColored(const double& t, const double* y, double* J, IContinuous *continuousSystem, ITime *timeSystem)
+{
+    double* f=new double[_dimSys];
+    double* fh=new double[_dimSys];
+    double* z=new double[_dimSys];
+    double* delta=new double[_dimSys];
+    std::copy(y,y+_dimSys,z);
+    if(!_sparse) std::fill(J,J+_dimSys*_dimSys,0.);
+    evalF(t, z, f, continuousSystem, timeSystem);
+    for(int color=1; color<=_maxColors; ++color)
+    {
+        // columns of the same color have no common nonzero row
+        for(int k=0; k<_dimSys; ++k) {
+            if(_colorOfColumn[k]==color) {
+                delta[k]=1e-8*std::max(1.,std::abs(y[k]));
+                z[k]+=delta[k];
+            }
+        }
+        evalF(t, z, fh, continuousSystem, timeSystem);
+        for(int k=0; k<_dimSys; ++k) {
+            if(_colorOfColumn[k]==color) {
+                z[k]=y[k];
+                for(int j=_Ap[k]; j<_Ap[k+1]; ++j) {
+                    int l=_Ai[j];
+                    J[_sparse ? j : l+k*_dimSys]=(fh[l]-f[l])/delta[k];
+                }
+            }
+        }
+    }
+    delete [] f;
+    delete [] fh;
+    delete [] z;
+    delete [] delta;
+}
+
+bool Peer::factorizeStage(int rank, const double& h)
+{
+    double factor=-h*_G[rank];
+    _hIter[rank]=h;
+    if(_sparse) {
+#if defined(klu)
+        double* Tx=&_T[rank*_iterNonzeros];
+        const double* Jx=&_J[rank*_nonzeros];
+        std::fill(Tx,Tx+_iterNonzeros,0.);
+        for(int j=0; j<_nonzeros; ++j) Tx[_TPos[j]]=factor*Jx[j];
+        for(int k=0; k<_dimSys; ++k) Tx[_TDiag[k]]+=1.;
+        // refactor with the pivoting of the last factorization if it stays accurate
+        if(_kluNumeric[rank]) {
+            int ok=klu_refactor(_Tp, _Ti, Tx, _kluSymbolic, _kluNumeric[rank], &_kluCommon[rank]);
+            if(ok==1) ok=klu_rgrowth(_Tp, _Ti, Tx, _kluSymbolic, _kluNumeric[rank], &_kluCommon[rank]);
+            if(ok==1 && _kluCommon[rank].rgrowth>=1e-3) return true;
+            klu_free_numeric(&_kluNumeric[rank], &_kluCommon[rank]);
+        }
+        _kluNumeric[rank]=klu_factor(_Tp, _Ti, Tx, _kluSymbolic, &_kluCommon[rank]);
+        return _kluNumeric[rank]!=NULL;
+#endif
+    }
+    double* T=&_T[rank*_dimSys*_dimSys];
+    const double* J=&_J[rank*_dimSys*_dimSys];
+    for(int i=0; i<_dimSys*_dimSys; ++i) T[i]=factor*J[i];
+    for(int i=0; i<_dimSys; ++i) T[i*_dimSys+i]+=1.;
+    long int info;
+    dgetrf_(&_dimSys, &_dimSys, T, &_dimSys, &_P[rank*_dimSys], &info);
+    return info==0;
+}
+
+void Peer::solveStage(int rank, double* b)
+{
+#if defined(klu)
+    if(_sparse) {
+        klu_solve(_kluSymbolic, _kluNumeric[rank], _dimSys, 1, b, &_kluCommon[rank]);
+        return;
+    }
+#endif
+    char trans='N';
+    long int dim=1;
+    long int info;
+    dgetrs_(&trans, &_dimSys, &dim, &_T[rank*_dimSys*_dimSys], &_dimSys, &_P[rank*_dimSys], b, &_dimSys, &info);
+}
+
 void Peer::ros2(double * y, double& tstart, double tend, IContinuous *continuousSystem, ITime *timeSystem) {
     double *T=new double[_dimSys*_dimSys];
     double *D=new double[_dimSys];
@@ -299,7 +451,6 @@ void Peer::ros2(double * y, double& tstart, double tend, IContinuous *continuous
 
 void Peer::solve(const SOLVERCALL action)
 {
-    double twrite=_hOut;
     if ((action & RECORDCALL) && (action & FIRST_CALL)) {
         initialize();
         return;
@@ -327,31 +478,7 @@ void Peer::solve(const SOLVERCALL action)
         MPI_Gather(_Y1,_dimSys,MPI_DOUBLE,_Y1,_dimSys,MPI_DOUBLE,0,MPI_COMM_WORLD);
     }
     t+=_h;
-#else
-#pragma omp parallel for num_threads(_numThreads)
-    for(int _rank=0; _rank<5; ++_rank) {
-        std::copy(_y,_y+_dimSys,&_Y1[_rank*_dimSys]);
-        if (abs(_c[_rank]+1.)>1e-12)
-        {
-            ros2(&_Y1[_rank*_dimSys],_tCurrent,_tCurrent+_h*(_c[_rank]+1.), _continuous_system[_rank], _time_system[_rank]);
-            t=_tCurrent;
-        }
-    }
-    t+=_h;
-    _time_system[0]->setTime(t);
-    _continuous_system[0]->setContinuousStates(&_Y1[2*_dimSys]);
-    if(writeOutput) {
-        if(t>=twrite) {
-            _continuous_system[0]->evaluateAll(IContinuous::ALL);
-            SolverDefaultImplementation::writeToFile(0, t, _h);
-            twrite+=_hOut;
-        }
-    }
-#endif
-
-
 
-//    std::cerr << "Finished init at rank  " << _rank<<std::endl;
 // Solution phase
     t+=_h;
     char trans='N';
@@ -359,7 +486,6 @@ void Peer::solve(const SOLVERCALL action)
     int count=0;
     while(std::abs(t-_tEnd)>1e-8)
     {
-#ifdef MPIPEER
         if(_rank==0)
         {
             for(int i=0; i<_rstages; ++i)
@@ -440,82 +566,130 @@ void Peer::solve(const SOLVERCALL action)
             SolverDefaultImplementation::writeToFile(0, t, _h);
         }
         t+=_h;
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    if(_rank==0)
+    {
+        for(int i=0; i<_dimSys; i++) _y[i]=_Y1[(_rstages-1)*_dimSys+i];
+    }
+    MPI_Bcast(_y, _dimSys, MPI_DOUBLE, 0, MPI_COMM_WORLD);
 #else
+    // the starting stages at _tCurrent+(_c[i]+1)*_h must not pass _tEnd
+    _h=std::min(_h,(_tEnd-_tCurrent)/2.);
+#pragma omp parallel for num_threads(_numThreads)
+    for(int _rank=0; _rank<5; ++_rank) {
+        std::copy(_y,_y+_dimSys,&_Y1[_rank*_dimSys]);
+        if (abs(_c[_rank]+1.)>1e-12)
+        {
+            ros2(&_Y1[_rank*_dimSys],_tCurrent,_tCurrent+_h*(_c[_rank]+1.), _continuous_system[_rank], _time_system[_rank]);
+        }
+    }
+    // t is the time of the middle stage, the stages in _Y1 are at t+_c[i]*hOld
+    t=_tCurrent+_h;
+    double hOld=_h;
+    if(writeOutput)
+        writePeerOutput(t, hOld, 0);
+
+// Solution phase
+    const double atol=_peersettings->getATol();
+    const double rtol=_peersettings->getRTol();
+    const double eps=1e-10*std::max(1.,std::abs(_tEnd));
+    int count=0;
+    bool newJacobian=true;
+    while(_tEnd-(t+hOld)>eps)
+    {
+        // the new middle stage is the last stage of the old step
+        double tNew=t+hOld;
+        double h=_h;
+        if(tNew+1.1*h>_tEnd) h=_tEnd-tNew;
+        setStepRatio(h/hOld);
+
         for(int i=0; i<_rstages; ++i)
         {
             for(int j=0; j<_dimSys; ++j) {
                 _Y2[i*_dimSys+j]=0.;
-                    for(int k=0; k<_rstages;++k) {
-                        _Y2[i*_dimSys+j]+=_Y1[k*_dimSys+j]*_Theta[i*_rstages+k];
-                    }
+                for(int k=0; k<_rstages;++k) {
+                    _Y2[i*_dimSys+j]+=_Y1[k*_dimSys+j]*_Theta[i*_rstages+k];
                 }
- //               Y2.vector(i)=Y1*mtl::vector::trans(Theta[i][iall]);
             }
-            for(int i=0; i<_rstages; i++)
-            {
-                 for(int j=0; j<_dimSys; ++j) {
-                    _Y3[i*_dimSys+j]=0.;
-                    for(int k=0; k<_rstages;++k) {
-                        _Y3[i*_dimSys+j]+=_Y2[k*_dimSys+j]*_E[i*_rstages+k];
-                    }
+        }
+        for(int i=0; i<_rstages; i++)
+        {
+            for(int j=0; j<_dimSys; ++j) {
+                _Y3[i*_dimSys+j]=0.;
+                for(int k=0; k<_rstages;++k) {
+                    _Y3[i*_dimSys+j]+=_Y2[k*_dimSys+j]*_E[i*_rstages+k];
                 }
-//                Y3.vector(i)=Y2*mtl::vector::trans(E[i][iall]);
             }
+        }
+        std::copy(_Y1,_Y1+_dimSys*_rstages,_Ysave);
 
+        bool evalJacobian=newJacobian || !(count%_reuseJacobi);
+        bool singular=false;
 #pragma omp parallel for num_threads(_numThreads)
         for(int _rank=0; _rank<5; ++_rank) {
-            long int info;
-            evalF(t+_c[_rank]*_h,&_Y2[_rank*_dimSys],&_F[_rank*_dimSys],_continuous_system[_rank], _time_system[_rank]);
-            if(!(count%_reuseJacobi)) {
-               evalJ(t+_c[_rank]*_h,&_Y2[_rank*_dimSys],&_T[_rank*_dimSys*_dimSys], _continuous_system[_rank], _time_system[_rank]);
-                for(int i=0; i<_dimSys; ++i) {
-                    for(int j=0; j<_dimSys; ++j) {
-                        _T[_rank*_dimSys*_dimSys+i*_dimSys+j]*=-_h*_G[_rank];
-                    }
-                    _T[_rank*_dimSys*_dimSys+i*_dimSys+i]+=1.;
+            double ts=tNew+_c[_rank]*h;
+            double* F=&_F[_rank*_dimSys];
+            bool factorized=true;
+            evalF(ts,&_Y2[_rank*_dimSys],F,_continuous_system[_rank], _time_system[_rank]);
+            // the iteration matrix is refactorized for a new Jacobian or a new step size
+            if(evalJacobian || _hIter[_rank]!=h) {
+                if(evalJacobian) {
+                    if(_colored)
+                        evalJColored(ts,&_Y2[_rank*_dimSys],&_J[_rank*(_sparse ? _nonzeros : _dimSys*_dimSys)], _continuous_system[_rank], _time_system[_rank]);
+                    else
+                        evalJ(ts,&_Y2[_rank*_dimSys],&_J[_rank*_dimSys*_dimSys], _continuous_system[_rank], _time_system[_rank]);
                 }
-
-                dgetrf_(&_dimSys, &_dimSys, &_T[_rank*_dimSys*_dimSys], &_dimSys, &_P[_rank*_dimSys], &info);
+                factorized=factorizeStage(_rank,h);
             }
-
-
-    //        std::cerr << "Finished iteration matrix calculation step at rank  " << _rank<<std::endl;
-
-            for(int i=0; i<_dimSys; ++i) {
-                _F[_rank*_dimSys+i]*=_h;
-                _F[_rank*_dimSys+i]-=_Y3[_rank*_dimSys+i];
-                _F[_rank*_dimSys+i]*=_G[_rank];
+            if(!factorized) {
+#pragma omp critical
+                singular=true;
             }
-            dgetrs_(&trans, &_dimSys, &dim, &_T[_rank*_dimSys*_dimSys], &_dimSys, &_P[_rank*_dimSys], &_F[_rank*_dimSys], &_dimSys, &info);
-            for(int i=0; i<_dimSys; ++i) {
-                _Y1[_rank*_dimSys+i]=_F[_rank*_dimSys+i]+_Y2[_rank*_dimSys+i];
+            else {
+                for(int i=0; i<_dimSys; ++i) {
+                    F[i]=_G[_rank]*(h*F[i]-_Y3[_rank*_dimSys+i]);
+                }
+                solveStage(_rank,F);
+                for(int i=0; i<_dimSys; ++i) {
+                    _Y1[_rank*_dimSys+i]=F[i]+_Y2[_rank*_dimSys+i];
+                }
             }
         }
-
-        count++;
-        if(t+_h>_tEnd) _h=_tEnd-t;
-        _time_system[0]->setTime(t);
-        _continuous_system[0]->setContinuousStates(&_Y1[2*_dimSys]);
-
-        if(writeOutput) {
-            if(t>=twrite) {
-                _continuous_system[0]->evaluateAll(IContinuous::ALL);
-                SolverDefaultImplementation::writeToFile(0, t, _h);
-                twrite+=_hOut;
+        newJacobian=false;
+
+        // error estimate: difference of the new stages and their extrapolation from the old step
+        double err=0.;
+        if(singular)
+            err=std::numeric_limits<double>::quiet_NaN();
+        else {
+            for(int i=0; i<_dimSys*_rstages; ++i) {
+                double sc=atol+rtol*std::max(std::abs(_Y1[i]),std::abs(_Y2[i]));
+                err+=(_Y1[i]-_Y2[i])*(_Y1[i]-_Y2[i])/(sc*sc);
             }
+            err=std::sqrt(err/(_dimSys*_rstages));
         }
-        t+=_h;
-#endif
-
-    }
-#ifdef MPIPEER
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(_rank==0)
-    {
-        for(int i=0; i<_dimSys; i++) _y[i]=_Y1[(_rstages-1)*_dimSys+i];
+        // err is NaN for diverging stages or a singular iteration matrix
+        double fac=(err==err) ? std::min(2.,std::max(0.2,0.9*std::pow(std::max(err,1e-10),-0.2))) : 0.2;
+        if(!(err<=1.)) {
+            if(h<=_peersettings->getLowerLimit())
+                throw ModelicaSimulationError(SOLVER,"Peer: step at time " + to_string(tNew) + " failed with the minimal step size " + to_string(h)
+                    + (singular ? " (singular iteration matrix)" : ""));
+            // rejected: repeat the step from the old stages with a new Jacobian
+            std::copy(_Ysave,_Ysave+_dimSys*_rstages,_Y1);
+            _h=std::max(h*fac,_peersettings->getLowerLimit());
+            newJacobian=true;
+            _rejStps++;
+            continue;
+        }
+        _accStps++;
+        count++;
+        t=tNew;
+        hOld=h;
+        _h=std::max(std::min(h*fac,_peersettings->getUpperLimit()),_peersettings->getLowerLimit());
+        if(writeOutput)
+            writePeerOutput(t, hOld, count);
     }
-    MPI_Bcast(_y, _dimSys, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-#else
     for(int i=0; i<_dimSys; i++) _y[i]=_Y1[(_rstages-1)*_dimSys+i];
 #endif
     _tCurrent=_tEnd;
@@ -523,7 +697,7 @@ void Peer::solve(const SOLVERCALL action)
     _continuous_system[0]->setContinuousStates(&_Y1[4*_dimSys]);
     if(writeOutput) {
         _continuous_system[0]->evaluateAll(IContinuous::ALL);
-        SolverDefaultImplementation::writeToFile(0, t, _h);
+        SolverDefaultImplementation::writeToFile(0, _tCurrent, _h);
     }
     _solverStatus = ISolver::DONE;
 }
@@ -532,53 +706,29 @@ void Peer::solve(const SOLVERCALL action)
 
 void Peer::writePeerOutput(const double &time, const double &h, const int &stp)
 {
-  /*
-  if (stp > 0)
-  {
-    if (_cvodesettings->getDenseOutput())
+    // output points up to the last stage, interpolated by the polynomial through the stages
+    if(_hOut<=0.)
+        return;
+    const double eps=1e-10*std::max(1.,std::abs(_tEnd));
+    double tLast=time+h;
+    double w[5];
+    double* y=new double[_dimSys];
+    while(_tLastWrite+_hOut<=tLast+eps && _tLastWrite+_hOut<_tEnd-eps)
     {
-      _bWritten = false;
-      double *oldValues = NULL;
-
-      //We have to find all output-points within the last solver step
-      while (_tLastWrite + dynamic_cast<ISolverSettings*>(_cvodesettings)->getGlobalSettings()->gethOutput() <= time)
-      {
-        if (!_bWritten)
-        {
-          //Rescue the calculated derivatives
-          oldValues = new double[_continuous_system->getDimRHS()];
-          _continuous_system->getRHS(oldValues);
+        _tLastWrite+=_hOut;
+        if(_tLastWrite<=_tCurrent+eps)
+            continue;
+        lagrangeWeights((_tLastWrite-time)/h, w);
+        for(int j=0; j<_dimSys; ++j) {
+            y[j]=0.;
+            for(int k=0; k<_rstages; ++k) y[j]+=w[k]*_Y1[k*_dimSys+j];
         }
-        _bWritten = true;
-        _tLastWrite = _tLastWrite + dynamic_cast<ISolverSettings*>(_cvodesettings)->getGlobalSettings()->gethOutput();
-        //Get the state vars at the output-point (interpolated)
-        _idid = CVodeGetDky(_cvodeMem, _tLastWrite, 0, _CV_yWrite);
-        _time_system->setTime(_tLastWrite);
-        _continuous_system->setContinuousStates(NV_DATA_S(_CV_yWrite));
-        _continuous_system->evaluateAll(IContinuous::CONTINUOUS);
+        _time_system[0]->setTime(_tLastWrite);
+        _continuous_system[0]->setContinuousStates(y);
+        _continuous_system[0]->evaluateAll(IContinuous::ALL);
         SolverDefaultImplementation::writeToFile(stp, _tLastWrite, h);
-      }      //end if time -_tLastWritten
-      if (_bWritten)
-      {
-        _time_system->setTime(time);
-        _continuous_system->setContinuousStates(_z);
-        _continuous_system->setStateDerivatives(oldValues);
-        delete[] oldValues;
-        //_continuous_system->evaluateAll(IContinuous::CONTINUOUS);
-      }
-      else if (time == _tEnd && _tLastWrite != time)
-      {
-        _idid = CVodeGetDky(_cvodeMem, time, 0, _CV_y);
-        _time_system->setTime(time);
-        _continuous_system->setContinuousStates(NV_DATA_S(_CV_y));
-        _continuous_system->evaluateAll(IContinuous::CONTINUOUS);
-        SolverDefaultImplementation::writeToFile(stp, _tEnd, h);
-      }
     }
-    else
-      SolverDefaultImplementation::writeToFile(stp, time, h);
-  }
-  */
+    delete [] y;
 }
 
 bool Peer::stateSelection()
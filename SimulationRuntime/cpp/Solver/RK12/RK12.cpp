@@ -43,6 +43,8 @@ RK12::RK12(IMixedSystem* system, ISolverSettings* settings)
 	, _h_a			(0.0)
     , _f0               (NULL)
     , _f1               (NULL)
+    , _t0               (0.0)
+    , _t1               (0.0)
     ,_zeroTol            (1e-8)
     ,_outputStp(1)
     ,_tZero(-1)
@@ -341,7 +343,7 @@ void RK12::RK12Integration(bool *activeStates, double time, double *z0, double *
 
 
 void RK12::RK12InterpolateStates(bool *activeStates, double *leftIntervalStates, double *rightIntervalStates,double leftTime,double rightTime, double *interpolStates, double interpolTime){
-	for (int i; i<_dimSys;i++)
+	for (int i=0; i<_dimSys;i++)
 	{
 		if (activeStates[i] == false)
 			interpolStates[i] = ( (rightIntervalStates[i]-leftIntervalStates[i]) * (interpolTime-leftTime) / (rightTime-leftTime) ) +  leftIntervalStates[i];
@@ -397,7 +399,7 @@ void RK12::doRK12()
         //std::cout<<"START LATENT STEP ("<<_h<<") at "<<_tCurrent<<std::endl;
 
         // save old state vector for latent step
-        memcpy(_z0,_z,(int)_dimSys*sizeof(double));
+        startStep();
 
         //set partitions to active
 		_continuous_system->setPartitionActivation(allPartitionsActive);
@@ -504,9 +506,11 @@ void RK12::doRK12()
 					}
 
         ++ _totStps;
+        ++ _accStps;
 
         //write result to right interval boarder vector
         memcpy(_z1,_z,_dimSys*sizeof(double));
+        _t1 = tNext;
 
 
     	//printing
@@ -518,29 +522,7 @@ void RK12::doRK12()
         if (((_tEnd - _tCurrent) < dynamic_cast<ISolverSettings*>(_RK12Settings)->getEndTimeTol()))
             break;
 
-        if (_zeroStatus ==EQUAL_ZERO && _tZero > -1)   {
-
-        	// found zero crossing -> complete step
-            _firstStep            = true;
-            _hUpLim = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
-
-            //handle all events that occured at this t
-            //update_events_type update_event = boost::bind(&SolverDefaultImplementation::updateEventState, this);
-            _mixed_system->handleSystemEvents(_events/*,boost::ref(update_event)*/);
-            _event_system->getZeroFunc(_zeroVal);
-            _zeroStatus = EQUAL_ZERO;
-            memcpy(_zeroValLastSuccess,_zeroVal,_dimZeroFunc*sizeof(double));
-        }
-
-        if (_tZero > -1)        {
-            solverOutput(_accStps,_tZero,_z,_h);
-            _tCurrent = _tZero;
-            _tZero=-1;
-        }
-        else        {
-            //_tCurrent += _h;
-            _tCurrent = tNext;
-        }
+        handleZeroCrossing(tNext);
     }
 }
 
@@ -637,7 +619,7 @@ void RK12::doRK12_stepControl()
         //std::cout<<"START LATENT STEP ("<<_h<<") at "<<_tCurrent<<std::endl;
 
         // save old state vector for latent step
-        memcpy(_z0,_z,(int)_dimSys*sizeof(double));
+        startStep();
 
         //integrate with latent step size
         RK12Integration(allStatesActive, _tCurrent, _z0, _z, _h, delta_z, relTol, absTol, &numErrors);
@@ -668,6 +650,7 @@ void RK12::doRK12_stepControl()
 
 		//write result to right interval boarder vector
 		memcpy(_z1,_z,_dimSys*sizeof(double));
+		_t1 = tNext;
 
 
 		solverOutput(_accStps,tNext,_z,_h);
@@ -678,30 +661,7 @@ void RK12::doRK12_stepControl()
 		if (((_tEnd - _tCurrent) < dynamic_cast<ISolverSettings*>(_RK12Settings)->getEndTimeTol()))
 			break;
 
-		if (_zeroStatus ==EQUAL_ZERO && _tZero > -1)   {
-
-			// found zero crossing -> complete step
-			_firstStep            = true;
-			_hUpLim = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
-
-			//handle all events that occured at this t
-			//update_events_type update_event = boost::bind(&SolverDefaultImplementation::updateEventState, this);
-
-			_mixed_system->handleSystemEvents(_events/*,boost::ref(update_event)*/);
-			_event_system->getZeroFunc(_zeroVal);
-			_zeroStatus = EQUAL_ZERO;
-			memcpy(_zeroValLastSuccess,_zeroVal,_dimZeroFunc*sizeof(double));
-		}
-
-		if (_tZero > -1) {
-			solverOutput(_accStps,_tZero,_z,_h);
-			_tCurrent = _tZero;
-			_tZero=-1;
-		}
-		else {
-			//_tCurrent += _h;
-			_tCurrent = tNext;
-		}
+		handleZeroCrossing(tNext);
    }
 }
 
@@ -712,8 +672,8 @@ void RK12::giveZeroVal(const double &t,const double *y,double *zeroValue)
     _time_system->setTime(t);
     _continuous_system->setContinuousStates(y);
 
-    // System aktualisieren
-    _continuous_system->evaluateODE(IContinuous::ALL);  // vxworksupdate
+    // nur die Nullstellenfunktionen auswerten
+    _continuous_system->evaluateZeroFuncs(IContinuous::DISCRETE);
     _event_system->getZeroFunc(zeroValue);
 }
 
@@ -722,8 +682,8 @@ void RK12::giveZeroIdx(double *vL,double *vR,int *zeroIdx, int &zeroExist)
     zeroExist = 0;
     for (int i=0; i<_dimZeroFunc; i++)
     {
-        // Überprüfung auf Vorzeichenwechsel
-        if (vL[i] * vR[i] <= 0 && abs(vL[i]- vR[i])>UROUND)
+        // Überprüfung auf Vorzeichenwechsel (wie in SolverDefaultImplementation::setZeroState())
+        if ((vL[i] < 0 && vR[i] > 0) || (vL[i] > 0 && vR[i] < 0))
         {
             zeroIdx[i] = 1;
             zeroExist++;
@@ -738,307 +698,90 @@ void RK12::doMyZeroSearch()
 
     if (_zeroStatus == ZERO_CROSSING)
     {
-
+        // Illinois-Verfahren auf der Hermite-Interpolierenden des letzten Schritts [_t0,_t1].
+        // Das Intervall [tL,tR] enthält immer den ersten Vorzeichenwechsel, tR liegt hinter der Nullstelle.
         double
-            count = 0,
-            tL = _tCurrent,
-            tR = _tCurrent+_h,
-            tDelta,
+            tL = _t0,
+            tR = _t1,
             tTry,
-            tSwap,
-            maybe,
-            change,
-            lastMoved,
-            *yL,
-            *yR,
+            tEst,
+            scaleL = 1.0,                                // Illinois-Gewichte der Intervallgrenzen
+            scaleR = 1.0,
             *yTry,
-            *ySwap,
             *vL,
             *vR,
-            *vTry,
-            *vSwap,
-            *IllinoisV;
+            *vTry;
 
-        int  zeroExist,
-            leftZero,
+        int zeroExist,
+            lastMoved = 0,
             *zeroIdx;
-        bool notDone = true,
-            zeroBreak = false;
 
-        yL = new double[_dimSys];
-        yR = new double[_dimSys];
         yTry = new double[_dimSys];
-        ySwap = new double[_dimSys];
         vL = new double[_dimZeroFunc];
         vR = new double[_dimZeroFunc];
         vTry = new double[_dimZeroFunc];
-        vSwap = new double[_dimZeroFunc];
-        IllinoisV = new double[_dimZeroFunc];
         zeroIdx = new int[_dimZeroFunc];
 
-        // Initialisierung der benötigten Größen
-        //
-        //tL,tR: Zeit am linken/rechten Intervallrans
-        //yL,yR: Zustand am linken/rechten Intervallrand
-        //vL,vR: Nullstellenfunktion am ...
-        //
-
-        memcpy(yL,_z0,_dimSys*sizeof(double));
-        memcpy(yR,_z,_dimSys*sizeof(double));
         memcpy(vL,_zeroValLastSuccess,_dimZeroFunc*sizeof(double));
         memcpy(vR,_zeroVal,_dimZeroFunc*sizeof(double));
 
-
-        // DBG
-        //for (long int i=1;i<=_dimSys;i++)
-        //      yL[i-1] = CONTR5(&i,&tR,cont,lrc);
-
-        //
-
-
-        _tZero = -1;
-        tTry = tR;
-        while(true)
+        for (int iter = 0; iter < 100 && tR - tL > _zeroTol; iter++)
         {
-            lastMoved = 0;
+            giveZeroIdx(vL,vR,zeroIdx,zeroExist);
 
-            // Finde die Nullstelle
-            while(true)
+            // Regula Falsi, die am weitesten links liegende Nullstelle wird betrachtet
+            tEst = tR;
+            for (int i=0;i<_dimZeroFunc;i++)
             {
-                notDone = true;
-                giveZeroIdx(vL,vR,zeroIdx,zeroExist);
-                if ( zeroExist == 0)
-                    return;
-                //Ist das Zeitintervall noch groß genug ?
-                tDelta = tR - tL;
-
-                if (tDelta <= _zeroTol)
-                    notDone = false;
-
-                if (notDone==false)
-                    break;
+                if (zeroIdx[i] == 0)
+                    continue;
+                tEst = std::min(tEst, tL - scaleL*vL[i]*(tR-tL)/(scaleR*vR[i]-scaleL*vL[i]));
+            }
+            tTry = std::max(tL + 0.5*_zeroTol, std::min(tEst, tR - 0.5*_zeroTol));
 
-                leftZero = 0;
-                for (int i=0;i<_dimZeroFunc;i++)
-                    if ((zeroIdx[i] == 1) && ((abs(vL[i]) < UROUND) & (abs(vR[i]) >= UROUND)))
-                        leftZero = 1;
+            interp1(tTry,yTry);
+            giveZeroVal(tTry,yTry,vTry);
 
-                if((tL==_tCurrent) & leftZero)
-                    tTry = tL + 0.5*_zeroTol;
-                else
-                {
-                    // Regula Falsi
-                    change = 1;
-                    for (int i=0;i<_dimZeroFunc;i++)
-                    {
-                        if (zeroIdx[i] == 0)
-                            continue;
-                        // Falls vL oder vR Null ist, altes tTry verwenden
-                        if (abs(vL[i])<UROUND)
-                        {
-                            if (tTry>tR && vTry[i] != vR[i])
-                            {
-                                maybe = 1-vR[i]*(tTry-tR)/((vTry[i]-vR[i])*tDelta);
-                                if (maybe < 0 || maybe > 1)
-                                    maybe = 0.5;
-                            }
-                            else
-                            {
-                                maybe = 0.5;
-                            }
-
-                        }
-                        else
-                        {
-                            if (abs(vR[i] < UROUND))
-                            {
-                                if (tTry<tL && vTry[i] != vL[i])
-                                {
-                                    maybe = vL[i]*(tL-tTry)/((vTry[i]-vL[i])*tDelta);
-                                    if (maybe < 0 || maybe > 1)
-                                        maybe = 0.5;
-                                }
-                                else
-                                {
-                                    maybe = 0.5;
-                                }
-
-                            }
-                            else
-                            {
-                                maybe = -vL[i]/(vR[i]-vL[i]);
-                            }
-                        }
-                        // die Nullstelle die weitesten links liegt wird betrachtet
-                        if (maybe < change)
-                            change = maybe;
-                    } //end for
-
-                    change = change*abs(tDelta);
-                    change = std::max(0.5*_zeroTol,_zeroTol);
-
-                    tTry = tL + change;
-
-                }// end if tL== tOld
-
-                // vTry berechnen
-                interp1(tTry,yTry);
-                giveZeroVal(tTry,yTry,vTry);
-
-                // Nullstellendurchgänge zwischen tL und tTry
-                giveZeroIdx(vL,vTry,zeroIdx,zeroExist);
-                for(int i=0;i<_dimZeroFunc;i++)
-                    if(abs(vTry[i]) == 0.0 && !zeroExist)
-                    {
-
-                        //_kk << "Bad Loop" << endl <<  vTry[i] << endl << _dimZeroFunc <<endl;
-                        /*
-                        tR = tTry;
-                        for (long int j=1;j<=_dimSys;j++)
-                        yR[j-1] = CONTR5(&j,&tR,cont,lrc);
-                        giveZeroVal(tR,yR,vR);
-                        zeroBreak = true;
-                        //break;
-                        */
-                        while(true)
-                        {
-                            count++;
-                            tR = tTry + count*10*_zeroTol;
-                             interp1(tR,yR);
-                            giveZeroVal(tR,yR,vR);
-                            if(abs(vR[i]) > 0.0)
-                            {
-                                zeroBreak = true;
-                                break;
-                            }
-                        }
-
-                    }
-
-
-                    if (zeroBreak)
-                        break;
-
-                if (zeroExist)
-                {
-                    // rechte Intervallgrenze nach links schieben
-                    tSwap = tR;
-                    tR = tTry;
-                    tTry = tSwap;
-
-                    memcpy(ySwap,yR,_dimSys*sizeof(double));
-                    memcpy(yR,yTry,_dimSys*sizeof(double));
-                    memcpy(yTry,ySwap,_dimSys*sizeof(double));
-
-                    memcpy(vSwap,vR,_dimZeroFunc*sizeof(double));
-                    memcpy(vR,vTry,_dimZeroFunc*sizeof(double));
-                    memcpy(vTry,vSwap,_dimZeroFunc*sizeof(double));
-
-                    // falls zweimal in Folge nach links verschoben wurde, wird vL halbiert (nächstes mal wird weiter gerückt)
-                    if (lastMoved == 2)
-                    {
-                        for (int i=0;i<_dimZeroFunc;i++)
-                        {
-                            IllinoisV[i] = 0.5*vL[i];
-                            if (abs(IllinoisV[i]) >=UROUND)
-                                vL[i] = IllinoisV[i];
-                        }
-                    }
-                    lastMoved = 2;
-                }
-                else
-                {
-                    // linke Intervallgrenze nach rechts schieben
-                    tSwap = tL;
-                    tL = tTry;
-                    tTry = tSwap;
-
-                    memcpy(ySwap,yL,_dimSys*sizeof(double));
-                    memcpy(yL,yTry,_dimSys*sizeof(double));
-                    memcpy(yTry,ySwap,_dimSys*sizeof(double));
-
-                    memcpy(vSwap,vL,_dimZeroFunc*sizeof(double));
-                    memcpy(vL,vTry,_dimZeroFunc*sizeof(double));
-                    memcpy(vTry,vSwap,_dimZeroFunc*sizeof(double));
-
-                    // falls zweimal in Folge nach rechts verschoben wurde, wird vR halbiert (nächstes mal wird weiter gerückt)
-                    if (lastMoved == 1)
-                    {
-                        for (int i=0;i<_dimZeroFunc;i++)
-                        {
-                            IllinoisV[i] = 0.5*vR[i];
-                            if (abs(IllinoisV[i]) >=UROUND)
-                                vR[i] = IllinoisV[i];
-                        }
-                    }
-                    lastMoved = 1;
-                }// end for zeroExist
-            }// end while REGULA-FALSI
-
-            _tZero = tR;
-
-            if (_tInit != tL)
+            // Nullstellendurchgänge zwischen tL und tTry
+            giveZeroIdx(vL,vTry,zeroIdx,zeroExist);
+            if (zeroExist)
             {
-                memcpy(_zeroVal,vR,_dimZeroFunc*sizeof(double));
-                break;
+                // rechte Intervallgrenze nach links schieben
+                tR = tTry;
+                std::swap(vR,vTry);
+                scaleR = 1.0;
+                // falls zweimal in Folge nach links verschoben wurde, wird vL halbiert
+                if (lastMoved == 2)
+                    scaleL *= 0.5;
+                lastMoved = 2;
             }
             else
             {
-                memcpy(_zeroVal,vR,_dimZeroFunc*sizeof(double));
-                //tZero = -1;
-                break;
-            }
-            if (abs(_tCurrent+_h-tR) < _zeroTol)
-            {
-                memcpy(_zeroVal,vR,_dimZeroFunc*sizeof(double));
-                break;
-            }
-            else
-            { // betrachte [tR+0.5*tol tnew]
-                tTry = tR;
-                yTry = yR;
-                vTry = vR;
-                tL = tR + 0.5*_zeroTol;
-                interp1(tL,yL);
-                giveZeroVal(tL,yL,vL);
-                tR = _tCurrent+_h;
-                yR = _z;
-                memcpy(vR,_zeroVal,_dimZeroFunc*sizeof(double));
+                // linke Intervallgrenze nach rechts schieben, Nullstellen der Funktion bleiben beim alten Vorzeichen
+                tL = tTry;
+                for (int i=0;i<_dimZeroFunc;i++)
+                    if (vTry[i] != 0.0)
+                        vL[i] = vTry[i];
+                scaleL = 1.0;
+                // falls zweimal in Folge nach rechts verschoben wurde, wird vR halbiert
+                if (lastMoved == 1)
+                    scaleR *= 0.5;
+                lastMoved = 1;
             }
-
-
-        }//end while terminal
-
-        /*
-        for (int i=0;i<_dimZeroFunc;i++)
-        {
-        if (zeroIdx[i] ==0)
-        _zeroSign[i] = 0;
-        else
-        _zeroSign[i] = sgn(_zeroVal[i]-_zeroValLastSuccess[i]);
-        if ( abs(_zeroVal[i]) == 0 )
-        _zeroVal[i] = -sgn(_zeroValLastSuccess[i]) * UROUND;
         }
-        */
+
+        _tZero = tR;
         interp1(_tZero,_z);
         _tLastSuccess = tL;
         _tCurrent = _tZero;
-        setZeroState();
-
-        _time_system->setTime(_tCurrent);
-        _continuous_system->setContinuousStates(_z);
-        _continuous_system->evaluateODE(IContinuous::ALL);  // vxworksupdate
 
+        // Ausgabe bis zur Nullstelle (vor dem Event), setzt _zeroStatus und _events
+        solverOutput(_accStps,_tZero,_z,_h);
 
-        delete [] yL;
-        delete [] yR;
         delete [] yTry;
-        delete [] ySwap;
         delete [] vL;
         delete [] vR;
         delete [] vTry;
-        delete [] vSwap;
-        delete [] IllinoisV;
         delete [] zeroIdx;
 
     }// end if ZERO_STATE
@@ -1050,6 +793,42 @@ void RK12::doMyZeroSearch()
     }
 }
 
+void RK12::handleZeroCrossing(const double& tNext)
+{
+    if (_zeroStatus == EQUAL_ZERO && _tZero > -1)    // Nullstelle gefunden
+    {
+        // Originale maximale Schrittweite wiederherstellen
+        _hUpLim = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
+
+        //handle all events that occured at this t
+        _mixed_system->handleSystemEvents(_events);
+        _event_system->getZeroFunc(_zeroVal);
+        memcpy(_zeroValLastSuccess,_zeroVal,_dimZeroFunc*sizeof(double));
+
+        // Neustart (Zustand vom System lesen) nur, wenn das Event Zustände reinitialisiert hat
+        _continuous_system->getContinuousStates(_zWrite);
+        _firstStep = memcmp(_zWrite,_z,_dimSys*sizeof(double)) != 0;
+    }
+
+    if (_tZero > -1)
+    {
+        solverOutput(_accStps,_tZero,_z,_h);
+        _tCurrent = _tZero;
+        _tZero=-1;
+    }
+    else
+    {
+        _tCurrent = tNext;
+    }
+}
+
+void RK12::startStep()
+{
+    _t0 = _tCurrent;
+    memcpy(_z0,_z,_dimSys*sizeof(double));
+    memcpy(_f0,_f1,_dimSys*sizeof(double));
+}
+
 void RK12::calcFunction(const double& t, const double* z, double* f)
 {
 
@@ -1109,11 +888,23 @@ void RK12::solverOutput(const int& stp, const double& t, double* z, const double
 
             // Determine the sign and hence the status of zero crossings
             SolverDefaultImplementation::setZeroState();
+
+            // Vorzeichenwechsel innerhalb des Schritts: Nullstelle wird vor der Ausgabe in doMyZeroSearch() gesucht
+            if (_zeroStatus == EQUAL_ZERO && t > _tCurrent)
+                _zeroStatus = ZERO_CROSSING;
+            // Werte am linken Rand für die nächste Nullstellensuche, Nullstellen behalten das alte Vorzeichen
+            else if (_zeroStatus == UNCHANGED_SIGN)
+                for (int i=0;i<_dimZeroFunc;i++)
+                    if (_zeroVal[i] != 0.0)
+                        _zeroValLastSuccess[i] = _zeroVal[i];
         }
         if (abs(t-_tEnd) <= dynamic_cast<ISolverSettings*>(_RK12Settings)->getEndTimeTol())
             _zeroStatus = UNCHANGED_SIGN;
     }
 
+    // Right hand side at (t,z) for the next step and the interpolation of the dense output below
+    _continuous_system->getRHS(_f1);
+
 
     if (_zeroStatus == UNCHANGED_SIGN || _zeroStatus == EQUAL_ZERO)
     {
@@ -1186,15 +977,23 @@ void RK12::solverOutput(const int& stp, const double& t, double* z, const double
 void RK12::interp1(double time, double *value)
 {
 
-    double t = (time-_tCurrent)/_h;
+    double h = _t1 - _t0;
+    if (h <= 0.0)
+    {
+        memcpy(value,_z1,_dimSys*sizeof(double));
+        return;
+    }
+
+    // Hermite-Basisfunktionen in Horner-Form
+    double t = (time-_t0)/h;
 
-    _h00 = 2*pow(t,3)-3*pow(t,2)+1;
-    _h10= pow(t,3)-2*pow(t,2)+t;
-    _h01 = -2*pow(t,3)+3*pow(t,2);
-    _h11 = pow(t,3)-pow(t,2);
+    _h01 = t*t*(3.0-2.0*t);
+    _h00 = 1.0-_h01;
+    _h10 = h*t*(t-1.0)*(t-1.0);
+    _h11 = h*t*t*(t-1.0);
 
     for (int i=0;i<_dimSys;i++)
-        value[i] = _h00*_z0[i] + _h10*_h*_f0[i]  + _h01*_z1[i] + _h11*_h*_f1[i];
+        value[i] = _h00*_z0[i] + _h10*_f0[i]  + _h01*_z1[i] + _h11*_f1[i];
 }
 
 
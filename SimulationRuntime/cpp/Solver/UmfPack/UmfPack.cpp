@@ -5,13 +5,12 @@
 
 #ifdef USE_UMFPACK
 #include "umfpack.h"
-#include <Core/Utils/numeric/bindings/umfpack/umfpack.hpp>
 #include <Core/Utils/numeric/bindings/ublas/vector.hpp>
 #include <Core/Utils/numeric/bindings/ublas.hpp>
 #include <boost/numeric/ublas/io.hpp>
-namespace umf = boost::numeric::bindings::umfpack;
 #endif
 UmfPack::UmfPack(ILinearAlgLoop* algLoop, ILinSolverSettings* settings) : _iterationStatus(CONTINUE), _umfpackSettings(settings), _algLoop(algLoop), _rhs(NULL), _x(NULL), _firstuse(true), _jacd(NULL)
+, _umfSymbolic(NULL), _Ap(NULL), _Ai(NULL), _nonzeros(-1)
 {
 }
 
@@ -20,6 +19,11 @@ UmfPack::~UmfPack()
     if(_jacd)   delete [] _jacd;
     if(_rhs)     delete []  _rhs;
     if(_x)      delete [] _x;
+    if(_Ap)     delete [] _Ap;
+    if(_Ai)     delete [] _Ai;
+#ifdef USE_UMFPACK
+    if(_umfSymbolic) umfpack_di_free_symbolic(&_umfSymbolic);
+#endif
 }
 
 void UmfPack::initialize()
@@ -70,36 +74,55 @@ void UmfPack::solve()
     {
 
 
-         int status;
-        // get the default control parameters
-		umf::control_type<> Control;
-		// change the default print level
-		Control [UMFPACK_PRL] = 6;
+        int status;
+        void* numeric = NULL;
 
-		 _algLoop->evaluate();
+        _algLoop->evaluate();
         _algLoop->getRHS(_rhs);
-         long int dimSys = _algLoop->getDimReal();
+        int dimSys = _algLoop->getDimReal();
         const sparsematrix_t& A = _algLoop->getSystemSparseMatrix();
-
-        adaptor_t rhs_adaptor(dimSys,_rhs);
-		shared_vector_t b(dimSys,rhs_adaptor);
-
-        adaptor_t x_adaptor(dimSys,_x);
-		shared_vector_t x(dimSys,x_adaptor);
-
-
-        umf::symbolic_type<double> Symbolic;
-        umf::numeric_type<double> Numeric;
-		status = umf::symbolic(A, Symbolic);
+        int nonzeros = A.nnz();
+        int const* Ap = boost::numeric::bindings::begin_compressed_index_major(A);
+        int const* Ai = boost::numeric::bindings::begin_index_minor(A);
+        double const* Ax = boost::numeric::bindings::begin_value(A);
+
+        //the symbolic analysis is only repeated if the sparsity pattern has changed
+        if (_umfSymbolic == NULL || nonzeros != _nonzeros
+            || memcmp(_Ap, Ap, sizeof(int)*(dimSys + 1)) != 0
+            || memcmp(_Ai, Ai, sizeof(int)*nonzeros) != 0)
+        {
+            if(_umfSymbolic)
+                umfpack_di_free_symbolic(&_umfSymbolic);
+            if(!_Ap)
+                _Ap = new int[dimSys + 1];
+            if(nonzeros != _nonzeros)
+            {
+                if(_Ai)
+                    delete [] _Ai;
+                _Ai = new int[nonzeros];
+            }
+            _nonzeros = nonzeros;
+            memcpy(_Ap, Ap, sizeof(int)*(dimSys + 1));
+            memcpy(_Ai, Ai, sizeof(int)*nonzeros);
+
+            status = umfpack_di_symbolic(dimSys, dimSys, _Ap, _Ai, Ax, &_umfSymbolic, NULL, NULL);
+            if(status<0)
+            {
+                _umfSymbolic = NULL;
+                throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack symbolic function");
+            }
+        }
+
+        status = umfpack_di_numeric(_Ap, _Ai, Ax, _umfSymbolic, &numeric, NULL, NULL);
+        if(status<0)
+        {
+            umfpack_di_free_numeric(&numeric);
+            throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack numeric function");
+        }
+        status = umfpack_di_solve(UMFPACK_A, _Ap, _Ai, Ax, _x, _rhs, numeric, NULL, NULL);
+        umfpack_di_free_numeric(&numeric);
         if(status<0)
-			//umf::report_status (Control, status)
-			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack symbolic function");
-		status = umf::numeric (A, Symbolic, Numeric);
-		if(status<0)
-			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack numeric function");
-        status = umf::solve (A, x, b, Numeric);
-		if(status<0)
-			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack solve function");
+            throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack solve function");
         _algLoop->setReal(_x);
 
 